@@ -0,0 +1,1012 @@
+﻿// Purpose: 性能基准测试
+// Author:  Cmixed
+#pragma once
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include "pch.hpp"
+#include "data.hpp"
+#include "file_io.hpp"
+#include "landmark.hpp"
+#include "ch.hpp"
+#include "hub_label.hpp"
+#include "annealing.hpp"
+#include "genetic.hpp"
+#include "check.hpp"
+
+namespace route::bench
+{
+	using check::make_geometric_graph;
+
+	/*****************************************************************
+	 *
+	 *		基准测试工具
+	 *
+	 *****************************************************************/
+
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief 测量 fn 执行 rounds 次的平均耗时（纳秒）。
+	 */
+	template <typename Fn>
+	inline double measure_ns(int const rounds, Fn&& fn)
+	{
+		auto const start = Clock::now();
+		for (int i = 0; i < rounds; ++i) {
+			fn();
+		}
+		auto const end = Clock::now();
+		return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+	}
+
+	/**
+	 * @brief 打印一行基准结果。
+	 */
+	inline void print_result(std::string_view const name, double const baseline_ns, double const optimized_ns)
+	{
+		std::println("[Bench] {:<28} 基线: {:>12.1f} ns  优化: {:>12.1f} ns  加速比: {:.2f}x",
+		             name, baseline_ns, optimized_ns, baseline_ns / optimized_ns);
+	}
+
+
+	/*****************************************************************
+	 *
+	 *		基准测试
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 比较 vector<vector> 邻接矩阵与连续对齐矩阵上的路径距离计算。
+	 *
+	 * 在 n 个城市的完全图上随机生成 population 条路径，
+	 * 分别通过两种布局累加路径长度，模拟 GA / SA 中的适应度评估；
+	 * 连续矩阵一侧经 withEdgeWeights 取得访问器，循环内不再判断存储方式。
+	 */
+	inline void bench_dense_matrix(int const n = 50, int const population = 100, int const rounds = 2000)
+	{
+		std::mt19937 rng(42);
+		std::uniform_int_distribution<int> weight_dist(1, 1000);
+
+		WGraph graph(n);
+		std::vector<std::vector<int>> nested(n, std::vector<int>(n, -1));
+		for (int i = 0; i < n; ++i) {
+			for (int j = i + 1; j < n; ++j) {
+				int const w = weight_dist(rng);
+				graph.addEdge(i, j, w);
+				nested[i][j] = nested[j][i] = w;
+			}
+		}
+
+		std::vector<std::vector<int>> paths = initialize_population(0, n - 1, n, population);
+
+		long long sink = 0;
+		double const nested_ns = measure_ns(rounds, [&]
+		{
+			for (const auto& path : paths) {
+				sink += calculate_path_distance(path, [&](int const a, int const b) { return nested[a][b]; });
+			}
+		});
+		double const dense_ns = graph.withEdgeWeights([&](auto const weight_of)
+		{
+			return measure_ns(rounds, [&]
+			{
+				for (const auto& path : paths) {
+					sink += calculate_path_distance(path, weight_of);
+				}
+			});
+		});
+
+		print_result(std::format("dense matrix (n={})", n), nested_ns, dense_ns);
+		if (sink == 0) {
+			std::println("[Bench] unexpected checksum");
+		}
+	}
+
+	/**
+	 * @brief 在几何网格图上比较 dijkstra 与 aStar 的出队顶点数与耗时，两者结果一致由 check::check_astar_geometric 检查。
+	 */
+	inline void bench_astar(int const side = 300, int const queries = 20)
+	{
+		WGraph const graph = make_geometric_graph(side);
+		std::mt19937 rng(3);
+		std::uniform_int_distribution<int> corner(0, side / 5);
+
+		// 远距离查询：起点位于左上角区域，终点位于右下角区域
+		std::vector<std::pair<int, int>> pairs;
+		for (int q = 0; q < queries; ++q) {
+			int const s = corner(rng) * side + corner(rng);
+			int const t = (side - 1 - corner(rng)) * side + (side - 1 - corner(rng));
+			pairs.emplace_back(s, t);
+		}
+
+		SearchStats dijkstra_stats{}, astar_stats{};
+		long long sink = 0;
+		double const dijkstra_ns = measure_ns(1, [&]
+		{
+			for (auto const& [s, t] : pairs) {
+				sink += graph.dijkstra(s, t, &dijkstra_stats).second;
+			}
+		});
+		double const astar_ns = measure_ns(1, [&]
+		{
+			for (auto const& [s, t] : pairs) {
+				sink += graph.aStar(s, t, &astar_stats).second;
+			}
+		});
+
+		print_result(std::format("A* ({} vertices)", side * side), dijkstra_ns, astar_ns);
+		std::println("[Bench] {:<28} 基线: {:>12} 个  优化: {:>12} 个  比例: {:.3f}",
+		             "settled vertices", dijkstra_stats.settled, astar_stats.settled,
+		             static_cast<double>(astar_stats.settled) / static_cast<double>(dijkstra_stats.settled));
+		if (sink == 0) {
+			std::println("[Bench] unexpected checksum");
+		}
+	}
+
+	/**
+	 * @brief 在几何网格图上比较 aStar 与 ALT（16 个最远点地标）的出队顶点数与耗时。
+	 */
+	inline void bench_alt(int const side = 300, int const queries = 50)
+	{
+		WGraph const graph = make_geometric_graph(side);
+		int const n = graph.vertexCount();
+		std::mt19937 rng(7);
+		std::uniform_int_distribution<int> vertex_dist(0, n - 1);
+		std::vector<std::pair<int, int>> pairs;
+		for (int q = 0; q < queries; ++q) {
+			pairs.emplace_back(vertex_dist(rng), vertex_dist(rng));
+		}
+
+		WLandmarkIndex index;
+		double const build_ns = measure_ns(1, [&] { index = WLandmarkIndex::build(graph, 16); });
+
+		SearchStats astar_stats{}, alt_stats{};
+		long long mismatches = 0;
+		double const astar_ns = measure_ns(1, [&]
+		{
+			for (auto const& [s, t] : pairs) {
+				mismatches += graph.aStar(s, t, &astar_stats).second;
+			}
+		});
+		double const alt_ns = measure_ns(1, [&]
+		{
+			for (auto const& [s, t] : pairs) {
+				mismatches -= index.query(graph, s, t, &alt_stats).second;
+			}
+		});
+
+		print_result(std::format("ALT ({} vertices)", n), astar_ns, alt_ns);
+		std::println("[Bench] {:<28} 基线: {:>12} 个  优化: {:>12} 个  比例: {:.3f}",
+		             "settled vertices", astar_stats.settled, alt_stats.settled,
+		             static_cast<double>(alt_stats.settled) / static_cast<double>(astar_stats.settled));
+		std::println("[Bench] {:<28} {:.1f} ms", "landmark preprocessing", build_ns / 1e6);
+		if (mismatches != 0 || alt_stats.fallback) {
+			std::println("[Bench] ALT result mismatch");
+		}
+	}
+
+	/**
+	 * @brief 比较 dijkstra 与收缩层次的随机查询耗时，并报告预处理耗时与捷径数。
+	 */
+	inline void bench_ch(int const side = 60, int const queries = 200)
+	{
+		WGraph const graph = make_geometric_graph(side);
+		int const n = graph.vertexCount();
+		std::mt19937 rng(11);
+		std::uniform_int_distribution<int> vertex_dist(0, n - 1);
+		std::vector<std::pair<int, int>> pairs;
+		for (int q = 0; q < queries; ++q) {
+			pairs.emplace_back(vertex_dist(rng), vertex_dist(rng));
+		}
+
+		WContractionHierarchy hierarchy;
+		double const build_ns = measure_ns(1, [&] { hierarchy = WContractionHierarchy::build(graph); });
+
+		SearchStats dijkstra_stats{}, ch_stats{};
+		long long mismatches = 0;
+		double const dijkstra_ns = measure_ns(1, [&]
+		{
+			for (auto const& [s, t] : pairs) {
+				mismatches += graph.dijkstra(s, t, &dijkstra_stats).second;
+			}
+		});
+		double const ch_ns = measure_ns(1, [&]
+		{
+			for (auto const& [s, t] : pairs) {
+				mismatches -= hierarchy.query(s, t, &ch_stats).second;
+			}
+		});
+
+		print_result(std::format("CH ({} vertices)", n), dijkstra_ns, ch_ns);
+		std::println("[Bench] {:<28} 基线: {:>12} 个  优化: {:>12} 个  比例: {:.3f}",
+		             "settled vertices", dijkstra_stats.settled, ch_stats.settled,
+		             static_cast<double>(ch_stats.settled) / static_cast<double>(dijkstra_stats.settled));
+		std::println("[Bench] {:<28} {:.1f} ms, {} 条捷径", "CH preprocessing", build_ns / 1e6,
+		             hierarchy.shortcutCount());
+		if (mismatches != 0) {
+			std::println("[Bench] CH result mismatch");
+		}
+	}
+
+	/**
+	 * @brief 比较收缩层次与枢纽标签（按收缩顺序构建）的随机查询耗时，分别测量只求距离与还原路径。
+	 */
+	inline void bench_hub_labels(int const side = 60, int const queries = 20000)
+	{
+		WGraph graph = make_geometric_graph(side);
+		int const n = graph.vertexCount();
+		std::mt19937 rng(13);
+		std::uniform_int_distribution<int> vertex_dist(0, n - 1);
+		std::vector<std::pair<int, int>> pairs;
+		for (int q = 0; q < queries; ++q) {
+			pairs.emplace_back(vertex_dist(rng), vertex_dist(rng));
+		}
+
+		graph.prepareContractionHierarchy();
+		double const build_ns = measure_ns(1, [&] { graph.prepareHubLabels(); });
+		WHubLabelIndex const& labels = *graph.hubLabels();
+
+		long long mismatches = 0;
+		double const ch_ns = measure_ns(1, [&]
+		{
+			for (auto const& [s, t] : pairs) {
+				mismatches += graph.contractionHierarchyQuery(s, t).second;
+			}
+		});
+		double const distance_ns = measure_ns(1, [&]
+		{
+			for (auto const& [s, t] : pairs) {
+				mismatches -= labels.distance(s, t);
+			}
+		});
+		double const path_ns = measure_ns(1, [&]
+		{
+			for (auto const& [s, t] : pairs) {
+				mismatches += labels.query(s, t).second;
+			}
+		});
+		mismatches -= std::transform_reduce(pairs.begin(), pairs.end(), 0LL, std::plus<>{}, [&](auto const& pair)
+		{
+			return static_cast<long long>(labels.distance(pair.first, pair.second));
+		});
+
+		print_result(std::format("hub label distance ({} vertices)", n), ch_ns, distance_ns);
+		std::println("[Bench] {:<28} {:.1f} ns/查询（含还原路径）", "hub label path", path_ns / queries);
+		std::println("[Bench] {:<28} {:.1f} ms, 平均每顶点 {:.1f} 项", "hub label preprocessing", build_ns / 1e6,
+		             static_cast<double>(labels.entryCount()) / n);
+		if (mismatches != 0) {
+			std::println("[Bench] hub label result mismatch");
+		}
+	}
+
+	/**
+	 * @brief 同一起点、多个终点：比较逐个调用 dijkstra 与构建一次最短路径树后逐个读取路径的耗时。
+	 */
+	inline void bench_shortest_path_tree(int const side = 150, int const targets = 50)
+	{
+		WGraph const graph = make_geometric_graph(side);
+		int const n = graph.vertexCount();
+		std::mt19937 rng(19);
+		std::uniform_int_distribution<int> vertex_dist(0, n - 1);
+		int const source = vertex_dist(rng);
+		std::vector<int> ends(targets);
+		std::ranges::generate(ends, [&] { return vertex_dist(rng); });
+
+		long long mismatches = 0;
+		double const dijkstra_ns = measure_ns(1, [&]
+		{
+			for (int const t : ends) {
+				mismatches += graph.dijkstra(source, t).second;
+			}
+		});
+		double const tree_ns = measure_ns(1, [&]
+		{
+			auto const tree = graph.shortestPathTree(source);
+			for (int const t : ends) {
+				mismatches -= tree.query(t).second;
+			}
+		});
+
+		print_result(std::format("shortest path tree (1x{})", targets), dijkstra_ns, tree_ns);
+		if (mismatches != 0) {
+			std::println("[Bench] shortest path tree result mismatch");
+		}
+	}
+
+	/**
+	 * @brief 模拟退火：比较逐次复制候选路径、两次交换求差的旧写法与 PathAnnealer 的原地评估。
+	 *
+	 * 两者在同一个 n 个顶点的完全图上从同一条初始路径出发，只使用交换操作，降温方式与迭代次数相同，
+	 * 同时输出各自最终的路径长度。
+	 */
+	inline void bench_annealing(int const n = 1000, int const iterations = 1000000)
+	{
+		std::mt19937 rng(21);
+		std::uniform_int_distribution<int> weight_dist(1, 1000);
+		WGraph graph(n);
+		for (int i = 0; i < n; ++i) {
+			for (int j = i + 1; j < n; ++j) {
+				graph.addEdge(i, j, weight_dist(rng));
+			}
+		}
+
+		WGraph::Distance legacy_distance = 0;
+		double const legacy_ns = measure_ns(1, [&]
+		{
+			std::vector<int> path(n);
+			std::iota(path.begin(), path.end(), 0);
+			std::uniform_int_distribution<int> dist(1, n - 2);
+			double temperature = 1000.0;
+			for (int iter = 0; iter < iterations; ++iter) {
+				int const pos1 = dist(rng);
+				int pos2 = dist(rng);
+				while (pos1 == pos2) pos2 = dist(rng);
+				auto const around = [&](std::vector<int> const& p)
+				{
+					return graph.edgeWeight(p[pos1 - 1], p[pos1]) + graph.edgeWeight(p[pos1], p[pos1 + 1])
+						+ graph.edgeWeight(p[pos2 - 1], p[pos2]) + graph.edgeWeight(p[pos2], p[pos2 + 1]);
+				};
+				std::vector<int> candidate = path;
+				std::swap(candidate[pos1], candidate[pos2]);
+				auto const before = around(candidate);
+				std::swap(candidate[pos1], candidate[pos2]);
+				auto const after = around(candidate);
+				std::swap(candidate[pos1], candidate[pos2]);
+				auto const delta = before - after;
+				if (delta < 0 || std::uniform_real_distribution<double>(0.0, 1.0)(rng) < std::exp(-delta / temperature)) {
+					path = std::move(candidate);
+				}
+				temperature = std::max(temperature * 0.995, 1e-3);
+			}
+			legacy_distance = calculate_path_distance(path, [&](int const a, int const b) { return graph.edgeWeight(a, b); });
+		});
+
+		WGraph::Distance distance = 0;
+		double const annealing_ns = measure_ns(1, [&]
+		{
+			std::vector<int> path(n);
+			std::iota(path.begin(), path.end(), 0);
+			AnnealingConfig config;
+			config.reverse_weight = 0.0;
+			config.insert_weight = 0.0;
+			auto const cost = [&graph](int const a, int const b) -> std::int64_t { return graph.edgeWeight(a, b); };
+			annealing::PathAnnealer annealer(std::move(path), cost, true, config);
+			std::mt19937_64 engine(21);
+			double temperature = 1000.0;
+			for (int iter = 0; iter < iterations; ++iter) {
+				annealer.step(temperature, engine);
+				temperature = std::max(temperature * 0.995, 1e-3);
+			}
+			distance = annealer.cost();
+		});
+
+		print_result(std::format("annealing ({} iterations)", iterations), legacy_ns, annealing_ns);
+		std::println("[Bench] {:<28} 旧写法: {}  原地评估: {}", "annealing distance", legacy_distance, distance);
+	}
+
+	/**
+	 * @brief 岛屿模型：有效种群相同（islands × population）时，比较单个大种群与多个岛屿的耗时和路径长度。
+	 *
+	 * 岛屿数取硬件线程数（至少 4）。选择算子每次调用都要遍历种群，单个大种群每代的代价随种群大小平方增长。
+	 */
+	inline void bench_island_genetic(int const n = 50, int const population = 100, int const generations = 50)
+	{
+		std::mt19937 rng(23);
+		std::uniform_int_distribution<int> weight_dist(1, 1000);
+		WGraph graph(n);
+		for (int i = 0; i < n; ++i) {
+			for (int j = i + 1; j < n; ++j) {
+				graph.addEdge(i, j, weight_dist(rng));
+			}
+		}
+		int const islands = static_cast<int>(std::max(4u, std::thread::hardware_concurrency()));
+
+		IslandConfig config;
+		config.generations = generations;
+		config.seed = 23;
+		config.islands = 1;
+		config.population_size = islands * population;
+		WGraph::Distance single_distance = 0;
+		double const single_ns = measure_ns(1, [&] { single_distance = graph.islandGeneticAlgorithm(0, n - 1, config).second; });
+
+		config.islands = islands;
+		config.population_size = population;
+		WGraph::Distance island_distance = 0;
+		double const island_ns = measure_ns(1, [&] { island_distance = graph.islandGeneticAlgorithm(0, n - 1, config).second; });
+
+		print_result(std::format("island GA ({} x {})", islands, population), single_ns, island_ns);
+		std::println("[Bench] {:<28} 单种群: {}  岛屿模型: {}", "island GA distance", single_distance, island_distance);
+	}
+
+	/**
+	 * @brief 遗传算法的种群布局：比较旧的 vector<vector> 种群与连续存储的 genetic::Population。
+	 *
+	 * 旧写法每代新建种群、每条路径单独分配，选择算子每次调用都重新评估整个种群，交叉在子代中线性查找；
+	 * Island 在两个预先分配的种群之间交替，选择使用缓存的距离。两者参数与初始种群相同。
+	 */
+	inline void bench_population(int const n = 50, int const population = 100, int const generations = 200)
+	{
+		using Path = std::vector<int>;
+		std::mt19937 rng(24);
+		std::uniform_int_distribution<int> weight_dist(1, 1000);
+		WGraph graph(n);
+		for (int i = 0; i < n; ++i) {
+			for (int j = i + 1; j < n; ++j) {
+				graph.addEdge(i, j, weight_dist(rng));
+			}
+		}
+		auto const weight_of = [&graph](int const a, int const b) { return graph.edgeWeight(a, b); };
+		IslandConfig config;
+		config.population_size = population;
+
+		WGraph::Distance legacy_distance = std::numeric_limits<WGraph::Distance>::max();
+		double const legacy_ns = measure_ns(1, [&]
+		{
+			std::mt19937 legacy_rng(24);
+			std::vector<Path> paths = initialize_population(0, n - 1, n, population, legacy_rng);
+			auto const legacy_select = [&]() -> Path
+			{
+				std::vector<double> fitness;
+				for (const auto& path : paths) {
+					fitness.push_back(is_valid_path(path, weight_of)
+						                  ? 1.0 / (calculate_path_distance(path, weight_of) + 1) : 0.0);
+				}
+				double const target = std::uniform_real_distribution<double>(
+					0.0, std::accumulate(fitness.begin(), fitness.end(), 0.0))(legacy_rng);
+				double cumulative = 0.0;
+				for (size_t i = 0; i < paths.size(); ++i) {
+					cumulative += fitness[i];
+					if (cumulative >= target) {
+						return paths[i];
+					}
+				}
+				return paths.back();
+			};
+			for (int g = 0; g < generations; ++g) {
+				std::vector<std::pair<WGraph::Distance, Path const*>> elites;
+				for (const auto& path : paths) {
+					WGraph::Distance const distance = calculate_path_distance(path, weight_of);
+					legacy_distance = std::min(legacy_distance, distance);
+					elites.emplace_back(distance, &path);
+				}
+				std::ranges::sort(elites, {}, &std::pair<WGraph::Distance, Path const*>::first);
+				std::vector<Path> next;
+				for (int i = 0; i < config.elite_size; ++i) {
+					next.push_back(*elites[i].second);
+				}
+				while (next.size() < paths.size()) {
+					Path const parent1 = legacy_select();
+					Path const parent2 = legacy_select();
+					Path child = parent1;
+					if (std::uniform_real_distribution<>(0.0, 1.0)(legacy_rng) < config.crossover_rate) {
+						std::uniform_int_distribution<int> dist(0, n - 1);
+						int first = dist(legacy_rng), last = dist(legacy_rng);
+						if (first > last) {
+							std::swap(first, last);
+						}
+						std::ranges::fill(child, -1);
+						std::copy(parent1.begin() + first, parent1.begin() + last + 1, child.begin() + first);
+						int insert = 0;
+						for (int const city : parent2) {
+							insert = insert == first ? last + 1 : insert;
+							if (insert < n && std::ranges::find(child, city) == child.end()) {
+								child[insert++] = city;
+							}
+						}
+					}
+					if (std::uniform_real_distribution<>(0.0, 1.0)(legacy_rng) < config.mutation_rate) {
+						mutate(std::span(child), legacy_rng);
+					}
+					next.push_back(std::move(child));
+				}
+				paths = std::move(next);
+			}
+		});
+
+		WGraph::Distance distance = 0;
+		double const flat_ns = measure_ns(1, [&]
+		{
+			genetic::Island<int, decltype(weight_of)> island(0, n - 1, n, config, weight_of, 24);
+			for (int g = 0; g < generations; ++g) {
+				island.evolve();
+			}
+			distance = island.bestDistance();
+		});
+
+		print_result(std::format("GA population ({} x {})", population, generations), legacy_ns, flat_ns);
+		std::println("[Bench] {:<28} 旧写法: {}  连续种群: {}", "GA population distance", legacy_distance, distance);
+	}
+
+	/**
+	 * @brief 选择算子：比较每次选择都线性扫描种群的轮盘赌与别名表轮盘赌，并给出三种算子下遗传算法的耗时与路径长度。
+	 *
+	 * 选择部分模拟一代的 2P 次选择，距离取自一个随机初始种群；遗传算法部分使用相同的种子与参数。
+	 */
+	inline void bench_selection(int const n = 50, int const population = 1000, int const generations = 100)
+	{
+		using Distance = WGraph::Distance;
+		std::mt19937 rng(25);
+		std::uniform_int_distribution<int> weight_dist(1, 1000);
+		WGraph graph(n);
+		for (int i = 0; i < n; ++i) {
+			for (int j = i + 1; j < n; ++j) {
+				graph.addEdge(i, j, weight_dist(rng));
+			}
+		}
+		std::vector<Distance> distances;
+		for (auto const& path : initialize_population(0, n - 1, n, population, rng)) {
+			distances.push_back(calculate_path_distance(path, [&](int const a, int const b) { return graph.edgeWeight(a, b); }));
+		}
+
+		long long sink = 0;
+		double const linear_ns = measure_ns(20, [&]
+		{
+			for (int k = 0; k < 2 * population; ++k) {
+				double total = 0.0;
+				for (Distance const d : distances) {
+					total += 1.0 / (d + 1);
+				}
+				double const target = std::uniform_real_distribution<double>(0.0, total)(rng);
+				double cumulative = 0.0;
+				int chosen = population - 1;
+				for (int i = 0; i < population; ++i) {
+					cumulative += 1.0 / (distances[i] + 1);
+					if (cumulative >= target) {
+						chosen = i;
+						break;
+					}
+				}
+				sink += chosen;
+			}
+		});
+		genetic::Selector<Distance> alias(SelectionMethod::Roulette, 0, population);
+		double const alias_ns = measure_ns(20, [&]
+		{
+			alias.prepare(distances, 2 * population, rng);
+			for (int k = 0; k < 2 * population; ++k) {
+				sink += alias.next(rng);
+			}
+		});
+		print_result(std::format("roulette selection (P={})", population), linear_ns, alias_ns);
+
+		for (auto const& [method, name] : {std::pair{SelectionMethod::Roulette, "roulette"},
+		                                   {SelectionMethod::Tournament, "tournament"},
+		                                   {SelectionMethod::Universal, "universal"}}) {
+			IslandConfig config;
+			config.population_size = 100;
+			config.generations = generations;
+			config.selection = method;
+			config.seed = 25;
+			Distance distance = 0;
+			double const ns = measure_ns(1, [&] { distance = graph.geneticAlgorithm(0, n - 1, config).second; });
+			std::println("[Bench] {:<28} 耗时: {:>12.1f} ns  距离: {}", std::format("GA {} selection", name), ns, distance);
+		}
+		if (sink == 0) {
+			std::println("[Bench] unexpected checksum");
+		}
+	}
+
+	/**
+	 * @brief 并行回火：在相同的总迭代次数下比较单链模拟退火与 K 个副本的并行回火的耗时和路径长度。
+	 *
+	 * 单链执行 replicas × iterations 次迭代，并行回火每个副本执行 iterations 次，副本数取硬件线程数（至少 4）。
+	 */
+	inline void bench_parallel_tempering(int const n = 300, std::int64_t const iterations = 200000)
+	{
+		std::mt19937 rng(22);
+		std::uniform_int_distribution<int> weight_dist(1, 1000);
+		WGraph graph(n);
+		for (int i = 0; i < n; ++i) {
+			for (int j = i + 1; j < n; ++j) {
+				graph.addEdge(i, j, weight_dist(rng));
+			}
+		}
+		int const replicas = static_cast<int>(std::max(4u, std::thread::hardware_concurrency()));
+
+		AnnealingConfig single;
+		single.iterations = replicas * iterations;
+		single.cooling_rate = std::pow(single.min_temperature / single.initial_temperature, 1.0 / single.iterations);
+		single.seed = 22;
+		WGraph::Distance single_distance = 0;
+		double const single_ns = measure_ns(1, [&] { single_distance = graph.localSearchOptimization(0, n - 1, single).second; });
+
+		TemperingConfig config;
+		config.replicas = replicas;
+		config.iterations = iterations;
+		config.moves.seed = 22;
+		TemperingResult<> result;
+		double const tempering_ns = measure_ns(1, [&] { result = graph.parallelTempering(0, n - 1, config); });
+
+		print_result(std::format("parallel tempering ({} replicas)", replicas), single_ns, tempering_ns);
+		std::println("[Bench] {:<28} 单链: {}  并行回火: {}", "tempering distance", single_distance, result.best.second);
+		for (auto const& replica : result.replicas) {
+			std::println("[Bench]   T = {:>8.2f}  接受率 {:.3f}  交换成功率 {:.3f}  代价 {}", replica.temperature,
+			             static_cast<double>(replica.accepted) / std::max<std::int64_t>(1, replica.proposed),
+			             static_cast<double>(replica.exchanges_accepted)
+			             / std::max<std::int64_t>(1, replica.exchanges_attempted), replica.cost);
+		}
+	}
+
+	/**
+	 * @brief 全源最短路径：在 n 个顶点的完全图上比较每个起点各做一次 shortestPathTree 与分块 Floyd–Warshall（allPairs）。
+	 */
+	inline void bench_all_pairs(int const n = 1000)
+	{
+		std::mt19937 rng(20);
+		std::uniform_int_distribution<int> weight_dist(1, 1000);
+		WGraph graph(n);
+		for (int i = 0; i < n; ++i) {
+			for (int j = i + 1; j < n; ++j) {
+				graph.addEdge(i, j, weight_dist(rng));
+			}
+		}
+
+		long long mismatches = 0;
+		double const dijkstra_ns = measure_ns(1, [&]
+		{
+			for (int s = 0; s < n; ++s) {
+				mismatches += graph.shortestPathTree(s).distance(n - 1 - s);
+			}
+		});
+		double const matrix_ns = measure_ns(1, [&]
+		{
+			auto const matrix = graph.allPairs();
+			for (int s = 0; s < n; ++s) {
+				mismatches -= matrix.distance(s, n - 1 - s);
+			}
+		});
+
+		print_result(std::format("all pairs ({} vertices)", n), dijkstra_ns, matrix_ns);
+		if (mismatches != 0) {
+			std::println("[Bench] all pairs result mismatch");
+		}
+	}
+
+	/**
+	 * @brief 完整单源最短路径：比较 shortestPathTree（顺序 Dijkstra）与 1 ~ N 个线程的 deltaStepping。
+	 *
+	 * 默认规模约 100 万顶点。
+	 */
+	inline void bench_delta_stepping(int const side = 1000)
+	{
+		WGraph const graph = make_geometric_graph(side);
+		int const source = side / 2 * side + side / 2;
+
+		WGraph::Distance checksum = 0;
+		double const dijkstra_ns = measure_ns(1, [&] { checksum = graph.shortestPathTree(source).distance(0); });
+		unsigned const hardware = std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned threads = 1;; threads = std::min(threads * 2, hardware)) {
+			WGraph::Distance distance = 0;
+			double const delta_ns = measure_ns(1, [&] { distance = graph.deltaStepping(source, threads).distance(0); });
+			print_result(std::format("delta-stepping ({} threads)", threads), dijkstra_ns, delta_ns);
+			if (distance != checksum) {
+				std::println("[Bench] delta-stepping result mismatch");
+			}
+			if (threads == hardware) {
+				break;
+			}
+		}
+		std::println("[Bench] {:<28} {} vertices, delta = {}", "delta-stepping graph", graph.vertexCount(),
+		             delta_stepping::choose_delta(graph));
+	}
+
+	/**
+	 * @brief 比较逐对 dijkstra 与 distanceTable（单线程与全部硬件线程）计算多对多距离表的耗时。
+	 */
+	inline void bench_distance_table(int const side = 150, int const count = 16)
+	{
+		WGraph const graph = make_geometric_graph(side);
+		int const n = graph.vertexCount();
+		std::mt19937 rng(17);
+		std::uniform_int_distribution<int> vertex_dist(0, n - 1);
+		std::vector<int> sources(count), targets(count);
+		std::ranges::generate(sources, [&] { return vertex_dist(rng); });
+		std::ranges::generate(targets, [&] { return vertex_dist(rng); });
+
+		std::vector<WGraph::Distance> pairwise;
+		pairwise.reserve(static_cast<std::size_t>(count) * count);
+		double const pairwise_ns = measure_ns(1, [&]
+		{
+			for (int const s : sources) {
+				for (int const t : targets) {
+					pairwise.push_back(graph.dijkstra(s, t).second);
+				}
+			}
+		});
+		DistanceTable<WGraph::Distance> single, parallel;
+		double const single_ns = measure_ns(1, [&] { single = graph.distanceTable(sources, targets, 1); });
+		double const parallel_ns = measure_ns(1, [&] { parallel = graph.distanceTable(sources, targets); });
+
+		print_result(std::format("distance table {}x{} ({} vertices)", count, count, n), pairwise_ns, single_ns);
+		print_result(std::format("parallel table ({} threads)", std::thread::hardware_concurrency()), pairwise_ns,
+		             parallel_ns);
+
+		// 逐格与单对 dijkstra 比较
+		std::size_t mismatches = 0;
+		for (std::size_t i = 0; i < pairwise.size(); ++i) {
+			mismatches += single.values[i] != pairwise[i];
+			mismatches += parallel.values[i] != pairwise[i];
+		}
+		if (mismatches != 0) {
+			std::println("[Bench] distance table mismatch in {} cells", mismatches);
+		}
+	}
+
+	/**
+	 * @brief 比较惰性 std::priority_queue 与索引 4 叉堆 Dijkstra 的队列操作次数和耗时。
+	 *
+	 * 基线为改造前的实现：每次改进都入队一个新元素，弹出过期元素后仍会重新松弛整行。
+	 */
+	inline void bench_heap(int const side = 200, int const queries = 50)
+	{
+		WGraph const graph = make_geometric_graph(side);
+		int const n = graph.vertexCount();
+		std::mt19937 rng(5);
+		std::uniform_int_distribution<int> vertex_dist(0, n - 1);
+		std::vector<std::pair<int, int>> pairs;
+		for (int q = 0; q < queries; ++q) {
+			pairs.emplace_back(vertex_dist(rng), vertex_dist(rng));
+		}
+
+		std::size_t lazy_operations = 0;
+		long long checksum = 0;
+		double const lazy_ns = measure_ns(1, [&]
+		{
+			for (auto const& [s, t] : pairs) {
+				std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> pq;
+				std::vector<int> dist(n, std::numeric_limits<int>::max());
+				dist[s] = 0;
+				pq.emplace(0, s);
+				++lazy_operations;
+				while (!pq.empty()) {
+					int const u = pq.top().second;
+					pq.pop();
+					++lazy_operations;
+					if (u == t) {
+						break;
+					}
+					graph.forEachNeighbor(u, [&](int const v, int const weight)
+					{
+						if (dist[v] > dist[u] + weight) {
+							dist[v] = dist[u] + weight;
+							pq.emplace(dist[v], v);
+							++lazy_operations;
+						}
+					});
+				}
+				checksum += dist[t];
+			}
+		});
+
+		SearchStats stats{};
+		double const indexed_ns = measure_ns(1, [&]
+		{
+			for (auto const& [s, t] : pairs) {
+				checksum -= graph.dijkstra(s, t, &stats).second;
+			}
+		});
+
+		print_result(std::format("indexed 4-ary heap ({} vertices)", n), lazy_ns, indexed_ns);
+		std::println("[Bench] {:<28} 基线: {:>12.1f} 次  优化: {:>12.1f} 次  比例: {:.3f}",
+		             "queue ops per query", static_cast<double>(lazy_operations) / queries,
+		             static_cast<double>(stats.queue_operations) / queries,
+		             static_cast<double>(stats.queue_operations) / static_cast<double>(lazy_operations));
+		if (checksum != 0) {
+			std::println("[Bench] heap result mismatch");
+		}
+	}
+
+	/**
+	 * @brief 比较索引 4 叉堆、基数堆与 Dial 桶队列下 dijkstra 的耗时，边权约为 40 ~ 240 的整数。
+	 */
+	inline void bench_queues(int const side = 300, int const queries = 30)
+	{
+		WGraph const graph = make_geometric_graph(side);
+		int const n = graph.vertexCount();
+		std::mt19937 rng(9);
+		std::uniform_int_distribution<int> vertex_dist(0, n - 1);
+		std::vector<std::pair<int, int>> pairs;
+		for (int q = 0; q < queries; ++q) {
+			pairs.emplace_back(vertex_dist(rng), vertex_dist(rng));
+		}
+
+		// 每种队列先预热一轮，让线程工作区分配好容量，再计时 3 轮
+		std::array<long long, 3> checksum{};
+		auto const run = [&]<typename QueuePolicy>(long long& sum)
+		{
+			auto const round = [&]
+			{
+				sum = 0;
+				for (auto const& [s, t] : pairs) {
+					sum += graph.template dijkstra<QueuePolicy>(s, t).second;
+				}
+			};
+			round();
+			return measure_ns(3, round);
+		};
+		double const heap_ns = run.template operator()<IndexedHeapQueue>(checksum[0]);
+		double const radix_ns = run.template operator()<RadixHeapQueue>(checksum[1]);
+		double const dial_ns = run.template operator()<DialQueue>(checksum[2]);
+
+		print_result(std::format("radix heap ({} vertices)", n), heap_ns, radix_ns);
+		print_result(std::format("Dial buckets ({} vertices)", n), heap_ns, dial_ns);
+		if (checksum[1] != checksum[0] || checksum[2] != checksum[0]) {
+			std::println("[Bench] queue result mismatch");
+		}
+	}
+
+	/**
+	 * @brief 生成包含 vertices 个顶点与 edges 条随机边的图文本。
+	 */
+	inline auto make_graph_text(int const vertices, int const edges, std::uint32_t const seed = 42) -> std::string
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> vertex_dist(0, vertices - 1);
+		std::uniform_int_distribution<int> coord_dist(0, 1000);
+		std::uniform_int_distribution<int> weight_dist(1, 1000);
+
+		std::string text = "# 基准测试图\n\n# [VERTEX] LISTS\n";
+		for (int i = 0; i < vertices; ++i) {
+			std::format_to(std::back_inserter(text), "[Vertex] C{} {} {} {} 0\n", i, i, coord_dist(rng), coord_dist(rng));
+		}
+		text += "\n# [EDGE] LISTS\n";
+		for (int e = 0; e < edges; ++e) {
+			std::format_to(std::back_inserter(text), "[Edge] {} {} {}\n", vertex_dist(rng), vertex_dist(rng), weight_dist(rng));
+		}
+		return text;
+	}
+
+	/**
+	 * @brief 比较旧的 getline + istringstream + stoi 解析与 parse_graph_text 的吞吐量。
+	 *
+	 * 两种方式都只统计解析出的顶点与边，不构建图，以单独衡量分词与数值转换的开销。
+	 */
+	inline void bench_parser(int const vertices = 20000, int const edges = 200000, int const rounds = 3)
+	{
+		std::string const text = make_graph_text(vertices, edges);
+		auto const lines = static_cast<double>(std::ranges::count(text, '\n'));
+
+		long long sink = 0;
+		double const legacy_ns = measure_ns(rounds, [&]
+		{
+			std::istringstream input(text);
+			std::string line;
+			while (std::getline(input, line)) {
+				if (line.empty() || line[0] == '#') {
+					continue;
+				}
+				std::istringstream iss(line);
+				std::vector<std::string> tokens;
+				std::string token;
+				while (iss >> token) {
+					tokens.push_back(token);
+				}
+				if (tokens.empty()) {
+					continue;
+				}
+				if (tokens[0] == "[Vertex]" && tokens.size() >= 5) {
+					sink += std::stoi(tokens[2]) + std::stoi(tokens[3]) + std::stoi(tokens[4]);
+				}
+				else if (tokens[0] == "[Edge]" && tokens.size() >= 4) {
+					sink += std::stoi(tokens[1]) + std::stoi(tokens[2]) + std::stoi(tokens[3]);
+				}
+			}
+		});
+		double const fast_ns = measure_ns(rounds, [&]
+		{
+			parse_graph_text(text,
+				[&](std::string_view, std::int64_t const id, std::int64_t const x, std::int64_t const y, Attribute)
+				{
+					sink += id + x + y;
+				},
+				[&](std::int64_t const src, std::int64_t const dest, std::int64_t const weight)
+				{
+					sink += src + dest + weight;
+				},
+				[](std::size_t, ParseError, std::string_view) {});
+		});
+
+		print_result(std::format("parser ({} lines)", static_cast<long long>(lines)), legacy_ns, fast_ns);
+		std::println("[Bench] {:<28} 基线: {:>9.2f} M 行/秒  优化: {:>9.2f} M 行/秒",
+		             "parser throughput", lines / legacy_ns * 1e3, lines / fast_ns * 1e3);
+		if (sink == 0) {
+			std::println("[Bench] unexpected checksum");
+		}
+	}
+
+	/**
+	 * @brief 比较 read_from_file 与 read_from_file_parallel 从文件构建 Csr 图的耗时，并检查两者结果一致。
+	 */
+	inline void bench_parallel_load(int const vertices = 200000, int const edges = 4000000, int const rounds = 2)
+	{
+		std::string const filename = "bench_graph.txt";
+		{
+			std::ofstream file(filename, std::ios::binary);
+			std::string const text = make_graph_text(vertices, edges);
+			file.write(text.data(), static_cast<std::streamsize>(text.size()));
+		}
+
+		std::optional<WGraph> sequential, parallel;
+		double const sequential_ns = measure_ns(rounds, [&]
+		{
+			sequential.emplace(vertices, Storage::Csr);
+			read_from_file(*sequential, filename);
+		});
+		double const parallel_ns = measure_ns(rounds, [&]
+		{
+			parallel.emplace(vertices, Storage::Csr);
+			read_from_file_parallel(*parallel, filename);
+		});
+		std::remove(filename.c_str());
+
+		print_result(std::format("parallel load ({} edges)", edges), sequential_ns, parallel_ns);
+
+		std::mt19937 rng(7);
+		std::uniform_int_distribution<int> vertex_dist(0, vertices - 1);
+		for (int i = 0; i < 100000; ++i) {
+			int const a = vertex_dist(rng), b = vertex_dist(rng);
+			if (sequential->getWeight(a, b) != parallel->getWeight(a, b)) {
+				std::println("[Bench] parallel load mismatch at ({}, {})", a, b);
+				return;
+			}
+		}
+		for (int v = 0; v < vertices; v += vertices / 16) {
+			if (sequential->getVertex(v)->m_name != parallel->getVertex(v)->m_name) {
+				std::println("[Bench] parallel load mismatch at vertex {}", v);
+				return;
+			}
+		}
+	}
+
+	/**
+	 * @brief 比较逐行 std::println 与 write_to_file 的缓冲批量写出。
+	 */
+	inline void bench_writer(int const vertices = 200000, int const edges = 2000000, int const rounds = 2)
+	{
+		WGraph graph(vertices, Storage::Csr);
+		parse_graph_text(make_graph_text(vertices, edges),
+			[&](std::string_view const name, std::int64_t const id, std::int64_t const x, std::int64_t const y,
+			    Attribute const attr)
+			{
+				graph.addVertex(name, static_cast<IntType>(id), {static_cast<IntType>(x), static_cast<IntType>(y)}, attr);
+			},
+			[&](std::int64_t const src, std::int64_t const dest, std::int64_t const weight)
+			{
+				graph.addEdge(static_cast<int>(src), static_cast<int>(dest), static_cast<int>(weight));
+			},
+			[](std::size_t, ParseError, std::string_view) {});
+		graph.finalize();
+
+		std::string const filename = "bench_output.txt";
+		double const println_ns = measure_ns(rounds, [&]
+		{
+			std::ofstream file(filename);
+			std::println(file, "# 支持 “#” 号 行注释\n\n# [VERTEX] LISTS");
+			for (int id = 0; id < vertices; ++id) {
+				if (auto const vertex = graph.getVertex(id)) {
+					std::println(file, "[Vertex] {} {} {} {} {}", vertex->m_name, id,
+						vertex->m_location.first, vertex->m_location.second, static_cast<int>(vertex->m_attr));
+				}
+			}
+			std::println(file, "\n# [EDGE] LISTS");
+			for (int i = 0; i < vertices; ++i) {
+				graph.forEachNeighbor(i, [&](int const j, int const weight)
+				{
+					if (j > i) {
+						std::println(file, "[Edge] {} {} {}", i, j, weight);
+					}
+				});
+			}
+		});
+		double const buffered_ns = measure_ns(rounds, [&] { write_to_file(graph, filename); });
+		double const parallel_ns = measure_ns(rounds, [&] { write_to_file(graph, filename, 0); });
+		std::remove(filename.c_str());
+
+		print_result(std::format("writer ({} edges)", edges), println_ns, buffered_ns);
+		print_result(std::format("parallel writer ({} edges)", edges), println_ns, parallel_ns);
+	}
+}
+
+#endif
@@ -0,0 +1,1209 @@
+﻿// Purpose: 正确性检查
+// Author:  Cmixed
+#pragma once
+
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include "pch.hpp"
+#include "data.hpp"
+#include "file_io.hpp"
+#include "landmark.hpp"
+#include "ch.hpp"
+#include "hub_label.hpp"
+#include "annealing.hpp"
+#include "genetic.hpp"
+
+namespace route::check
+{
+	/*****************************************************************
+	 *
+	 *		检查工具
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 打印一行检查结果。
+	 * @return true 如果没有失败
+	 */
+	inline bool report(std::string_view const name, std::size_t const cases, std::size_t const failures)
+	{
+		std::println("[Check] {:<40} {:>6} 例  {}", name, cases,
+		             failures == 0 ? std::string("通过") : std::format("失败 {} 例", failures));
+		return failures == 0;
+	}
+
+	/**
+	 * @brief 检查 path 是否从 start 到 end、每一步都有边且权重之和等于 distance。
+	 */
+	template <typename Graph>
+	inline bool is_consistent_path(Graph const& graph, typename Graph::PathResult const& result,
+	                               int const start, int const end)
+	{
+		auto const& [path, distance] = result;
+		if (distance < 0) {
+			return path.empty();
+		}
+		if (path.empty() || path.front() != start || path.back() != end) {
+			return false;
+		}
+		typename Graph::Distance sum = 0;
+		for (std::size_t i = 0; i + 1 < path.size(); ++i) {
+			auto const weight = graph.edgeWeight(path[i], path[i + 1]);
+			if (weight < 0) {
+				return false;
+			}
+			sum += weight;
+		}
+		return sum == distance;
+	}
+
+	/**
+	 * @brief 生成带随机坐标的随机图，directed 为真时使用有向弧。
+	 */
+	inline auto make_random_graph(int const vertices, int const edges, Storage const storage, bool const directed,
+	                              std::uint32_t const seed) -> WGraph
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> vertex_dist(0, vertices - 1);
+		std::uniform_int_distribution<int> coord_dist(0, 1000);
+		std::uniform_int_distribution<int> weight_dist(1, 100);
+
+		WGraph graph(vertices, storage);
+		for (int i = 0; i < vertices; ++i) {
+			graph.addVertex(std::format("R{}", i), i, {coord_dist(rng), coord_dist(rng)});
+		}
+		for (int e = 0; e < edges; ++e) {
+			int const a = vertex_dist(rng), b = vertex_dist(rng);
+			if (a == b) {
+				continue;
+			}
+			if (directed) {
+				graph.addArc(a, b, weight_dist(rng));
+			} else {
+				graph.addEdge(a, b, weight_dist(rng));
+			}
+		}
+		graph.finalize();
+		return graph;
+	}
+
+	/**
+	 * @brief 生成 side × side 的带扰动网格图（含对角边），边权为端点欧氏距离乘以 [1, 1.3) 的随机系数。
+	 */
+	inline auto make_geometric_graph(int const side, std::uint32_t const seed = 42) -> WGraph
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> jitter(-30, 30);
+		std::uniform_real_distribution<double> stretch(1.0, 1.3);
+
+		WGraph graph(side * side, Storage::Csr);
+		std::vector<std::pair<int, int>> location(static_cast<std::size_t>(side) * side);
+		for (int r = 0; r < side; ++r) {
+			for (int c = 0; c < side; ++c) {
+				int const id = r * side + c;
+				location[id] = {c * 100 + jitter(rng), r * 100 + jitter(rng)};
+				graph.addVertex(std::format("G{}", id), id, location[id]);
+			}
+		}
+		auto const connect = [&](int const a, int const b)
+		{
+			double const dx = location[a].first - location[b].first;
+			double const dy = location[a].second - location[b].second;
+			graph.addEdge(a, b, static_cast<int>(std::ceil(std::hypot(dx, dy) * stretch(rng))));
+		};
+		for (int r = 0; r < side; ++r) {
+			for (int c = 0; c < side; ++c) {
+				int const id = r * side + c;
+				if (c + 1 < side) {
+					connect(id, id + 1);
+				}
+				if (r + 1 < side) {
+					connect(id, id + side);
+				}
+				if (r + 1 < side && c + 1 < side) {
+					connect(id, id + side + 1);
+					connect(id + 1, id + side);
+				}
+			}
+		}
+		graph.finalize();
+		return graph;
+	}
+
+	/**
+	 * @brief 把 text 原样写入文件。
+	 */
+	inline void write_text(std::string const& filename, std::string_view const text)
+	{
+		std::ofstream file(filename, std::ios::binary);
+		file.write(text.data(), static_cast<std::streamsize>(text.size()));
+	}
+
+	/**
+	 * @brief 读取文件中的 [Vertex] 行与 [Edge] 行并排序，文件无法打开时返回空。
+	 */
+	inline auto record_lines(std::string const& filename) -> std::vector<std::string>
+	{
+		std::vector<std::string> lines;
+		std::ifstream file(filename, std::ios::binary);
+		for (std::string line; std::getline(file, line); ) {
+			if (line.starts_with("[Vertex]") || line.starts_with("[Edge]")) {
+				lines.push_back(std::move(line));
+			}
+		}
+		std::ranges::sort(lines);
+		return lines;
+	}
+
+	/**
+	 * @brief 调用 fn，返回其间写入标准错误流的内容。
+	 */
+	template <typename Fn>
+	inline auto capture_stderr(Fn&& fn) -> std::string
+	{
+		std::ostringstream captured;
+		std::streambuf* const previous = std::cerr.rdbuf(captured.rdbuf());
+		fn();
+		std::cerr.rdbuf(previous);
+		return captured.str();
+	}
+
+
+	/*****************************************************************
+	 *
+	 *		检查
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 检查超出类型范围的数值：顶点编号超出 V、权重超出 W 的行连同行号报告并被跳过，
+	 * read_from_file 与 read_from_file_parallel 的报告相同，load_graph 把越界的权重计入错误。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_value_ranges()
+	{
+		std::string const filename = "check_value_ranges.txt";
+		write_text(filename, "[Vertex] A 0 0 0\n"
+		                     "[Vertex] B 1 10 0\n"
+		                     "[Vertex] C 2 20 0\n"
+		                     "[Vertex] D 4294967296 30 0\n"
+		                     "[Edge] 0 1 5\n"
+		                     "[Edge] 1 2 3000000000\n"
+		                     "[Edge] 0 4294967298 1\n");
+
+		std::size_t failures = 0;
+		WGraph sequential(3), parallel(3);
+		std::string const errors = capture_stderr([&] { read_from_file(sequential, filename); });
+		failures += errors != capture_stderr([&] { read_from_file_parallel(parallel, filename); });
+		failures += std::ranges::count(errors, '\n') != 3 || !errors.contains("第 4 行")
+			|| !errors.contains("第 6 行") || !errors.contains("第 7 行");
+		failures += sequential.getWeight(0, 1) != 5 || sequential.getWeight(1, 2) != -1
+			|| parallel.getWeight(0, 1) != 5 || parallel.getWeight(1, 2) != -1;
+
+		std::optional<LoadedGraph<int, int>> loaded;
+		std::string const load_errors = capture_stderr([&] { loaded = load_graph(filename); });
+		failures += !loaded.has_value() || loaded->stats.errors != 1 || !load_errors.contains("第 6 行")
+			|| loaded->graph.vertexCount() != 5 || loaded->graph.getWeight(1, 2) != -1;
+
+		std::remove(filename.c_str());
+		return report("超出类型范围的数值", 5, failures);
+	}
+
+	/**
+	 * @brief 检查解析错误的报告：字段不足、非整数（含带小数的坐标）的行按行号与错误类型报告并被跳过，
+	 * first_line 使行号整体偏移；坐标超出 int32 的顶点由 read_from_file 报告而不是截断。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_parse_errors()
+	{
+		std::string_view const text = "# 注释\n"
+		                              "[Vertex] A 0 0 0\n"
+		                              "[Vertex] B 1\n"
+		                              "[Vertex] C 2 1.5 0\n"
+		                              "[Edge] 0 1\n"
+		                              "[Edge] 0 x1 3\r\n"
+		                              "[Vertex] D 3 3000000000 0\n"
+		                              "[Edge] 0 1 4";
+		using Error = std::pair<std::size_t, ParseError>;
+		std::vector<Error> const expected{
+			{3, ParseError::VertexFormat}, {4, ParseError::Number}, {5, ParseError::EdgeFormat}, {6, ParseError::Number}
+		};
+
+		std::size_t failures = 0;
+		for (std::size_t const first_line : {std::size_t{1}, std::size_t{101}}) {
+			std::vector<Error> errors;
+			std::size_t vertices = 0, edges = 0;
+			ParseStats const stats = parse_graph_text(text,
+				[&](std::string_view, std::int64_t, std::int64_t, std::int64_t, Attribute) { ++vertices; },
+				[&](std::int64_t, std::int64_t, std::int64_t) { ++edges; },
+				[&](std::size_t const line, ParseError const error, std::string_view)
+				{
+					errors.emplace_back(line, error);
+				},
+				first_line);
+			for (auto& error : errors) {
+				error.first -= first_line - 1;
+			}
+			failures += errors != expected || stats.lines != 8 || stats.vertices != 2 || stats.edges != 1
+				|| stats.errors != 4 || vertices != 2 || edges != 1;
+		}
+
+		std::string const filename = "check_parse_errors.txt";
+		write_text(filename, text);
+		WGraph graph(4);
+		std::string const output = capture_stderr([&] { read_from_file(graph, filename); });
+		std::remove(filename.c_str());
+		failures += std::ranges::count(output, '\n') != 5 || !output.contains("第 4 行")
+			|| !output.contains("第 7 行") || !output.contains("数值超出范围");
+		failures += !graph.vertices().contains(0) || graph.vertices().contains(2) || graph.vertices().contains(3)
+			|| graph.getWeight(0, 1) != 4;
+		return report("解析错误", 4, failures);
+	}
+
+	/**
+	 * @brief 检查 write_to_file：Matrix / Csr 图在 1 个与多个线程下的输出都与原先逐行 std::println 的写法逐字节相同。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_writer(int const vertices = 300, int const edges = 1500)
+	{
+		std::string const filename = "check_writer.txt";
+		bool passed = true;
+		for (Storage const storage : {Storage::Matrix, Storage::Csr}) {
+			WGraph graph = make_random_graph(vertices, edges, storage, false, 8);
+
+			// 原先的写法：每条记录一次 std::println
+			std::string expected = "# 支持 “#” 号 行注释\n\n# [VERTEX] LISTS\n";
+			for (int id = 0; id < vertices; ++id) {
+				if (auto const vertex = graph.getVertex(id)) {
+					std::format_to(std::back_inserter(expected), "[Vertex] {} {} {} {} {}\n", vertex->m_name, id,
+					               vertex->m_location.first, vertex->m_location.second, static_cast<int>(vertex->m_attr));
+				}
+			}
+			expected += "\n# [EDGE] LISTS\n";
+			for (int i = 0; i < vertices; ++i) {
+				graph.forEachNeighbor(i, [&](int const j, int const weight)
+				{
+					if (j > i) {
+						std::format_to(std::back_inserter(expected), "[Edge] {} {} {}\n", i, j, weight);
+					}
+				});
+			}
+
+			std::size_t failures = 0;
+			for (unsigned const threads : {1u, 3u, 0u}) {
+				failures += !write_to_file(graph, filename, threads) || read_file_buffer(filename) != expected;
+			}
+			passed &= report(std::format("write_to_file ({})", storage == Storage::Matrix ? "Matrix" : "Csr"), 3,
+			                 failures);
+		}
+		std::remove(filename.c_str());
+		return passed;
+	}
+
+	/**
+	 * @brief 检查不连续的顶点编号：load_graph 按连续编号建图并保存映射，write_to_file 写回原来的编号，
+	 * 写出的文件再次读入后得到相同的图。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_vertex_ids()
+	{
+		std::string const input = "check_vertex_ids.txt";
+		std::string const output = "check_vertex_ids_out.txt";
+		write_text(input, "[Vertex] A 10 1 2 0\n"
+		                  "[Vertex] B 200 3 4 1\n"
+		                  "[Vertex] C 35 5 6 0\n"
+		                  "[Edge] 10 200 7\n"
+		                  "[Edge] 200 35 8\n"
+		                  "[Edge] 1000 35 9\n");
+		std::vector<std::string> const expected{
+			"[Edge] 10 200 7", "[Edge] 35 1000 9", "[Edge] 35 200 8",
+			"[Vertex] A 10 1 2 0", "[Vertex] B 200 3 4 1", "[Vertex] C 35 5 6 0"
+		};
+
+		std::size_t failures = 0;
+		auto const loaded = load_graph(input);
+		if (!loaded.has_value()) {
+			++failures;
+		} else {
+			WGraph const& graph = loaded->graph;
+			int const a = loaded->ids.dense(10), far = loaded->ids.dense(1000);
+			failures += graph.vertexCount() != 4 || graph.externalId(a) != 10 || graph.externalId(far) != 1000;
+			failures += graph.dijkstra(a, far).second != 24;
+
+			WGraph copy = graph;
+			failures += !write_to_file(copy, output) || record_lines(output) != expected;
+			auto const reloaded = load_graph(output);
+			failures += !reloaded.has_value() || reloaded->ids.original != loaded->ids.original
+				|| reloaded->graph.dijkstra(a, far) != graph.dijkstra(a, far);
+		}
+		std::remove(input.c_str());
+		std::remove(output.c_str());
+		return report("不连续的顶点编号", 5, failures);
+	}
+
+	/**
+	 * @brief 检查二进制快照：Matrix / Csr、无向 / 有向图保存后加载，顶点表、全部边权与最短路径都与原图相同；
+	 * 截断的文件、越界的 CSR 目标、越界的名称区间与不单调的 CSR 行偏移在不校验散列时也被拒绝；
+	 * 记录的源文件被修改后，按该源文件加载的快照被视为过期；不连续的顶点编号随快照保存，加载后写出的文件不变。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_snapshot(int const vertices = 120, int const edges = 500)
+	{
+		std::string const filename = "check_snapshot.snap";
+		bool passed = true;
+		for (Storage const storage : {Storage::Matrix, Storage::Csr}) {
+			for (bool const directed : {false, true}) {
+				WGraph graph = make_random_graph(vertices, edges, storage, directed, 126);
+				std::size_t failures = 0;
+				auto const loaded = save_snapshot(graph, filename) ? load_snapshot<int, int>(filename, true) : std::nullopt;
+				if (!loaded.has_value() || loaded->vertexCount() != vertices || loaded->storage() != storage
+					|| loaded->symmetric() != graph.symmetric()) {
+					++failures;
+				} else {
+					for (int u = 0; u < vertices; ++u) {
+						auto const& a = graph.vertices();
+						auto const& b = loaded->vertices();
+						failures += a.name(u) != b.name(u) || a.x(u) != b.x(u) || a.y(u) != b.y(u) || a.attr(u) != b.attr(u);
+						for (int v = 0; v < vertices; ++v) {
+							failures += graph.edgeWeight(u, v) != loaded->edgeWeight(u, v);
+						}
+						failures += graph.dijkstra(0, u) != loaded->dijkstra(0, u);
+					}
+				}
+				passed &= report(std::format("快照 ({}, {})", storage == Storage::Matrix ? "Matrix" : "Csr",
+				                             directed ? "有向" : "无向"), vertices, failures);
+			}
+		}
+
+		// 损坏的文件：按数据段表修改单个元素，或截断文件
+		WGraph graph = make_random_graph(vertices, edges, Storage::Csr, false, 126);
+		save_snapshot(graph, filename);
+		std::string const original = read_file_buffer(filename).value_or(std::string{});
+		auto const corrupt = [&](snapshot::Section const kind, std::size_t const index, std::uint32_t const value)
+		{
+			std::string bytes = original;
+			snapshot::Header header{};
+			std::memcpy(&header, bytes.data(), sizeof(header));
+			for (std::uint32_t i = 0; i < header.section_count; ++i) {
+				snapshot::SectionEntry entry{};
+				std::memcpy(&entry, bytes.data() + sizeof(header) + i * sizeof(entry), sizeof(entry));
+				if (entry.kind == static_cast<std::uint32_t>(kind)) {
+					std::memcpy(bytes.data() + entry.offset + index * sizeof(value), &value, sizeof(value));
+				}
+			}
+			write_text(filename, bytes);
+			return !load_snapshot<int, int>(filename).has_value();
+		};
+		std::size_t failures = 0;
+		failures += !corrupt(snapshot::Section::Targets, 0, static_cast<std::uint32_t>(vertices) + 5);
+		failures += !corrupt(snapshot::Section::NameOffset, 0, 1u << 30);
+		failures += !corrupt(snapshot::Section::Offsets, 1, static_cast<std::uint32_t>(2 * edges + 1));
+		write_text(filename, std::string_view(original).substr(0, original.size() / 2));
+		failures += load_snapshot<int, int>(filename).has_value();
+		passed &= report("损坏的快照", 4, failures);
+
+		// 过期的快照：源文件大小或修改时间改变后拒绝加载，不给出源文件时仍可加载
+		std::string const source = "check_snapshot.txt";
+		write_text(source, "[Vertex]\n");
+		failures = !save_snapshot(graph, filename, source);
+		failures += !load_snapshot<int, int>(filename, false, source).has_value();
+		write_text(source, "[Vertex]\n[Edge]\n");
+		failures += load_snapshot<int, int>(filename, false, source).has_value();
+		failures += !load_snapshot<int, int>(filename).has_value();
+		passed &= report("过期的快照", 4, failures);
+
+		// 不连续的顶点编号：load_graph 得到的映射随快照保存，加载后的图写出与原图相同的文件
+		std::string const output = "check_snapshot_out.txt";
+		write_text(source, "[Vertex] A 10 1 2 0\n"
+		                   "[Vertex] B 200 3 4 1\n"
+		                   "[Edge] 10 200 7\n"
+		                   "[Edge] 200 35 8\n");
+		failures = 0;
+		if (auto loaded = load_graph(source); !loaded.has_value() || !save_snapshot(loaded->graph, filename)) {
+			++failures;
+		} else {
+			auto reloaded = load_snapshot<int, int>(filename, true);
+			failures += !reloaded.has_value() || reloaded->vertexIds().original != loaded->ids.original;
+			auto const expected = write_to_file(loaded->graph, output) ? record_lines(output) : std::vector<std::string>{};
+			failures += !reloaded.has_value() || !write_to_file(*reloaded, output) || record_lines(output) != expected;
+		}
+		passed &= report("快照中的顶点编号", 2, failures);
+
+		std::remove(output.c_str());
+		std::remove(source.c_str());
+		std::remove(filename.c_str());
+		return passed;
+	}
+
+	/**
+	 * @brief 在 bench_astar 使用的几何网格图上比较 aStar 与 dijkstra：距离相同、路径合法，且启发函数可用而不退化为 Dijkstra。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_astar_geometric(int const side = 60, int const queries = 300)
+	{
+		WGraph const graph = make_geometric_graph(side);
+		std::mt19937 rng(3);
+		std::uniform_int_distribution<int> vertex_dist(0, side * side - 1);
+
+		std::size_t failures = 0;
+		for (int q = 0; q < queries; ++q) {
+			int const s = vertex_dist(rng), t = vertex_dist(rng);
+			SearchStats stats{};
+			auto const result = graph.aStar(s, t, &stats);
+			if (result.second != graph.dijkstra(s, t).second || !is_consistent_path(graph, result, s, t)
+				|| stats.fallback) {
+				++failures;
+			}
+		}
+		return report("A*（几何网格图）", queries, failures);
+	}
+
+	/**
+	 * @brief 在随机的无向 / 有向、Matrix / Csr 图上比较 aStar、bidirectionalDijkstra 与 dijkstra。
+	 *
+	 * 三者的距离必须相同，返回的路径必须是起点到终点、权重之和等于距离的合法路径。
+	 * 边数较少时部分顶点对不可达，同时覆盖了无路径的情形。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_shortest_paths(int const vertices = 200, int const edges = 500, int const queries = 2000)
+	{
+		bool passed = true;
+		std::uint32_t seed = 1;
+		for (Storage const storage : {Storage::Matrix, Storage::Csr}) {
+			for (bool const directed : {false, true}) {
+				WGraph const graph = make_random_graph(vertices, edges, storage, directed, seed++);
+				std::mt19937 rng(seed);
+				std::uniform_int_distribution<int> vertex_dist(0, vertices - 1);
+
+				std::size_t astar_failures = 0, bidirectional_failures = 0;
+				for (int q = 0; q < queries; ++q) {
+					int const s = vertex_dist(rng), t = vertex_dist(rng);
+					auto const expected = graph.dijkstra(s, t);
+					auto const astar = graph.aStar(s, t);
+					auto const bidirectional = graph.bidirectionalDijkstra(s, t);
+					if (astar.second != expected.second || !is_consistent_path(graph, astar, s, t)) {
+						++astar_failures;
+					}
+					if (bidirectional.second != expected.second || !is_consistent_path(graph, bidirectional, s, t)) {
+						++bidirectional_failures;
+					}
+				}
+
+				std::string const kind = std::format("{}, {}", storage == Storage::Matrix ? "Matrix" : "Csr",
+				                                     directed ? "有向" : "无向");
+				passed &= report(std::format("aStar ({})", kind), queries, astar_failures);
+				passed &= report(std::format("bidirectionalDijkstra ({})", kind), queries, bidirectional_failures);
+			}
+		}
+		return passed;
+	}
+
+	/**
+	 * @brief 比较基数堆、Dial 桶队列与默认 4 叉堆下 dijkstra 和 bidirectionalDijkstra 的结果。
+	 *
+	 * 边权取 [1, 100]，超过 Dial 队列初始的 64 个桶，同时覆盖了环形数组扩容的情形；
+	 * 键值跨度超过 BucketQueue::max_buckets 时 Dial 队列抛出 std::length_error，之后的查询不受影响。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_queue_policies(int const vertices = 300, int const edges = 1200, int const queries = 1000)
+	{
+		bool passed = true;
+		std::uint32_t seed = 11;
+		for (bool const directed : {false, true}) {
+			WGraph const graph = make_random_graph(vertices, edges, Storage::Csr, directed, seed++);
+			std::mt19937 rng(seed);
+			std::uniform_int_distribution<int> vertex_dist(0, vertices - 1);
+
+			std::size_t radix_failures = 0, dial_failures = 0;
+			for (int q = 0; q < queries; ++q) {
+				int const s = vertex_dist(rng), t = vertex_dist(rng);
+				auto const expected = graph.dijkstra(s, t);
+				auto const radix = graph.dijkstra<RadixHeapQueue>(s, t);
+				auto const dial = graph.dijkstra<DialQueue>(s, t);
+				auto const radix_bidirectional = graph.bidirectionalDijkstra<RadixHeapQueue>(s, t);
+				auto const dial_bidirectional = graph.bidirectionalDijkstra<DialQueue>(s, t);
+				if (radix.second != expected.second || !is_consistent_path(graph, radix, s, t)
+					|| radix_bidirectional.second != expected.second
+					|| !is_consistent_path(graph, radix_bidirectional, s, t)) {
+					++radix_failures;
+				}
+				if (dial.second != expected.second || !is_consistent_path(graph, dial, s, t)
+					|| dial_bidirectional.second != expected.second
+					|| !is_consistent_path(graph, dial_bidirectional, s, t)) {
+					++dial_failures;
+				}
+			}
+
+			std::string_view const kind = directed ? "有向" : "无向";
+			passed &= report(std::format("RadixHeapQueue ({})", kind), queries, radix_failures);
+			passed &= report(std::format("DialQueue ({})", kind), queries, dial_failures);
+		}
+
+		// 3 到 1 的查询不经过 0，不会遇到超限的边
+		WGraph wide(4, Storage::Csr);
+		wide.addEdge(0, 1, 1);
+		wide.addEdge(0, 2, static_cast<int>(BucketQueue<WGraph::Distance>::max_buckets) + 1);
+		wide.addEdge(1, 3, 2);
+		wide.finalize();
+		std::size_t failures = 0;
+		try {
+			static_cast<void>(wide.dijkstra<DialQueue>(0, 2));
+			++failures;
+		} catch (std::length_error const&) {
+		}
+		failures += wide.dijkstra<DialQueue>(3, 1).second != 2;
+		return report("DialQueue（键值跨度超限）", 2, failures) && passed;
+	}
+
+	/**
+	 * @brief 比较两种地标选取方式下 ALT 查询与 dijkstra 的结果，并检查地标文件的保存与加载。
+	 *
+	 * 除距离与路径外，还检查 lowerBound 不超过真实距离；修改图之后加载旧文件应被拒绝。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_landmarks(int const vertices = 300, int const edges = 700, int const queries = 1000)
+	{
+		bool passed = true;
+		std::string const filename = "check_landmarks.alt";
+		std::uint32_t seed = 21;
+		for (Storage const storage : {Storage::Matrix, Storage::Csr}) {
+			for (bool const directed : {false, true}) {
+				WGraph graph = make_random_graph(vertices, edges, storage, directed, seed++);
+				std::mt19937 rng(seed);
+				std::uniform_int_distribution<int> vertex_dist(0, vertices - 1);
+
+				for (LandmarkSelection const selection : {LandmarkSelection::Farthest, LandmarkSelection::Planar}) {
+					auto const index = WLandmarkIndex::build(graph, 8, selection, 2);
+					std::size_t failures = 0;
+					for (int q = 0; q < queries; ++q) {
+						int const s = vertex_dist(rng), t = vertex_dist(rng);
+						auto const expected = graph.dijkstra(s, t);
+						auto const alt = index.query(graph, s, t);
+						auto const bound = index.lowerBound(s, t);
+						if (alt.second != expected.second || !is_consistent_path(graph, alt, s, t)
+							|| (expected.second >= 0 && (bound < 0 || bound > expected.second))) {
+							++failures;
+						}
+					}
+					std::string const kind = std::format("{}, {}, {}", storage == Storage::Matrix ? "Matrix" : "Csr",
+					                                     directed ? "有向" : "无向",
+					                                     selection == LandmarkSelection::Farthest ? "最远点" : "平面");
+					passed &= report(std::format("ALT ({})", kind), queries, failures);
+				}
+
+				auto const index = WLandmarkIndex::build(graph, 8);
+				std::size_t failures = 0;
+				auto const loaded = save_landmarks(index, filename) ? load_landmarks(graph, filename) : std::nullopt;
+				if (!loaded.has_value() || loaded->landmarkCount() != index.landmarkCount() || !loaded->matches(graph)) {
+					++failures;
+				} else {
+					for (int q = 0; q < queries; ++q) {
+						int const s = vertex_dist(rng), t = vertex_dist(rng);
+						failures += loaded->query(graph, s, t).second != graph.dijkstra(s, t).second;
+					}
+				}
+				// 修改图后旧文件失效
+				graph.addEdge(0, 1, 12345);
+				graph.finalize();
+				if (load_landmarks(graph, filename).has_value()) {
+					++failures;
+				}
+				passed &= report(std::format("地标文件 ({}, {})", storage == Storage::Matrix ? "Matrix" : "Csr",
+				                             directed ? "有向" : "无向"), queries, failures);
+			}
+		}
+		std::remove(filename.c_str());
+		return passed;
+	}
+
+	/**
+	 * @brief 比较收缩层次查询与 dijkstra 的距离和路径，检查层次文件的保存与加载，
+	 * 并检查修改图之后层次失效、查询退回 dijkstra、旧文件被拒绝。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_contraction_hierarchy(int const vertices = 300, int const edges = 900, int const queries = 2000)
+	{
+		bool passed = true;
+		std::string const filename = "check_contraction_hierarchy.ch";
+		std::uint32_t seed = 31;
+		for (Storage const storage : {Storage::Matrix, Storage::Csr}) {
+			for (bool const directed : {false, true}) {
+				WGraph graph = make_random_graph(vertices, edges, storage, directed, seed++);
+				graph.prepareContractionHierarchy();
+				std::mt19937 rng(seed);
+				std::uniform_int_distribution<int> vertex_dist(0, vertices - 1);
+
+				std::size_t failures = 0;
+				for (int q = 0; q < queries; ++q) {
+					int const s = vertex_dist(rng), t = vertex_dist(rng);
+					SearchStats stats{};
+					auto const ch = graph.contractionHierarchyQuery(s, t, &stats);
+					if (stats.fallback || ch.second != graph.dijkstra(s, t).second
+						|| !is_consistent_path(graph, ch, s, t)) {
+						++failures;
+					}
+				}
+
+				// 层次文件：加载到按同样种子生成的图上，查询结果与原层次相同
+				std::size_t file_failures = 0;
+				WGraph fresh = make_random_graph(vertices, edges, storage, directed, seed - 1);
+				if (!save_contraction_hierarchy(*graph.contractionHierarchy(), filename)) {
+					++file_failures;
+				} else if (auto loaded = load_contraction_hierarchy(fresh, filename);
+					!loaded.has_value() || loaded->shortcutCount() != graph.contractionHierarchy()->shortcutCount()
+					|| !fresh.useContractionHierarchy(std::move(*loaded))) {
+					++file_failures;
+				} else {
+					for (int q = 0; q < queries; ++q) {
+						int const s = vertex_dist(rng), t = vertex_dist(rng);
+						file_failures += fresh.contractionHierarchyQuery(s, t) != graph.contractionHierarchyQuery(s, t);
+					}
+				}
+
+				// 修改图后层次失效，旧文件被拒绝
+				graph.addEdge(0, 1, 1);
+				graph.finalize();
+				SearchStats stats{};
+				auto const after = graph.contractionHierarchyQuery(0, 1, &stats);
+				if (graph.hasContractionHierarchy() || !stats.fallback || after.second != graph.dijkstra(0, 1).second) {
+					++failures;
+				}
+				file_failures += load_contraction_hierarchy(graph, filename).has_value();
+				std::string const kind = std::format("{}, {}", storage == Storage::Matrix ? "Matrix" : "Csr",
+				                                     directed ? "有向" : "无向");
+				passed &= report(std::format("收缩层次 ({})", kind), queries + 1, failures);
+				passed &= report(std::format("层次文件 ({})", kind), queries + 1, file_failures);
+			}
+		}
+		std::remove(filename.c_str());
+		return passed;
+	}
+
+	/**
+	 * @brief 比较两种枢纽顺序下枢纽标签的距离、路径与 dijkstra 的结果，并检查标签文件的保存与加载。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_hub_labels(int const vertices = 300, int const edges = 900, int const queries = 2000)
+	{
+		bool passed = true;
+		std::string const filename = "check_hub_labels.hl";
+		std::uint32_t seed = 41;
+		for (Storage const storage : {Storage::Matrix, Storage::Csr}) {
+			for (bool const directed : {false, true}) {
+				WGraph graph = make_random_graph(vertices, edges, storage, directed, seed++);
+				std::mt19937 rng(seed);
+				std::uniform_int_distribution<int> vertex_dist(0, vertices - 1);
+				std::string const kind = std::format("{}, {}", storage == Storage::Matrix ? "Matrix" : "Csr",
+				                                     directed ? "有向" : "无向");
+
+				// 先按度数顺序，再按收缩层次的顺序构建
+				for (bool const hierarchy : {false, true}) {
+					if (hierarchy) {
+						graph.prepareContractionHierarchy();
+					}
+					graph.prepareHubLabels();
+					std::size_t failures = 0;
+					for (int q = 0; q < queries; ++q) {
+						int const s = vertex_dist(rng), t = vertex_dist(rng);
+						auto const expected = graph.dijkstra(s, t);
+						auto const labeled = graph.hubLabelQuery(s, t);
+						if (labeled.second != expected.second || graph.hubLabelDistance(s, t) != expected.second
+							|| !is_consistent_path(graph, labeled, s, t)) {
+							++failures;
+						}
+					}
+					passed &= report(std::format("枢纽标签 ({}, {})", kind, hierarchy ? "CH 顺序" : "度数顺序"),
+					                 queries, failures);
+				}
+
+				std::size_t failures = 0;
+				WGraph copy = graph;
+				if (!save_hub_labels(*graph.hubLabels(), filename)) {
+					++failures;
+				} else if (auto loaded = load_hub_labels(copy, filename);
+					!loaded.has_value() || loaded->entryCount() != graph.hubLabels()->entryCount()
+					|| !copy.useHubLabels(std::move(*loaded))) {
+					++failures;
+				} else {
+					for (int q = 0; q < queries; ++q) {
+						int const s = vertex_dist(rng), t = vertex_dist(rng);
+						auto const loaded_result = copy.hubLabelQuery(s, t);
+						if (loaded_result != graph.hubLabelQuery(s, t) || !is_consistent_path(graph, loaded_result, s, t)) {
+							++failures;
+						}
+					}
+				}
+				// 修改图后标签失效，旧文件被拒绝
+				copy.addEdge(0, 1, 12345);
+				copy.finalize();
+				SearchStats stats{};
+				if (copy.hubLabels() != nullptr || copy.hubLabelDistance(0, 1, &stats) != copy.dijkstra(0, 1).second
+					|| !stats.fallback || load_hub_labels(copy, filename).has_value()) {
+					++failures;
+				}
+				passed &= report(std::format("标签文件 ({})", kind), queries + 1, failures);
+			}
+		}
+		std::remove(filename.c_str());
+		return passed;
+	}
+
+	/**
+	 * @brief 比较 distanceTable 与逐对 dijkstra 的结果，起点与终点含重复顶点和无效顶点，分别以 1 个和 3 个线程计算。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_distance_table(int const vertices = 300, int const edges = 800, int const count = 40)
+	{
+		bool passed = true;
+		std::uint32_t seed = 51;
+		for (Storage const storage : {Storage::Matrix, Storage::Csr}) {
+			for (bool const directed : {false, true}) {
+				WGraph const graph = make_random_graph(vertices, edges, storage, directed, seed++);
+				std::mt19937 rng(seed);
+				std::uniform_int_distribution<int> vertex_dist(0, vertices - 1);
+				std::vector<int> sources, targets;
+				for (int i = 0; i < count; ++i) {
+					sources.push_back(vertex_dist(rng));
+					targets.push_back(vertex_dist(rng) / 2);
+				}
+				sources.push_back(vertices);
+				targets.push_back(-1);
+
+				std::size_t failures = 0;
+				for (unsigned const threads : {1u, 3u}) {
+					auto const table = graph.distanceTable(sources, targets, threads);
+					for (int r = 0; r < table.rows; ++r) {
+						for (int c = 0; c < table.columns; ++c) {
+							failures += table(r, c) != graph.dijkstra(sources[r], targets[c]).second;
+						}
+					}
+				}
+				passed &= report(std::format("distanceTable ({}, {})", storage == Storage::Matrix ? "Matrix" : "Csr",
+				                             directed ? "有向" : "无向"), sources.size() * targets.size() * 2, failures);
+			}
+		}
+		return passed;
+	}
+
+	/**
+	 * @brief 比较最短路径树中到每个顶点的距离与路径和 dijkstra 的结果。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_shortest_path_tree(int const vertices = 300, int const edges = 800, int const sources = 20)
+	{
+		bool passed = true;
+		std::uint32_t seed = 61;
+		for (Storage const storage : {Storage::Matrix, Storage::Csr}) {
+			for (bool const directed : {false, true}) {
+				WGraph const graph = make_random_graph(vertices, edges, storage, directed, seed++);
+				std::mt19937 rng(seed);
+				std::uniform_int_distribution<int> vertex_dist(0, vertices - 1);
+
+				std::size_t failures = 0;
+				for (int k = 0; k < sources; ++k) {
+					int const s = vertex_dist(rng);
+					auto const tree = graph.shortestPathTree(s);
+					for (int t = 0; t < vertices; ++t) {
+						auto const expected = graph.dijkstra(s, t);
+						auto const result = tree.query(t);
+						if (tree.distance(t) != expected.second || result.second != expected.second
+							|| !is_consistent_path(graph, result, s, t)) {
+							++failures;
+						}
+					}
+				}
+				// 无效起点与终点
+				if (graph.shortestPathTree(-1).reachable(0) || graph.shortestPathTree(0).distance(vertices) != -1) {
+					++failures;
+				}
+				passed &= report(std::format("shortestPathTree ({}, {})", storage == Storage::Matrix ? "Matrix" : "Csr",
+				                             directed ? "有向" : "无向"), sources * vertices + 1, failures);
+			}
+		}
+		return passed;
+	}
+
+	/**
+	 * @brief 比较 deltaStepping 与 shortestPathTree 的距离，并检查不同线程数、不同桶宽下前驱完全相同；
+	 * 权重远大于桶宽时桶宽被调大，结果不变。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_delta_stepping(int const vertices = 3000, int const edges = 9000, int const sources = 3)
+	{
+		bool passed = true;
+		std::uint32_t seed = 71;
+		for (Storage const storage : {Storage::Matrix, Storage::Csr}) {
+			for (bool const directed : {false, true}) {
+				WGraph const graph = make_random_graph(vertices, edges, storage, directed, seed++);
+				std::mt19937 rng(seed);
+				std::uniform_int_distribution<int> vertex_dist(0, vertices - 1);
+
+				std::size_t failures = 0, cases = 0;
+				for (int k = 0; k < sources; ++k) {
+					int const s = vertex_dist(rng);
+					auto const expected = graph.shortestPathTree(s);
+					auto const reference = graph.deltaStepping(s, 1);
+					for (unsigned const threads : {1u, 3u}) {
+						for (WGraph::Distance const delta : {0, 1, 30, 1000}) {
+							auto const tree = graph.deltaStepping(s, threads, delta);
+							for (int v = 0; v < vertices; ++v) {
+								++cases;
+								if (tree.distance(v) != expected.distance(v) || tree.parent(v) != reference.parent(v)
+									|| !is_consistent_path(graph, tree.query(v), s, v)) {
+									++failures;
+								}
+							}
+						}
+					}
+				}
+				passed &= report(std::format("deltaStepping ({}, {})", storage == Storage::Matrix ? "Matrix" : "Csr",
+				                             directed ? "有向" : "无向"), cases, failures);
+			}
+		}
+
+		// 桶宽 1、权重至多 1e8：不调大桶宽时每个线程需要 1e8 个桶
+		WGraph heavy(vertices, Storage::Csr);
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> vertex_dist(0, vertices - 1);
+		std::uniform_int_distribution<int> weight_dist(1, 100'000'000);
+		for (int e = 0; e < edges; ++e) {
+			int const a = vertex_dist(rng), b = vertex_dist(rng);
+			if (a != b) {
+				heavy.addEdge(a, b, weight_dist(rng));
+			}
+		}
+		heavy.finalize();
+		auto const expected = heavy.shortestPathTree(0);
+		std::size_t failures = 0;
+		for (unsigned const threads : {1u, 3u}) {
+			auto const tree = heavy.deltaStepping(0, threads, 1);
+			for (int v = 0; v < vertices; ++v) {
+				failures += tree.distance(v) != expected.distance(v);
+			}
+		}
+		return report("deltaStepping（大权重）", 2 * static_cast<std::size_t>(vertices), failures) && passed;
+	}
+
+	/**
+	 * @brief 比较 allPairs 与每个起点的 shortestPathTree，并检查不同线程数下下一跳完全相同。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_all_pairs(int const vertices = 200, int const edges = 500)
+	{
+		bool passed = true;
+		std::uint32_t seed = 81;
+		for (Storage const storage : {Storage::Matrix, Storage::Csr}) {
+			for (bool const directed : {false, true}) {
+				WGraph const graph = make_random_graph(vertices, edges, storage, directed, seed++);
+				auto const matrix = graph.allPairs(1);
+				auto const parallel = graph.allPairs(3);
+
+				std::size_t failures = 0;
+				for (int s = 0; s < vertices; ++s) {
+					auto const tree = graph.shortestPathTree(s);
+					for (int t = 0; t < vertices; ++t) {
+						if (matrix.distance(s, t) != tree.distance(t) || parallel.distance(s, t) != tree.distance(t)
+							|| matrix.nextHop(s, t) != parallel.nextHop(s, t)
+							|| (tree.reachable(t) && !is_consistent_path(graph, matrix.query(s, t), s, t))) {
+							++failures;
+						}
+					}
+				}
+				// 无效顶点
+				if (matrix.reachable(-1, 0) || matrix.distance(0, vertices) != -1) {
+					++failures;
+				}
+				passed &= report(std::format("allPairs ({}, {})", storage == Storage::Matrix ? "Matrix" : "Csr",
+				                             directed ? "有向" : "无向"), vertices * vertices + 1, failures);
+			}
+		}
+		return passed;
+	}
+
+	/**
+	 * @brief 检查模拟退火的增量代价：每次接受操作后，累计的代价必须等于重新计算的整条路径代价，
+	 * 路径始终是首尾不变的排列；并检查 localSearchOptimization 在完全图上返回合法路径，
+	 * 不存在合法路径时 localSearchOptimization、parallelTempering 与 geneticLocalSearchOptimization 返回空路径和 -1。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_annealing(int const vertices = 60, int const edges = 1500, int const steps = 5000)
+	{
+		bool passed = true;
+		std::uint32_t seed = 91;
+		for (Storage const storage : {Storage::Matrix, Storage::Csr}) {
+			for (bool const directed : {false, true}) {
+				WGraph const graph = make_random_graph(vertices, edges, storage, directed, seed++);
+				auto const cost = [&graph](int const a, int const b) -> std::int64_t
+				{
+					auto const weight = graph.edgeWeight(a, b);
+					return weight >= 0 ? weight : 10000;
+				};
+				auto const path_cost = [&cost](std::vector<int> const& path)
+				{
+					std::int64_t sum = 0;
+					for (std::size_t k = 0; k + 1 < path.size(); ++k) {
+						sum += cost(path[k], path[k + 1]);
+					}
+					return sum;
+				};
+
+				std::size_t failures = 0, cases = 0;
+				for (auto const& [swap, reverse, insert] : {std::tuple{1.0, 1.0, 1.0}, std::tuple{1.0, 0.0, 0.0},
+				                                            std::tuple{0.0, 1.0, 0.0}, std::tuple{0.0, 0.0, 1.0}}) {
+					AnnealingConfig config;
+					config.swap_weight = swap;
+					config.reverse_weight = reverse;
+					config.insert_weight = insert;
+					std::vector<int> initial(vertices);
+					std::iota(initial.begin(), initial.end(), 0);
+					annealing::PathAnnealer annealer(initial, cost, graph.symmetric(), config);
+
+					std::mt19937 rng(seed);
+					for (int k = 0; k < steps; ++k) {
+						if (annealer.step(50.0, rng)) {
+							++cases;
+							if (annealer.cost() != path_cost(annealer.path())) {
+								++failures;
+							}
+						}
+					}
+					std::vector<int> sorted = annealer.path();
+					std::ranges::sort(sorted);
+					if (sorted != initial || annealer.path().front() != 0 || annealer.path().back() != vertices - 1
+						|| annealer.bestCost() != path_cost(annealer.bestPath())) {
+						++failures;
+					}
+				}
+				passed &= report(std::format("PathAnnealer ({}, {})", storage == Storage::Matrix ? "Matrix" : "Csr",
+				                             directed ? "有向" : "无向"), cases, failures);
+			}
+		}
+
+		// 完全图上每一步都有边
+		WGraph const complete = make_random_graph(40, 40 * 40 * 4, Storage::Matrix, false, seed);
+		AnnealingConfig config;
+		config.iterations = 20000;
+		config.seed = seed;
+		std::size_t failures = 0;
+		for (int s = 0; s < 10; ++s) {
+			if (!is_consistent_path(complete, complete.localSearchOptimization(s, 39 - s, config), s, 39 - s)) {
+				++failures;
+			}
+		}
+		passed &= report("localSearchOptimization", 10, failures);
+
+		// 终点 3 没有任何边，任何路径都含缺边
+		WGraph broken(4);
+		broken.addEdge(0, 1, 5);
+		broken.addEdge(1, 2, 5);
+		broken.finalize();
+		auto const rejected = [](auto const& result) { return result.first.empty() && result.second == -1; };
+		TemperingConfig tempering;
+		tempering.replicas = 2;
+		tempering.iterations = 200;
+		tempering.moves.seed = seed;
+		std::size_t const missing = !rejected(broken.localSearchOptimization(0, 3, config))
+			+ !rejected(broken.parallelTempering(0, 3, tempering).best)
+			+ !rejected(broken.geneticLocalSearchOptimization(0, 3, 10, 5));
+		return report("退火与 GLS（缺边）", 3, missing) && passed;
+	}
+
+	/**
+	 * @brief 检查 parallelTempering：路径合法且不差于贪心初始路径，温度几何递增，
+	 * 同一种子在 1 个与 3 个线程下的结果与统计完全相同。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_parallel_tempering(int const vertices = 40, int const runs = 5)
+	{
+		WGraph const graph = make_random_graph(vertices, vertices * vertices * 4, Storage::Matrix, false, 101);
+		std::size_t failures = 0;
+		for (int s = 0; s < runs; ++s) {
+			int const e = vertices - 1 - s;
+			TemperingConfig config;
+			config.replicas = 4;
+			config.iterations = 5000;
+			config.exchange_interval = 100;
+			config.moves.seed = 101 + s;
+			config.threads = 1;
+			auto const serial = graph.parallelTempering(s, e, config);
+			config.threads = 3;
+			auto const parallel = graph.parallelTempering(s, e, config);
+
+			AnnealingConfig greedy;
+			greedy.iterations = 0;
+			bool ok = is_consistent_path(graph, serial.best, s, e)
+				&& serial.best.second <= graph.localSearchOptimization(s, e, greedy).second
+				&& serial.best == parallel.best && serial.replicas.size() == 4;
+			for (std::size_t k = 0; ok && k < serial.replicas.size(); ++k) {
+				auto const& a = serial.replicas[k];
+				auto const& b = parallel.replicas[k];
+				ok = a.proposed == 5000 && a.accepted <= a.proposed && a.accepted == b.accepted && a.cost == b.cost
+					&& a.exchanges_accepted == b.exchanges_accepted && a.exchanges_accepted <= a.exchanges_attempted
+					&& (k == 0 || a.temperature > serial.replicas[k - 1].temperature);
+			}
+			failures += !ok;
+		}
+		return report("parallelTempering", runs, failures);
+	}
+
+	/**
+	 * @brief 检查 islandGeneticAlgorithm：两种迁移拓扑下返回合法路径，同一种子在 1 个与 3 个线程下结果相同。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_island_genetic(int const vertices = 30, int const runs = 3)
+	{
+		WGraph const graph = make_random_graph(vertices, vertices * vertices * 4, Storage::Matrix, false, 111);
+		std::size_t failures = 0;
+		for (MigrationTopology const topology : {MigrationTopology::Ring, MigrationTopology::Random}) {
+			for (int s = 0; s < runs; ++s) {
+				int const e = vertices - 1 - s;
+				IslandConfig config;
+				config.islands = 4;
+				config.population_size = 30;
+				config.generations = 40;
+				config.migration_interval = 10;
+				config.topology = topology;
+				config.seed = 111 + s;
+				config.threads = 1;
+				auto const serial = graph.islandGeneticAlgorithm(s, e, config);
+				config.threads = 3;
+				auto const parallel = graph.islandGeneticAlgorithm(s, e, config);
+				if (!is_consistent_path(graph, serial, s, e) || serial.second < 0 || serial != parallel) {
+					++failures;
+				}
+			}
+		}
+		return report("islandGeneticAlgorithm", 2 * runs, failures);
+	}
+
+	/**
+	 * @brief 检查连续种群上的遗传算子与 geneticLocalSearchOptimization：
+	 * crossover 与 mutate 保持路径的顶点多重集合（含起点与终点相同的情形）且计数归零、mutate 不动两端；
+	 * geneticLocalSearchOptimization 在无向与有向图上返回两端正确、经过所有顶点的合法路径，同一种子结果相同。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_genetic_operators(int const vertices = 20, int const runs = 200)
+	{
+		std::mt19937 rng(124);
+		std::size_t failures = 0;
+		std::vector<std::uint8_t> used(vertices, 0);
+		for (int r = 0; r < runs; ++r) {
+			int const start = r % vertices;
+			int const end = r % 2 == 0 ? start : vertices - 1 - start;
+			genetic::Population<int, int> population(3, start == end ? vertices + 1 : vertices);
+			auto const initial = initialize_population(start, end, vertices, 2, rng);
+			std::ranges::copy(initial[0], population[0].begin());
+			std::ranges::copy(initial[1], population[1].begin());
+
+			auto const child = population[2];
+			crossover<int>(std::as_const(population)[0], std::as_const(population)[1], child, rng, used);
+			mutate(child, rng);
+
+			auto sorted_child = std::vector(child.begin(), child.end());
+			auto sorted_parent = initial[0];
+			std::ranges::sort(sorted_child);
+			std::ranges::sort(sorted_parent);
+			mutate(population[0], rng);
+			bool const ok = sorted_child == sorted_parent && std::ranges::count(used, 0) == vertices
+				&& population[0].front() == start && population[0].back() == end;
+			failures += !ok;
+		}
+
+		for (bool const directed : {false, true}) {
+			WGraph const graph = make_random_graph(vertices, vertices * vertices * 4, Storage::Matrix, directed, 124);
+			for (int s = 0; s < 3; ++s) {
+				int const e = vertices - 1 - s;
+				auto const result = graph.geneticLocalSearchOptimization(s, e, 10, 5, 124);
+				std::unordered_set<int> const visited(result.first.begin(), result.first.end());
+				failures += !is_consistent_path(graph, result, s, e) || result.second < 0
+					|| visited.size() != static_cast<std::size_t>(vertices)
+					|| graph.geneticLocalSearchOptimization(s, e, 10, 5, 124) != result;
+			}
+		}
+		return report("genetic operators", runs + 6, failures);
+	}
+
+	/**
+	 * @brief 检查 genetic::Selector：别名表轮盘赌的选择频率接近适应度比例，随机遍历抽样每个个体的选中次数
+	 * 与期望相差不到 1，锦标赛的选择频率随距离单调下降；没有有效路径时三者均可选到任意个体；
+	 * 三种算子下 geneticAlgorithm 返回合法路径，同一种子结果相同。
+	 * @return true 如果全部通过
+	 */
+	inline bool check_selection(int const draws = 200000)
+	{
+		using Distance = WGraph::Distance;
+		std::vector<Distance> const distances{0, 1, 3, 9, -1, 4, 19, 99};
+		std::vector<Distance> const invalid(distances.size(), -1);
+		auto const size = static_cast<int>(distances.size());
+		double total = 0.0;
+		for (Distance const d : distances) {
+			total += d == -1 ? 0.0 : 1.0 / (d + 1);
+		}
+		auto const expected = [&](int const i) { return distances[i] == -1 ? 0.0 : 1.0 / (distances[i] + 1) / total; };
+
+		std::mt19937 rng(125);
+		std::size_t cases = 0, failures = 0;
+		auto const frequencies = [&](genetic::Selector<Distance>& selector, std::span<Distance const> const input)
+		{
+			std::vector<double> counts(size, 0.0);
+			selector.prepare(input, draws, rng);
+			for (int k = 0; k < draws; ++k) {
+				counts[selector.next(rng)] += 1.0 / draws;
+			}
+			return counts;
+		};
+
+		genetic::Selector<Distance> roulette(SelectionMethod::Roulette, 0, size);
+		auto const roulette_counts = frequencies(roulette, distances);
+		for (int i = 0; i < size; ++i) {
+			++cases;
+			failures += std::abs(roulette_counts[i] - expected(i)) > 0.01;
+		}
+
+		genetic::Selector<Distance> universal(SelectionMethod::Universal, 0, size);
+		for (int round = 0; round < 100; ++round) {
+			int const count = 1 + round % (2 * size);
+			universal.prepare(distances, count, rng);
+			std::vector<int> counts(size, 0);
+			for (int k = 0; k < count; ++k) {
+				++counts[universal.next(rng)];
+			}
+			++cases;
+			failures += std::ranges::any_of(std::views::iota(0, size), [&](int const i)
+			{
+				return std::abs(counts[i] - expected(i) * count) >= 1.0;
+			});
+		}
+
+		genetic::Selector<Distance> tournament(SelectionMethod::Tournament, 2, size);
+		auto const tournament_counts = frequencies(tournament, distances);
+		for (auto const& [better, worse] : {std::pair{0, 1}, {1, 2}, {2, 5}, {5, 3}, {3, 6}, {6, 7}, {7, 4}}) {
+			++cases;
+			failures += tournament_counts[better] <= tournament_counts[worse];
+		}
+
+		for (auto* selector : {&roulette, &universal, &tournament}) {
+			auto const counts = frequencies(*selector, invalid);
+			++cases;
+			failures += std::ranges::count(counts, 0.0) != 0;
+		}
+
+		WGraph const graph = make_random_graph(20, 20 * 20 * 4, Storage::Matrix, false, 125);
+		for (SelectionMethod const method : {SelectionMethod::Roulette, SelectionMethod::Tournament,
+		                                     SelectionMethod::Universal}) {
+			IslandConfig config;
+			config.population_size = 40;
+			config.generations = 30;
+			config.selection = method;
+			config.seed = 125;
+			auto const first = graph.geneticAlgorithm(0, 19, config);
+			auto const second = graph.geneticAlgorithm(0, 19, config);
+			++cases;
+			failures += !is_consistent_path(graph, first, 0, 19) || first.second < 0 || first != second;
+		}
+		return report("selection", cases, failures);
+	}
+}
+
+#endif
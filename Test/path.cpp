@@ -1,6 +1,8 @@
 ﻿#include "pch.hpp"
 #include "data.cpp"
 #include "file_io.cpp"
+#include "bench.hpp"
+#include "check.hpp"
 #include <random>
 
 using namespace std;
@@ -73,5 +75,39 @@ int main() {
         return 1;
     }
 
+    // 正确性检查
+    if (!check::check_value_ranges() || !check::check_parse_errors() || !check::check_writer()
+        || !check::check_vertex_ids() || !check::check_snapshot()
+        || !check::check_shortest_paths() || !check::check_astar_geometric() || !check::check_queue_policies()
+        || !check::check_landmarks() || !check::check_contraction_hierarchy() || !check::check_hub_labels()
+        || !check::check_distance_table() || !check::check_shortest_path_tree()
+        || !check::check_delta_stepping() || !check::check_all_pairs() || !check::check_annealing()
+        || !check::check_parallel_tempering() || !check::check_island_genetic()
+        || !check::check_genetic_operators() || !check::check_selection()) {
+        return 1;
+    }
+
+    // 性能基准测试
+    bench::bench_dense_matrix();
+    bench::bench_dense_matrix(300, 100, 200);
+    bench::bench_parser();
+    bench::bench_parallel_load();
+    bench::bench_writer();
+    bench::bench_astar();
+    bench::bench_alt();
+    bench::bench_ch();
+    bench::bench_hub_labels();
+    bench::bench_distance_table();
+    bench::bench_shortest_path_tree();
+    bench::bench_delta_stepping();
+    bench::bench_all_pairs();
+    bench::bench_annealing();
+    bench::bench_parallel_tempering();
+    bench::bench_island_genetic();
+    bench::bench_population();
+    bench::bench_selection();
+    bench::bench_heap();
+    bench::bench_queues();
+
     return 0;
 }
\ No newline at end of file
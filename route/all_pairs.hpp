@@ -0,0 +1,229 @@
+﻿// Purpose: 分块 Floyd–Warshall 全源最短路径，min-plus 内核以 AVX2 / AVX-512 向量化
+// Author:  Cmixed
+#pragma once
+
+#ifndef ALL_PAIRS_HPP
+#define ALL_PAIRS_HPP
+
+#include "pch.hpp"
+#include "data.hpp"
+#include "simd.hpp"
+
+namespace route::all_pairs
+{
+	/*****************************************************************
+	 *
+	 *		分块 Floyd–Warshall
+	 *
+	 *****************************************************************/
+
+	inline constexpr int block = 64; ///< 分块边长：64 × 64 的 int64 块为 32 KiB，三块可同时留在 L2 中
+
+	/// min-plus 内核的指令集，solve 开始时按 CPU 选择一次
+	enum class Kernel : std::uint_fast8_t
+	{
+		Scalar = 0,
+		Avx2,
+		Avx512, ///< AVX-512 F + VL
+	};
+
+	/// 当前 CPU 可用的最宽内核
+	inline Kernel select_kernel() noexcept
+	{
+		return simd::has_avx512() ? Kernel::Avx512 : simd::has_avx2() ? Kernel::Avx2 : Kernel::Scalar;
+	}
+
+#if ROUTE_SIMD_X86
+	/**
+	 * @brief min_plus_row 的 AVX-512 部分，每次 8 个元素，以掩码写回变小的距离与下一跳；返回处理的元素数。
+	 */
+	template <typename V>
+	ROUTE_TARGET_AVX512
+	inline int min_plus_avx512(std::int64_t* const c, V* const hops, std::int64_t const* const b, std::int64_t const a,
+	                           V const hop, int const count) noexcept
+	{
+		__m512i const av = _mm512_set1_epi64(a);
+		__m256i const hv = _mm256_set1_epi32(static_cast<int>(hop));
+		int j = 0;
+		for (; j + 8 <= count; j += 8) {
+			__m512i const sum = _mm512_add_epi64(av, _mm512_loadu_si512(b + j));
+			__mmask8 const less = _mm512_cmplt_epi64_mask(sum, _mm512_loadu_si512(c + j));
+			_mm512_mask_storeu_epi64(c + j, less, sum);
+			_mm256_mask_storeu_epi32(hops + j, less, hv);
+		}
+		return j;
+	}
+
+	/**
+	 * @brief min_plus_row 的 AVX2 部分，每次 4 个元素，整组都不变小时跳过写回；返回处理的元素数。
+	 */
+	template <typename V>
+	ROUTE_TARGET_AVX2
+	inline int min_plus_avx2(std::int64_t* const c, V* const hops, std::int64_t const* const b, std::int64_t const a,
+	                         V const hop, int const count) noexcept
+	{
+		__m256i const av = _mm256_set1_epi64x(a);
+		__m128i const hv = _mm_set1_epi32(static_cast<int>(hop));
+		__m256i const narrow = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+		int j = 0;
+		for (; j + 4 <= count; j += 4) {
+			auto* const cj = reinterpret_cast<__m256i*>(c + j);
+			__m256i const sum = _mm256_add_epi64(av, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + j)));
+			__m256i const current = _mm256_loadu_si256(cj);
+			__m256i const less = _mm256_cmpgt_epi64(current, sum);
+			if (_mm256_testz_si256(less, less)) {
+				continue;
+			}
+			_mm256_storeu_si256(cj, _mm256_blendv_epi8(current, sum, less));
+			// 64 位比较掩码取每个元素的低 32 位，作为 4 个下一跳的掩码
+			__m128i const mask = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(less, narrow));
+			auto* const hj = reinterpret_cast<__m128i*>(hops + j);
+			_mm_storeu_si128(hj, _mm_blendv_epi8(_mm_loadu_si128(hj), hv, mask));
+		}
+		return j;
+	}
+#endif
+
+	/**
+	 * @brief 对一行做 min-plus 更新：c[j] = min(c[j], a + b[j])，变小的位置下一跳记为 hop。
+	 *
+	 * count 为 8 的倍数。距离为 int64、顶点编号为 32 位时按 kernel 使用 AVX-512 或 AVX2，否则为标量循环。
+	 * 只在严格变小时更新，结果与向量宽度无关。
+	 */
+	template <typename Distance, typename V>
+	inline void min_plus_row(Distance* const c, V* const hops, Distance const* const b, Distance const a, V const hop,
+	                         int const count, Kernel const kernel) noexcept
+	{
+		int j = 0;
+		if constexpr (std::is_same_v<Distance, std::int64_t> && sizeof(V) == 4) {
+#if ROUTE_SIMD_X86
+			if (kernel == Kernel::Avx512) {
+				j = min_plus_avx512(c, hops, b, a, hop, count);
+			} else if (kernel == Kernel::Avx2) {
+				j = min_plus_avx2(c, hops, b, a, hop, count);
+			}
+#endif
+		}
+		for (; j < count; ++j) {
+			Distance const sum = a + b[j];
+			if (sum < c[j]) {
+				c[j] = sum;
+				hops[j] = hop;
+			}
+		}
+	}
+
+	/**
+	 * @brief 以块 (bi, kb) 与块 (kb, bj) 更新块 (bi, bj)。
+	 *
+	 * k 在最外层，因此块与 (bi, kb) 或 (kb, bj) 重合时（对角块与同行、同列的块）仍然正确：
+	 * 第 k 轮中第 k 行与第 k 列不会改变（dist(k, k) = 0）。列范围补齐到 8 的倍数，补齐的列为无穷大。
+	 */
+	template <typename Distance, typename V>
+	inline void relax_block(DenseMatrix<Distance>& dist, DenseMatrix<V>& next, int const bi, int const bj, int const kb,
+	                        Distance const infinity, Kernel const kernel) noexcept
+	{
+		int const n = dist.size();
+		int const rows = std::min(n, (bi + 1) * block);
+		int const k_last = std::min(n, (kb + 1) * block);
+		int const j0 = bj * block;
+		int const width = std::min((n + 7) / 8 * 8, j0 + block) - j0;
+		for (int k = kb * block; k < k_last; ++k) {
+			Distance const* const b = dist.row(k) + j0;
+			for (int i = bi * block; i < rows; ++i) {
+				Distance const a = dist(i, k);
+				if (a >= infinity) {
+					continue;
+				}
+				min_plus_row(dist.row(i) + j0, next.row(i) + j0, b, a, next(i, k), width, kernel);
+			}
+		}
+	}
+
+	/**
+	 * @brief 分块 Floyd–Warshall
+	 *
+	 * 矩阵按 block × block 分块，第 kb 轮依次：
+	 *  1. 对角块 (kb, kb) 自身做 Floyd–Warshall；
+	 *  2. 第 kb 行与第 kb 列的块只依赖对角块，互相独立；
+	 *  3. 其余块只依赖同行的列块与同列的行块，互相独立。
+	 * 2、3 两步的块在线程间交错分配，各步之间以屏障同步。next(i, j) 为 i 到 j 的最短路径上 i 之后的顶点，
+	 * 只在严格变短时更新，结果与线程数无关。
+	 *
+	 * 空间为 n² 个距离加 n² 个顶点编号（4096 个顶点约 192 MiB），适用于数千个顶点以内的图。
+	 *
+	 * @param graph 图，需已 finalize
+	 * @param threads 线程数，0 表示使用全部硬件线程
+	 * @return 全源距离与下一跳矩阵
+	 */
+	template <typename V, typename W>
+	inline auto solve(WeightedAdjMatrixGraph<V, W> const& graph, unsigned threads) -> AllPairsMatrix<V, W>
+	{
+		using Matrix = AllPairsMatrix<V, W>;
+		using Distance = typename Matrix::Distance;
+		constexpr Distance infinity = Matrix::infinity;
+		int const n = graph.vertexCount();
+
+		DenseMatrix<Distance> dist(n, infinity);
+		DenseMatrix<V> next(n, GraphTraits<V, W>::invalid_vertex);
+		for (int u = 0; u < n; ++u) {
+			dist(u, u) = 0;
+			next(u, u) = static_cast<V>(u);
+			graph.forEachNeighbor(static_cast<V>(u), [&](V const v, W const weight)
+			{
+				if (static_cast<Distance>(weight) < dist(u, v)) {
+					dist(u, v) = weight;
+					next(u, v) = v;
+				}
+			});
+		}
+
+		Kernel const kernel = select_kernel();
+		int const blocks = (n + block - 1) / block;
+		if (threads == 0) {
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		threads = static_cast<unsigned>(std::clamp((blocks - 1) * (blocks - 1), 1, static_cast<int>(threads)));
+
+		std::barrier sync(static_cast<std::ptrdiff_t>(threads));
+		auto const worker = [&](unsigned const t)
+		{
+			for (int kb = 0; kb < blocks; ++kb) {
+				if (t == 0) {
+					relax_block(dist, next, kb, kb, kb, infinity, kernel);
+				}
+				sync.arrive_and_wait();
+
+				// 第 kb 行与第 kb 列：编号 m < blocks - 1 为行块，其余为列块
+				for (int m = static_cast<int>(t); m < 2 * (blocks - 1); m += static_cast<int>(threads)) {
+					int const other = m % (blocks - 1) >= kb ? m % (blocks - 1) + 1 : m % (blocks - 1);
+					if (m < blocks - 1) {
+						relax_block(dist, next, kb, other, kb, infinity, kernel);
+					}
+					else {
+						relax_block(dist, next, other, kb, kb, infinity, kernel);
+					}
+				}
+				sync.arrive_and_wait();
+
+				for (int m = static_cast<int>(t); m < (blocks - 1) * (blocks - 1); m += static_cast<int>(threads)) {
+					int const bi = m / (blocks - 1), bj = m % (blocks - 1);
+					relax_block(dist, next, bi >= kb ? bi + 1 : bi, bj >= kb ? bj + 1 : bj, kb, infinity, kernel);
+				}
+				sync.arrive_and_wait();
+			}
+		};
+
+		std::vector<std::future<void>> futures;
+		futures.reserve(threads);
+		for (unsigned t = 0; t < threads; ++t) {
+			futures.emplace_back(std::async(std::launch::async, worker, t));
+		}
+		for (auto& future : futures) {
+			future.get();
+		}
+		return {std::move(dist), std::move(next)};
+	}
+}
+
+#endif
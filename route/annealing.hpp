@@ -0,0 +1,365 @@
+﻿// Purpose: 模拟退火的路径邻域操作：原地 O(1) 评估，接受后才修改路径
+// Author:  Cmixed
+#pragma once
+
+#ifndef ANNEALING_HPP
+#define ANNEALING_HPP
+
+#include "pch.hpp"
+#include "data.hpp"
+
+namespace route::annealing
+{
+	/*****************************************************************
+	 *
+	 *		PathAnnealer 类
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 邻域操作的种类
+	 */
+	enum class MoveKind : std::uint_fast8_t
+	{
+		Swap = 0, ///< 交换位置 i 与 j 上的顶点
+		Reverse, ///< 反转位置 [i, j] 的一段
+		Insert, ///< 把从 i 开始的 length 个顶点移到位置 j 与 j + 1 之间
+	};
+
+	/**
+	 * @brief 一次候选操作及其代价变化
+	 */
+	struct Move {
+	    MoveKind kind{MoveKind::Swap};
+	    int i{0};
+	    int j{0};
+	    int length{1};
+	    std::int64_t delta{0}; ///< 操作后路径代价减去操作前的代价
+	};
+
+	/**
+	 * @brief 固定首尾的路径上的模拟退火
+	 *
+	 * 路径首尾两个顶点保持不动，中间的顶点可以通过三种操作重排：
+	 *  - Swap：交换两个顶点，只涉及它们两侧的至多 4 条边；
+	 *  - Reverse（2-opt）：反转一段，对称图只有两端的 2 条边变化，有向图还需累加段内边的反向差值；
+	 *  - Insert（or-opt）：把 1 ~ 3 个连续顶点按原方向移到别处，涉及 3 条边。
+	 * propose 只读取候选操作相邻的边计算 delta，不修改路径；apply 才真正修改。
+	 * 路径与最优路径的缓冲区在构造时分配，之后的迭代不再分配内存。
+	 * 随机数取自生成器的原始输出，以乘法映射到区间，省去分布对象的拒绝采样；
+	 * 64 位生成器（如 std::mt19937_64）的每次输出拆成两个 32 位随机数使用。
+	 *
+	 * @tparam Vertex 顶点编号类型
+	 * @tparam CostFn 代价函数 (Vertex, Vertex) -> std::int64_t，不存在的边应返回足够大的惩罚值
+	 */
+	template <typename Vertex, typename CostFn>
+	class PathAnnealer
+	{
+	public:
+	    /**
+	     * @param path 初始路径，首尾固定
+	     * @param cost 边代价
+	     * @param symmetric cost(a, b) 是否总等于 cost(b, a)
+	     * @param config 三种操作的比例取自其中的权重
+	     */
+	    PathAnnealer(std::vector<Vertex> path, CostFn cost, bool const symmetric, AnnealingConfig const& config)
+	        : m_path(std::move(path)), m_best(m_path), m_cost(std::move(cost)), m_symmetric(symmetric)
+	    {
+	        for (std::size_t k = 0; k + 1 < m_path.size(); ++k) {
+	            m_current += m_cost(m_path[k], m_path[k + 1]);
+	        }
+	        m_bestCost = m_current;
+
+	        double const swap = std::max(config.swap_weight, 0.0);
+	        double const reverse = std::max(config.reverse_weight, 0.0);
+	        double const insert = std::max(config.insert_weight, 0.0);
+	        double const total = swap + reverse + insert;
+	        m_swapShare = total > 0.0 ? swap / total : 1.0;
+	        m_reverseShare = total > 0.0 ? (swap + reverse) / total : 1.0;
+	    }
+
+	    /// 可移动的顶点不少于 2 个时才有可用的操作
+	    [[nodiscard]] bool movable() const noexcept { return m_path.size() >= 4; }
+
+	    [[nodiscard]] std::int64_t cost() const noexcept { return m_current; }
+	    [[nodiscard]] std::int64_t bestCost() const noexcept { return m_bestCost; }
+	    [[nodiscard]] std::vector<Vertex> const& path() const noexcept { return m_path; }
+	    [[nodiscard]] std::vector<Vertex> const& bestPath() const noexcept { return m_best; }
+
+	    /**
+	     * @brief 随机生成一个候选操作并计算 delta，路径保持不变。需 movable()。
+	     */
+	    template <typename Rng>
+	    [[nodiscard]] Move propose(Rng& rng)
+	    {
+	        int const last = static_cast<int>(m_path.size()) - 2; // 可移动的位置为 [1, last]
+	        // 只有一种操作时不必抽取
+	        double const pick = m_swapShare >= 1.0 ? 0.0 : unit(rng);
+	        Move move;
+	        if (pick < m_reverseShare) {
+	            move.kind = pick < m_swapShare ? MoveKind::Swap : MoveKind::Reverse;
+	            move.i = position(rng, 1, last);
+	            move.j = position(rng, 1, last - 1);
+	            if (move.j >= move.i) {
+	                ++move.j;
+	            }
+	            else {
+	                std::swap(move.i, move.j);
+	            }
+	            move.delta = move.kind == MoveKind::Swap ? swap_delta(move.i, move.j) : reverse_delta(move.i, move.j);
+	        }
+	        else {
+	            move.kind = MoveKind::Insert;
+	            move.length = position(rng, 1, std::min(3, last - 1));
+	            move.i = position(rng, 1, last - move.length + 1);
+	            // 插入点 j ∈ [0, last]，排除 [i - 1, i + length - 1]
+	            int const r = position(rng, 0, last - move.length - 1);
+	            move.j = r < move.i - 1 ? r : r + move.length + 1;
+	            move.delta = insert_delta(move.i, move.length, move.j);
+	        }
+	        return move;
+	    }
+
+	    /**
+	     * @brief 执行操作，并在代价低于历史最优时更新最优路径。
+	     */
+	    void apply(Move const& move)
+	    {
+	        auto const path = m_path.begin();
+	        switch (move.kind) {
+	        case MoveKind::Swap:
+	            std::swap(m_path[move.i], m_path[move.j]);
+	            break;
+	        case MoveKind::Reverse:
+	            std::reverse(path + move.i, path + move.j + 1);
+	            break;
+	        case MoveKind::Insert:
+	            if (move.j > move.i) {
+	                std::rotate(path + move.i, path + move.i + move.length, path + move.j + 1);
+	            }
+	            else {
+	                std::rotate(path + move.j + 1, path + move.i, path + move.i + move.length);
+	            }
+	            break;
+	        }
+	        m_current += move.delta;
+	        if (m_current < m_bestCost) {
+	            m_bestCost = m_current;
+	            std::ranges::copy(m_path, m_best.begin());
+	        }
+	    }
+
+	    /**
+	     * @brief 一次 Metropolis 迭代：生成候选操作，按温度决定是否接受。
+	     * @return 是否接受
+	     */
+	    template <typename Rng>
+	    bool step(double const temperature, Rng& rng)
+	    {
+	        Move const move = propose(rng);
+	        // exp(-40) 以下的接受概率可以忽略，省去 exp 与一次随机数
+	        if (move.delta <= 0 || (static_cast<double>(move.delta) < 40.0 * temperature
+	                                && unit(rng) < std::exp(-static_cast<double>(move.delta) / temperature))) {
+	            apply(move);
+	            return true;
+	        }
+	        return false;
+	    }
+
+	private:
+	    /// 32 位随机数
+	    template <typename Rng>
+	    std::uint32_t bits(Rng& rng)
+	    {
+	        if constexpr (Rng::max() - Rng::min() >= std::numeric_limits<std::uint64_t>::max()) {
+	            if (m_spare) {
+	                m_spare = false;
+	                return static_cast<std::uint32_t>(m_bits >> 32);
+	            }
+	            m_bits = rng();
+	            m_spare = true;
+	            return static_cast<std::uint32_t>(m_bits);
+	        }
+	        else {
+	            return static_cast<std::uint32_t>(rng());
+	        }
+	    }
+
+	    /// [low, high] 中的整数
+	    template <typename Rng>
+	    int position(Rng& rng, int const low, int const high)
+	    {
+	        auto const range = static_cast<std::uint64_t>(high - low + 1);
+	        return low + static_cast<int>((static_cast<std::uint64_t>(bits(rng)) * range) >> 32);
+	    }
+
+	    /// [0, 1) 中的实数
+	    template <typename Rng>
+	    double unit(Rng& rng)
+	    {
+	        return static_cast<double>(bits(rng)) * 0x1p-32;
+	    }
+
+	    [[nodiscard]] std::int64_t edge(int const a, int const b) const { return m_cost(m_path[a], m_path[b]); }
+
+	    /// 交换位置 i < j 上的顶点
+	    [[nodiscard]] std::int64_t swap_delta(int const i, int const j) const
+	    {
+	        Vertex const a = m_path[i], b = m_path[j];
+	        if (j == i + 1) {
+	            Vertex const before = m_path[i - 1], after = m_path[j + 1];
+	            return m_cost(before, b) + m_cost(b, a) + m_cost(a, after)
+	                - m_cost(before, a) - m_cost(a, b) - m_cost(b, after);
+	        }
+	        return m_cost(m_path[i - 1], b) + m_cost(b, m_path[i + 1]) + m_cost(m_path[j - 1], a) + m_cost(a, m_path[j + 1])
+	            - edge(i - 1, i) - edge(i, i + 1) - edge(j - 1, j) - edge(j, j + 1);
+	    }
+
+	    /// 反转位置 [i, j]
+	    [[nodiscard]] std::int64_t reverse_delta(int const i, int const j) const
+	    {
+	        std::int64_t delta = m_cost(m_path[i - 1], m_path[j]) + m_cost(m_path[i], m_path[j + 1])
+	            - edge(i - 1, i) - edge(j, j + 1);
+	        if (!m_symmetric) {
+	            for (int k = i; k < j; ++k) {
+	                delta += edge(k + 1, k) - edge(k, k + 1);
+	            }
+	        }
+	        return delta;
+	    }
+
+	    /// 把 [i, i + length) 移到位置 j 与 j + 1 之间
+	    [[nodiscard]] std::int64_t insert_delta(int const i, int const length, int const j) const
+	    {
+	        int const e = i + length - 1;
+	        return edge(i - 1, e + 1) + edge(j, i) + edge(e, j + 1)
+	            - edge(i - 1, i) - edge(e, e + 1) - edge(j, j + 1);
+	    }
+
+	    std::vector<Vertex> m_path; ///< 当前路径
+	    std::vector<Vertex> m_best; ///< 历史最优路径
+	    CostFn m_cost;
+	    bool m_symmetric;
+	    std::int64_t m_current{0}; ///< 当前路径的代价
+	    std::int64_t m_bestCost{0}; ///< 历史最优代价
+	    double m_swapShare{1.0}; ///< 随机数低于此值时选 Swap
+	    double m_reverseShare{1.0}; ///< 随机数低于此值（且不低于 m_swapShare）时选 Reverse，否则 Insert
+	    std::uint64_t m_bits{0}; ///< 64 位生成器上一次输出中未使用的高 32 位
+	    bool m_spare{false};
+	};
+
+	/*****************************************************************
+	 *
+	 *		并行回火
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 并行回火（副本交换）
+	 *
+	 * 每个温度上一条 PathAnnealer 链，链各自持有随机数生成器（由种子与链编号派生）。每一轮中，
+	 * 各线程负责交错分配的若干温度，对其上的链做 exchange_interval 次固定温度的 Metropolis 迭代；
+	 * 所有线程到达屏障后，由屏障的完成函数依次尝试交换相邻温度上的链（奇偶轮交替），
+	 * 交换概率为 min(1, exp((1/T_k - 1/T_{k+1}) × (E_k - E_{k+1})))，交换的只是温度到链的映射，不复制路径。
+	 * 全局最优代价保存在一个原子变量中，各链每轮结束时以 CAS 取最小值更新，达到 target 即停止。
+	 * 结果只取决于种子与参数，与线程数无关。
+	 *
+	 * @param initial 初始路径，所有链从它出发
+	 * @param cost 边代价，见 PathAnnealer
+	 * @param symmetric cost 是否对称
+	 * @param config 副本、温度与交换参数
+	 * @return 全局最优路径，以及按温度升序的统计
+	 */
+	template <typename Vertex, typename CostFn>
+	inline auto parallel_tempering(std::vector<Vertex> initial, CostFn const& cost, bool const symmetric,
+	                               TemperingConfig const& config)
+		-> std::pair<std::vector<Vertex>, std::vector<ReplicaStats>>
+	{
+		unsigned const hardware = std::max(1u, std::thread::hardware_concurrency());
+		int const replicas = config.replicas > 0 ? config.replicas : static_cast<int>(std::max(2u, hardware));
+		unsigned const threads = std::min(config.threads > 0 ? config.threads : hardware, static_cast<unsigned>(replicas));
+		std::int64_t const interval = std::max(1, config.exchange_interval);
+		std::int64_t const rounds = std::max<std::int64_t>(1, (config.iterations + interval - 1) / interval);
+		std::uint32_t const seed = config.moves.seed != 0 ? config.moves.seed : std::random_device{}();
+
+		std::vector<ReplicaStats> stats(replicas);
+		double const ratio = config.max_temperature / config.min_temperature;
+		for (int k = 0; k < replicas; ++k) {
+			stats[k].temperature = replicas == 1 ? config.min_temperature
+			                                     : config.min_temperature * std::pow(ratio, k / (replicas - 1.0));
+		}
+
+		std::vector<PathAnnealer<Vertex, CostFn>> chains;
+		std::vector<std::mt19937_64> engines;
+		chains.reserve(replicas);
+		engines.reserve(replicas);
+		for (int k = 0; k < replicas; ++k) {
+			chains.emplace_back(initial, cost, symmetric, config.moves);
+			std::seed_seq sequence{seed, static_cast<std::uint32_t>(k)};
+			engines.emplace_back(sequence);
+		}
+		std::vector<int> chain_at(replicas); ///< 第 k 个温度上的链
+		std::iota(chain_at.begin(), chain_at.end(), 0);
+
+		std::atomic<std::int64_t> best{chains[0].bestCost()};
+		std::seed_seq sequence{seed, static_cast<std::uint32_t>(replicas)};
+		std::mt19937_64 exchange_rng(sequence);
+		std::int64_t round = 0;
+		bool stop = best.load(std::memory_order_relaxed) <= config.target || !chains[0].movable();
+
+		auto const exchange = [&]() noexcept
+		{
+			for (int k = static_cast<int>(round % 2); k + 1 < replicas; k += 2) {
+				auto const energy = [&](int const slot) { return static_cast<double>(chains[chain_at[slot]].cost()); };
+				double const x = (1.0 / stats[k].temperature - 1.0 / stats[k + 1].temperature) * (energy(k) - energy(k + 1));
+				++stats[k].exchanges_attempted;
+				if (x >= 0.0 || std::uniform_real_distribution<double>(0.0, 1.0)(exchange_rng) < std::exp(x)) {
+					std::swap(chain_at[k], chain_at[k + 1]);
+					++stats[k].exchanges_accepted;
+				}
+			}
+			++round;
+			stop = round >= rounds || best.load(std::memory_order_relaxed) <= config.target;
+		};
+
+		std::barrier sync(static_cast<std::ptrdiff_t>(threads), exchange);
+		auto const worker = [&](unsigned const t)
+		{
+			while (!stop) {
+				std::int64_t const steps = std::min(interval, config.iterations - round * interval);
+				for (int k = static_cast<int>(t); k < replicas; k += static_cast<int>(threads)) {
+					auto& chain = chains[chain_at[k]];
+					auto& engine = engines[chain_at[k]];
+					double const temperature = stats[k].temperature;
+					for (std::int64_t i = 0; i < steps; ++i) {
+						stats[k].accepted += chain.step(temperature, engine);
+					}
+					stats[k].proposed += steps;
+
+					std::int64_t known = best.load(std::memory_order_relaxed);
+					while (chain.bestCost() < known
+						&& !best.compare_exchange_weak(known, chain.bestCost(), std::memory_order_relaxed)) {
+					}
+				}
+				sync.arrive_and_wait();
+			}
+		};
+
+		std::vector<std::future<void>> futures;
+		futures.reserve(threads);
+		for (unsigned t = 0; t < threads; ++t) {
+			futures.emplace_back(std::async(std::launch::async, worker, t));
+		}
+		for (auto& future : futures) {
+			future.get();
+		}
+
+		for (int k = 0; k < replicas; ++k) {
+			stats[k].cost = chains[chain_at[k]].cost();
+		}
+		auto const winner = std::ranges::min_element(chains, {}, [](auto const& chain) { return chain.bestCost(); });
+		return {winner->bestPath(), std::move(stats)};
+	}
+}
+
+#endif
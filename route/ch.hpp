@@ -0,0 +1,459 @@
+﻿// Purpose: 收缩层次（Contraction Hierarchies）的预处理与查询
+// Author:  Cmixed
+#pragma once
+
+#ifndef CH_HPP
+#define CH_HPP
+
+#include "pch.hpp"
+#include "data.hpp"
+#include "heap.hpp"
+#include "landmark.hpp"
+
+namespace route
+{
+	/*****************************************************************
+	 *
+	 *		ContractionHierarchy 类
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 收缩层次
+	 *
+	 * 预处理按重要性从低到高依次收缩顶点：收缩 v 时，对每对入邻居 u 与出邻居 w，
+	 * 若见证搜索（witness search，不经过 v 的有限 Dijkstra）找不到不长于 u→v→w 的路径，
+	 * 则添加捷径 u→w 并记录中间顶点 v。顶点顺序由 2 × 边差（新增捷径数 − 删除的边数）、
+	 * 已收缩邻居数与层级（收缩过的邻居的最大层级 + 1）之和决定，按优先队列惰性更新：
+	 * 出队时重新计算，若变大则重新入队。排序用的模拟收缩只用 witness_limit / 10 的搜索上限。
+	 *
+	 * 收缩 v 时其剩余的边都指向更高层的顶点，分别存为上行 CSR（v 的出边）和下行 CSR（指向 v 的入边）。
+	 * 查询从起点沿上行边、从终点沿下行边反向各做一次只向上的 Dijkstra，在两侧都到达的顶点处相遇，
+	 * 并用 stall-on-demand 剪去不可能位于最短上行路径上的顶点。结果路径沿捷径的中间顶点递归展开。
+	 *
+	 * @tparam V 顶点编号类型
+	 * @tparam W 边权重类型
+	 */
+	template <typename V, typename W>
+	class ContractionHierarchy
+	{
+	public:
+		using Graph = WeightedAdjMatrixGraph<V, W>;
+		using Traits = typename Graph::Traits;
+		using VertexId = V;
+		using Distance = typename Graph::Distance;
+		using Path = typename Graph::Path;
+		using PathResult = typename Graph::PathResult;
+
+		/// 层次中的一条边，middle 为捷径的中间顶点，原始边为 invalid_vertex
+		struct Arc {
+		    Distance weight;
+		    VertexId target;
+		    VertexId middle;
+		};
+
+		ContractionHierarchy() = default;
+
+		/**
+		 * @brief 收缩 graph 的全部顶点。
+		 * @param graph 图，需已 finalize
+		 * @param witness_limit 每次见证搜索最多出队的顶点数；越小预处理越快，但捷径越多
+		 */
+		[[nodiscard]] static auto build(Graph const& graph, int witness_limit = 500) -> ContractionHierarchy;
+
+		[[nodiscard]] bool empty() const noexcept { return m_vertices == 0; }
+		[[nodiscard]] int vertexCount() const noexcept { return m_vertices; }
+		[[nodiscard]] bool matches(Graph const& graph) const
+		{
+			return graph.vertexCount() == m_vertices && landmark::fingerprint(graph) == m_fingerprint;
+		}
+		[[nodiscard]] std::size_t shortcutCount() const noexcept { return m_shortcuts; }
+		[[nodiscard]] std::uint32_t rank(VertexId const v) const noexcept { return m_rank[v]; }
+
+		/**
+		 * @brief 双向上行搜索并展开捷径。
+		 * @return 最短路径和距离，不可达时距离为 -1
+		 */
+		[[nodiscard]] auto query(VertexId start, VertexId end, SearchStats* stats = nullptr) const -> PathResult;
+
+	private:
+		[[nodiscard]] std::span<Arc const> up(VertexId const v) const noexcept
+		{
+			return {m_up.data() + m_upOffsets[v], m_up.data() + m_upOffsets[v + 1]};
+		}
+
+		[[nodiscard]] std::span<Arc const> down(VertexId const v) const noexcept
+		{
+			return {m_down.data() + m_downOffsets[v], m_down.data() + m_downOffsets[v + 1]};
+		}
+
+		[[nodiscard]] Arc const& findArc(VertexId from, VertexId to) const;
+		void unpack(VertexId from, VertexId to, Path& path) const;
+
+		int m_vertices{0}; ///< 顶点数
+		std::uint64_t m_fingerprint{0}; ///< 构建时图的边散列
+		std::size_t m_shortcuts{0}; ///< 捷径数
+		std::vector<std::uint32_t> m_rank{}; ///< 收缩顺序，越大越重要
+		std::vector<std::uint32_t> m_upOffsets{}; ///< 上行 CSR 行偏移
+		std::vector<Arc> m_up{}; ///< v 指向更高层顶点的出边
+		std::vector<std::uint32_t> m_downOffsets{}; ///< 下行 CSR 行偏移
+		std::vector<Arc> m_down{}; ///< 更高层顶点指向 v 的入边，target 为边的起点
+
+		template <typename V2, typename W2>
+		friend bool save_contraction_hierarchy(ContractionHierarchy<V2, W2> const& hierarchy, const std::string& filename);
+		template <typename V2, typename W2>
+		friend std::optional<ContractionHierarchy<V2, W2>> load_contraction_hierarchy(
+			WeightedAdjMatrixGraph<V2, W2> const& graph, const std::string& filename);
+	};
+
+	using WContractionHierarchy = ContractionHierarchy<WGraph::VertexId, WGraph::Weight>;
+
+	template <typename V, typename W>
+	inline auto ContractionHierarchy<V, W>::build(Graph const& graph, int const witness_limit) -> ContractionHierarchy
+	{
+		constexpr Distance infinity = std::numeric_limits<Distance>::max();
+		constexpr VertexId invalid = Traits::invalid_vertex;
+		int const n = graph.vertexCount();
+
+		// 收缩过程中的动态邻接表，每个方向上每对顶点至多保留一条最短的边
+		std::vector<std::vector<Arc>> out(n), in(n);
+
+		// 将 additions 合并到 arcs：目标已存在时保留较短的一条（相等时保留原有的），否则追加；返回新增的边数。
+		// position 记录 arcs 中各目标的下标，合并结束时复原，单次合并为 O(|arcs| + |additions|)
+		constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+		std::vector<std::uint32_t> position(n, npos);
+		auto const merge = [&position](std::vector<Arc>& arcs, std::span<Arc const> const additions)
+		{
+			for (std::size_t i = 0; i < arcs.size(); ++i) {
+				position[arcs[i].target] = static_cast<std::uint32_t>(i);
+			}
+			std::size_t added = 0;
+			for (Arc const& arc : additions) {
+				if (std::uint32_t& at = position[arc.target]; at == npos) {
+					at = static_cast<std::uint32_t>(arcs.size());
+					arcs.push_back(arc);
+					++added;
+				} else if (arc.weight < arcs[at].weight) {
+					arcs[at] = arc;
+				}
+			}
+			for (Arc const& arc : arcs) {
+				position[arc.target] = npos;
+			}
+			return added;
+		};
+
+		std::vector<Arc> additions;
+		for (int u = 0; u < n; ++u) {
+			additions.clear();
+			graph.forEachNeighbor(static_cast<VertexId>(u), [&](VertexId const v, W const weight)
+			{
+				if (static_cast<int>(v) != u) {
+					additions.push_back({static_cast<Distance>(weight), v, invalid});
+				}
+			});
+			merge(out[u], additions);
+			for (Arc const& arc : out[u]) {
+				in[arc.target].push_back({arc.weight, static_cast<VertexId>(u), invalid});
+			}
+		}
+
+		// 见证搜索：从 source 出发、不经过 skip，目标（target[x] == stamp）全部出队、
+		// 键值超过 limit 或出队数达到 settle_limit 时停止
+		std::vector<Distance> dist(n, infinity);
+		std::vector<VertexId> touched;
+		std::vector<std::uint32_t> target(n, 0);
+		std::uint32_t stamp = 0;
+		IndexedHeap<Distance> heap(n);
+		auto const witness = [&](VertexId const source, VertexId const skip, Distance const limit, int remaining,
+		                         int const settle_limit)
+		{
+			for (VertexId const v : touched) {
+				dist[v] = infinity;
+			}
+			touched.clear();
+			heap.clear();
+			dist[source] = 0;
+			touched.push_back(source);
+			heap.pushOrDecrease(static_cast<std::uint32_t>(source), 0);
+			for (int settled = 0; !heap.empty() && settled < settle_limit; ++settled) {
+				auto const [d, x] = heap.pop();
+				if (d > limit || (target[x] == stamp && --remaining == 0)) {
+					break;
+				}
+				for (Arc const& arc : out[x]) {
+					if (arc.target == skip) {
+						continue;
+					}
+					if (Distance const candidate = d + arc.weight; candidate < dist[arc.target]) {
+						if (dist[arc.target] == infinity) {
+							touched.push_back(arc.target);
+						}
+						dist[arc.target] = candidate;
+						heap.pushOrDecrease(static_cast<std::uint32_t>(arc.target), candidate);
+					}
+				}
+			}
+		};
+
+		// 收缩 v 需要的捷径，apply 为 false 时只计数；计数用于排序，使用更小的搜索上限即可。
+		// u 的新出边在处理下一个入邻居之前合并（之后的见证搜索会用到），新入边按 w 分组在最后合并
+		int const simulate_limit = std::max(1, witness_limit / 10);
+		ContractionHierarchy hierarchy;
+		std::vector<std::pair<VertexId, Arc>> incoming_shortcuts;
+		auto const contract = [&](VertexId const v, bool const apply)
+		{
+			int shortcuts = 0;
+			incoming_shortcuts.clear();
+			for (Arc const& incoming : in[v]) {
+				VertexId const u = incoming.target;
+				Distance limit = 0;
+				int targets = 0;
+				++stamp;
+				for (Arc const& outgoing : out[v]) {
+					if (outgoing.target != u) {
+						limit = std::max(limit, incoming.weight + outgoing.weight);
+						target[outgoing.target] = stamp;
+						++targets;
+					}
+				}
+				if (targets == 0) {
+					continue;
+				}
+				witness(u, v, limit, targets, apply ? witness_limit : simulate_limit);
+				additions.clear();
+				for (Arc const& outgoing : out[v]) {
+					VertexId const w = outgoing.target;
+					Distance const via = incoming.weight + outgoing.weight;
+					if (w == u || dist[w] <= via) {
+						continue;
+					}
+					++shortcuts;
+					if (apply) {
+						additions.push_back({via, w, v});
+						incoming_shortcuts.emplace_back(w, Arc{via, u, v});
+					}
+				}
+				if (!additions.empty()) {
+					hierarchy.m_shortcuts += merge(out[u], additions);
+				}
+			}
+
+			// 稳定排序保持同一 w 的捷径的产生顺序，与逐条插入时相等权重的取舍一致
+			std::ranges::stable_sort(incoming_shortcuts, {}, &std::pair<VertexId, Arc>::first);
+			for (std::size_t first = 0; first < incoming_shortcuts.size(); ) {
+				VertexId const w = incoming_shortcuts[first].first;
+				additions.clear();
+				for (; first < incoming_shortcuts.size() && incoming_shortcuts[first].first == w; ++first) {
+					additions.push_back(incoming_shortcuts[first].second);
+				}
+				merge(in[w], additions);
+			}
+			return shortcuts;
+		};
+
+		std::vector<int> contracted_neighbors(n, 0);
+		std::vector<int> level(n, 0);
+		std::vector<VertexId> neighbors;
+		auto const priority = [&](VertexId const v)
+		{
+			int const difference = contract(v, false) - static_cast<int>(in[v].size() + out[v].size());
+			return 2 * difference + contracted_neighbors[v] + level[v];
+		};
+
+		IndexedHeap<int> queue(n);
+		for (int v = 0; v < n; ++v) {
+			queue.pushOrDecrease(static_cast<std::uint32_t>(v), priority(static_cast<VertexId>(v)));
+		}
+
+		hierarchy.m_vertices = n;
+		hierarchy.m_fingerprint = landmark::fingerprint(graph);
+		hierarchy.m_rank.assign(n, 0);
+		std::uint32_t next_rank = 0;
+		while (!queue.empty()) {
+			auto const v = static_cast<VertexId>(queue.pop().index);
+			if (int const current = priority(v); !queue.empty() && current > queue.top().key) {
+				queue.pushOrDecrease(static_cast<std::uint32_t>(v), current);
+				continue;
+			}
+
+			contract(v, true);
+			hierarchy.m_rank[v] = next_rank++;
+
+			// 从剩余图中摘除 v，v 自身的邻接表从此固定，成为层次中的上行 / 下行边
+			auto const erase = [v](std::vector<Arc>& arcs)
+			{
+				std::erase_if(arcs, [v](Arc const& arc) { return arc.target == v; });
+			};
+			for (Arc const& arc : out[v]) {
+				erase(in[arc.target]);
+			}
+			for (Arc const& arc : in[v]) {
+				erase(out[arc.target]);
+			}
+
+			// 邻居的优先级不立即重算，出队时再惰性检查
+			neighbors.clear();
+			for (auto const* arcs : {&out[v], &in[v]}) {
+				for (Arc const& arc : *arcs) {
+					neighbors.push_back(arc.target);
+				}
+			}
+			std::ranges::sort(neighbors);
+			neighbors.erase(std::ranges::unique(neighbors).begin(), neighbors.end());
+			for (VertexId const w : neighbors) {
+				++contracted_neighbors[w];
+				level[w] = std::max(level[w], level[v] + 1);
+			}
+		}
+
+		auto const flatten = [n](std::vector<std::vector<Arc>>& lists, std::vector<std::uint32_t>& offsets,
+		                         std::vector<Arc>& arcs)
+		{
+			offsets.assign(static_cast<std::size_t>(n) + 1, 0);
+			for (int v = 0; v < n; ++v) {
+				offsets[v + 1] = offsets[v] + static_cast<std::uint32_t>(lists[v].size());
+			}
+			arcs.reserve(offsets[n]);
+			for (auto& list : lists) {
+				arcs.insert(arcs.end(), list.begin(), list.end());
+				std::vector<Arc>().swap(list);
+			}
+		};
+		flatten(out, hierarchy.m_upOffsets, hierarchy.m_up);
+		flatten(in, hierarchy.m_downOffsets, hierarchy.m_down);
+		return hierarchy;
+	}
+
+	template <typename V, typename W>
+	inline auto ContractionHierarchy<V, W>::query(VertexId const start, VertexId const end, SearchStats* const stats) const
+		-> PathResult
+	{
+		auto const valid = [this](VertexId const v)
+		{
+			return static_cast<std::uint64_t>(v) < static_cast<std::uint64_t>(m_vertices);
+		};
+		if (!valid(start) || !valid(end)) {
+			return {{}, -1};
+		}
+		if (start == end) {
+			return {{start}, 0};
+		}
+
+		using Workspace = SearchWorkspace<Distance, VertexId>;
+		constexpr Distance infinity = Workspace::infinity;
+
+		// 下标 0 为正向上行搜索，1 为反向上行搜索；prev 为正向的前驱或反向的后继
+		std::array<Workspace*, 2> const ws{&thread_workspace<Workspace, 0>(), &thread_workspace<Workspace, 1>()};
+		auto const forward_lease = ws[0]->lease(m_vertices, Traits::invalid_vertex);
+		auto const backward_lease = ws[1]->lease(m_vertices, Traits::invalid_vertex);
+
+		SearchStats local{};
+		SearchStats& counters = stats != nullptr ? *stats : local;
+
+		Distance best = infinity;
+		VertexId meet = Traits::invalid_vertex;
+
+		ws[0]->set(start, 0, Traits::invalid_vertex);
+		ws[1]->set(end, 0, Traits::invalid_vertex);
+		ws[0]->heap.pushOrDecrease(start, 0);
+		ws[1]->heap.pushOrDecrease(end, 0);
+		counters.queue_operations += 2;
+
+		// 每侧在队首距离不小于 best 后停止；两侧都停止时 best 即为最短距离
+		while (true) {
+			bool const forward = !ws[0]->heap.empty() && ws[0]->heap.top().key < best;
+			bool const backward = !ws[1]->heap.empty() && ws[1]->heap.top().key < best;
+			if (!forward && !backward) {
+				break;
+			}
+			int const side = forward && (!backward || ws[0]->heap.top().key <= ws[1]->heap.top().key) ? 0 : 1;
+			Workspace& self = *ws[side];
+			Workspace const& other = *ws[1 - side];
+			auto const [d, index] = self.heap.pop();
+			auto const u = static_cast<VertexId>(index);
+			++counters.queue_operations;
+			++counters.settled;
+
+			if (other.dist[u] != infinity && d + other.dist[u] < best) {
+				best = d + other.dist[u];
+				meet = u;
+			}
+
+			// stall-on-demand：若经由更高层顶点的反向边能以更短距离到达 u，u 不在最短上行路径上
+			auto const stall_arcs = side == 0 ? down(u) : up(u);
+			if (std::ranges::any_of(stall_arcs, [&](Arc const& arc)
+			{
+				return self.dist[arc.target] != infinity && self.dist[arc.target] + arc.weight < d;
+			})) {
+				continue;
+			}
+
+			for (Arc const& arc : side == 0 ? up(u) : down(u)) {
+				if (Distance const candidate = d + arc.weight; candidate < self.dist[arc.target]) {
+					self.set(arc.target, candidate, u);
+					self.heap.pushOrDecrease(arc.target, candidate);
+					++counters.queue_operations;
+					++counters.relaxed;
+				}
+			}
+		}
+
+		if (best == infinity) {
+			return {{}, -1};
+		}
+
+		// 层次中的路径：start ... meet ... end
+		Path hops;
+		for (VertexId at = meet; at != Traits::invalid_vertex; at = ws[0]->prev[at]) {
+			hops.push_back(at);
+		}
+		std::ranges::reverse(hops);
+		for (VertexId at = ws[1]->prev[meet]; at != Traits::invalid_vertex; at = ws[1]->prev[at]) {
+			hops.push_back(at);
+		}
+
+		Path path{start};
+		for (std::size_t i = 0; i + 1 < hops.size(); ++i) {
+			unpack(hops[i], hops[i + 1], path);
+		}
+		return {path, best};
+	}
+
+	/**
+	 * @brief 层次中 from→to 的边：低层指向高层的边存于 from 的上行表，反之存于 to 的下行表。
+	 * @throw std::logic_error 如果层次中没有这条边（查询与捷径展开只会访问存在的边）
+	 */
+	template <typename V, typename W>
+	inline auto ContractionHierarchy<V, W>::findArc(VertexId const from, VertexId const to) const -> Arc const&
+	{
+		auto const arcs = m_rank[from] < m_rank[to] ? up(from) : down(to);
+		VertexId const key = m_rank[from] < m_rank[to] ? to : from;
+		auto const it = std::ranges::find(arcs, key, &Arc::target);
+		if (it == arcs.end()) {
+			throw std::logic_error("收缩层次中缺少要展开的边");
+		}
+		return *it;
+	}
+
+	/**
+	 * @brief 将层次中的边 from→to 展开为原图路径，追加 from 之后的顶点（含 to）。
+	 */
+	template <typename V, typename W>
+	inline void ContractionHierarchy<V, W>::unpack(VertexId const from, VertexId const to, Path& path) const
+	{
+		std::vector<std::pair<VertexId, VertexId>> stack{{from, to}};
+		while (!stack.empty()) {
+			auto const [a, b] = stack.back();
+			stack.pop_back();
+			if (VertexId const middle = findArc(a, b).middle; middle != Traits::invalid_vertex) {
+				stack.emplace_back(middle, b);
+				stack.emplace_back(a, middle);
+			} else {
+				path.push_back(b);
+			}
+		}
+	}
+}
+
+#endif
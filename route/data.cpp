@@ -1,11 +1,147 @@
 ﻿// data 的具体实现
 
 #include "data.hpp"
+#include "ch.hpp"
+#include "hub_label.hpp"
+#include "delta_stepping.hpp"
+#include "all_pairs.hpp"
+#include "annealing.hpp"
+#include "genetic.hpp"
 
 #include "col_zzj.hpp"
 
 namespace route
 {
+	/*****************************************************************
+	 *
+	 *		CsrAdjacency 类 函数实现
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 由有向弧列表构建 CSR 邻接表。
+	 *
+	 * 先按起点做一次稳定的计数排序（O(V + E)），再在每行内按终点稳定排序，
+	 * 最后逐行写入目标顶点与权重并累加行偏移。重复弧保留列表中靠后的一条。
+	 *
+	 * @param vertices 顶点数。
+	 * @param arcs 有向弧列表，端点需在 [0, vertices) 内。
+	 */
+	template <typename V, typename W>
+	inline void CsrAdjacency<V, W>::build(int const vertices, std::vector<Edge<V, W>> arcs)
+	{
+		if (arcs.size() > std::numeric_limits<EdgeIndex>::max()) {
+			throw std::length_error("边数超出 CSR 偏移类型的表示范围");
+		}
+
+		// 按起点计数排序，保持同一起点内的先后次序
+		std::vector<EdgeIndex> bucket(static_cast<size_t>(vertices) + 1, 0);
+		for (const auto& arc : arcs) {
+			++bucket[arc.src + 1];
+		}
+		for (int u = 0; u < vertices; ++u) {
+			bucket[u + 1] += bucket[u];
+		}
+		std::vector<Edge<V, W>> sorted(arcs.size());
+		{
+			std::vector<EdgeIndex> cursor(bucket.begin(), bucket.end() - 1);
+			for (const auto& arc : arcs) {
+				sorted[cursor[arc.src]++] = arc;
+			}
+		}
+		arcs.clear();
+		arcs.shrink_to_fit();
+
+		std::vector<EdgeIndex> row_offsets(static_cast<size_t>(vertices) + 1, 0);
+		std::vector<V> row_targets;
+		std::vector<W> row_weights;
+		row_targets.reserve(sorted.size());
+		row_weights.reserve(sorted.size());
+
+		for (int u = 0; u < vertices; ++u) {
+			auto const first = sorted.begin() + bucket[u];
+			auto const last = sorted.begin() + bucket[u + 1];
+			// 稳定排序保证重复弧的先后次序，便于保留最后一条
+			std::stable_sort(first, last, [](const Edge<V, W>& a, const Edge<V, W>& b) { return a.dest < b.dest; });
+			for (auto it = first; it != last; ++it) {
+				if (it + 1 != last && (it + 1)->dest == it->dest) {
+					continue;
+				}
+				row_targets.push_back(it->dest);
+				row_weights.push_back(it->weight);
+			}
+			row_offsets[u + 1] = static_cast<EdgeIndex>(row_targets.size());
+		}
+
+		offsets.assign(std::move(row_offsets));
+		targets.assign(std::move(row_targets));
+		weights.assign(std::move(row_weights));
+	}
+
+	/**
+	 * @brief 在顶点 src 的行内二分查找指向 dest 的边。
+	 * @return 边的权重，无边时返回 GraphTraits::no_edge。
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline W CsrAdjacency<V, W>::find(V const src, V const dest) const
+	{
+		auto const first = targets.begin() + offsets[src];
+		auto const last = targets.begin() + offsets[src + 1];
+		if (auto const it = std::lower_bound(first, last, dest);
+			it != last && *it == dest) {
+			return weights[static_cast<std::size_t>(it - targets.begin())];
+		}
+		return GraphTraits<V, W>::no_edge;
+	}
+
+
+	/*****************************************************************
+	 *
+	 *		VertexTable 类 函数实现
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 调整顶点表的容量，新增的位置为空位。
+	 * @param n 顶点数。
+	 */
+	inline void VertexTable::resize(int const n)
+	{
+		m_x.modify([n](auto& values) { values.resize(n, 0); });
+		m_y.modify([n](auto& values) { values.resize(n, 0); });
+		m_attr.modify([n](auto& values) { values.resize(n, Attribute::Empty); });
+		m_nameOffset.modify([n](auto& values) { values.resize(n, npos); });
+		m_nameLength.modify([n](auto& values) { values.resize(n, 0); });
+	}
+
+	/**
+	 * @brief 为之后追加的 bytes 字节名称预留名称池空间。
+	 */
+	inline void VertexTable::reserveNames(std::size_t const bytes)
+	{
+		m_namePool.modify([bytes](auto& pool) { pool.reserve(pool.size() + bytes); });
+	}
+
+	/**
+	 * @brief 设置编号为 id 的顶点信息，编号越界时忽略。
+	 *
+	 * 名称追加到名称池末尾；重复设置同一顶点时旧名称留在池中不再被引用。
+	 */
+	inline void VertexTable::set(int const id, std::string_view const name, std::int32_t const x,
+	                             std::int32_t const y, Attribute const attr)
+	{
+		if (id < 0 || id >= size()) {
+			return;
+		}
+		m_x.mutable_data()[id] = x;
+		m_y.mutable_data()[id] = y;
+		m_attr.mutable_data()[id] = attr;
+		m_nameOffset.mutable_data()[id] = static_cast<std::uint32_t>(m_namePool.size());
+		m_nameLength.mutable_data()[id] = static_cast<std::uint32_t>(name.size());
+		m_namePool.modify([name](auto& pool) { pool.insert(pool.end(), name.begin(), name.end()); });
+	}
+
+
 	/*****************************************************************
 	 *
 	 *		WGraph 类 函数实现
@@ -15,13 +151,32 @@ namespace route
 	/* 基础方法 */
 	/**
 	 * @brief 添加一个顶点到图中。
-	 * @param vertex 要添加的顶点。
+	 * @param vertex 要添加的顶点，其信息被复制进顶点表。
 	 */
-	inline void WGraph::addVertex(const std::shared_ptr<Object>& vertex)
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::addVertex(const std::shared_ptr<Object>& vertex)
 	{
 		if (vertex != nullptr) {
-			// 使用顶点的 id 作为键存储到 map 中
-			m_vertexMap[vertex->m_id] = vertex;
+			addVertex(vertex->m_name, vertex->m_id, vertex->m_location, vertex->m_attr);
+		}
+	}
+
+	/**
+	 * @brief 添加一个顶点到图中，不经过 Object 的堆分配。
+	 * @param name 顶点名称。
+	 * @param id 顶点编号，超出 [0, 顶点数) 时忽略。
+	 * @param location 顶点位置。
+	 * @param attr 顶点属性。
+	 */
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::addVertex(std::string_view const name, IntType const id,
+	                                                    std::pair<IntType, IntType> const location,
+	                                                    Attribute const attr)
+	{
+		if (id >= 0 && id < m_vertices) {
+			m_heuristicScale = 0.0;
+			m_vertexTable.set(static_cast<int>(id), name, static_cast<std::int32_t>(location.first),
+			                  static_cast<std::int32_t>(location.second), attr);
 		}
 	}
 
@@ -29,8 +184,9 @@ namespace route
 	 * @brief 批量添加顶点到图中。
 	 * @param vertices 可变参数模板，用于传递多个顶点。
 	 */
+	template <typename V, typename W>
 	template <typename... Args>
-	inline void WGraph::addVertices(Args&&... vertices)
+	inline void WeightedAdjMatrixGraph<V, W>::addVertices(Args&&... vertices)
 	{
 		(addVertex(std::forward<Args>(vertices)), ...);
 	}
@@ -41,13 +197,165 @@ namespace route
 	 * @param dest 目标顶点。
 	 * @param weight 边的权重。
 	 */
-	inline void WGraph::addEdge(int const src, int const dest, int const weight)
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::addEdge(VertexId const src, VertexId const dest, Weight const weight)
 	{
-		if (src >= 0 && src < m_vertices && dest >= 0 && dest < m_vertices && weight > 0) {
-			m_adjMatrix[src][dest] = weight;
-			m_adjMatrix[dest][src] = weight;
+		if (hasVertex(src) && hasVertex(dest) && weight > 0 && weight != Traits::no_edge) {
+			if (m_storage == Storage::Matrix) {
+				m_adjMatrix(src, dest) = weight;
+				m_adjMatrix(dest, src) = weight;
+			} else {
+				// Csr 模式下先暂存，由 finalize 统一构建
+				m_pendingArcs.push_back({src, dest, weight});
+				m_pendingArcs.push_back({dest, src, weight});
+			}
 			m_edges++;
+			m_heuristicScale = 0.0;
+			m_hierarchy.reset();
+			m_hubLabels.reset();
+		}
+	}
+
+	/**
+	 * @brief 添加一条从 src 指向 dest 的有向弧。
+	 *
+	 * 添加后图不再是对称的：forEachInNeighbor 改为经由反向邻接（Csr 模式下由 finalize 构建的转置 CSR，
+	 * Matrix 模式下按列扫描）遍历入边，write_to_file 拒绝写出该图。
+	 * @param src 起始顶点。
+	 * @param dest 目标顶点。
+	 * @param weight 弧的权重。
+	 */
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::addArc(VertexId const src, VertexId const dest, Weight const weight)
+	{
+		if (hasVertex(src) && hasVertex(dest) && weight > 0 && weight != Traits::no_edge) {
+			if (m_storage == Storage::Matrix) {
+				m_adjMatrix(src, dest) = weight;
+			} else {
+				m_pendingArcs.push_back({src, dest, weight});
+			}
+			m_edges++;
+			m_symmetric = false;
+			m_heuristicScale = 0.0;
+			m_hierarchy.reset();
+			m_hubLabels.reset();
+		}
+	}
+
+	/**
+	 * @brief 为即将添加的 edges 条边与 name_bytes 字节的顶点名称预留空间。
+	 *
+	 * 边的预留仅 Csr 模式需要，Matrix 模式的邻接矩阵在构造时已一次分配。
+	 */
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::reserve(std::size_t const edges, std::size_t const name_bytes)
+	{
+		if (m_storage == Storage::Csr) {
+			m_pendingArcs.reserve(m_pendingArcs.size() + 2 * edges);
+		}
+		m_vertexTable.reserveNames(name_bytes);
+	}
+
+	/**
+	 * @brief 设置顶点在输入文件中的编号，打印路径与写回文件时使用。
+	 * @param ids 顶点编号映射，恒等映射只保存为空映射
+	 * @throw std::invalid_argument 如果映射非空且大小与顶点数不同
+	 */
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::setVertexIds(VertexIdMap ids)
+	{
+		if (!ids.original.empty() && ids.size() != m_vertices) {
+			throw std::invalid_argument("顶点编号映射的大小与顶点数不同");
+		}
+		if (ids.identity()) {
+			ids.original.clear();
+		}
+		m_ids = std::move(ids);
+	}
+
+	/**
+	 * @brief 将暂存的边并入 CSR 邻接表，并重新计算 A* 的启发函数系数。
+	 *
+	 * Csr 模式下添加边后、执行路径算法前必须调用；Matrix 模式下只计算启发函数系数，
+	 * 未调用时 aStar 退化为 dijkstra。
+	 * 重复的边以最后一次添加的权重为准，与 Matrix 模式的覆盖语义一致。
+	 */
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::finalize()
+	{
+		if (m_storage == Storage::Csr && !m_pendingArcs.empty()) {
+			mergePendingArcs();
+		}
+		updateHeuristicScale();
+	}
+
+	/**
+	 * @brief 计算坐标启发函数的比例系数。
+	 *
+	 * 取所有边上 权重 / 端点欧氏距离 的最小值 k，则对任意边 (u, v) 有 w(u, v) ≥ k·|uv|，
+	 * 由三角不等式 h(v) = k·|v t| 满足 h(u) ≤ w(u, v) + h(v)，即启发函数是一致的。
+	 * 存在未设置坐标的顶点带边，或没有长度非零的边时，系数为 0，aStar 退化为 dijkstra。
+	 */
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::updateHeuristicScale()
+	{
+		double scale = std::numeric_limits<double>::infinity();
+		bool usable = true;
+		for (int u = 0; u < m_vertices && usable; ++u) {
+			forEachNeighbor(static_cast<VertexId>(u), [&](VertexId const v, Weight const weight)
+			{
+				if (!m_vertexTable.contains(u) || !m_vertexTable.contains(v)) {
+					usable = false;
+					return;
+				}
+				double const length = std::hypot(static_cast<double>(m_vertexTable.x(u)) - m_vertexTable.x(v),
+				                                 static_cast<double>(m_vertexTable.y(u)) - m_vertexTable.y(v));
+				if (length > 0.0) {
+					scale = std::min(scale, static_cast<double>(weight) / length);
+				}
+			});
+		}
+		// 留出浮点舍入的余量，保证 h 不会因舍入而略大于真实距离
+		m_heuristicScale = usable && std::isfinite(scale) ? scale * (1.0 - 1e-9) : 0.0;
+	}
+
+	/**
+	 * @brief 将暂存的有向弧与已有的 CSR 邻接表合并后重建。
+	 */
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::mergePendingArcs()
+	{
+		std::vector<Edge<V, W>> arcs;
+		arcs.reserve(m_csr.targets.size() + m_pendingArcs.size());
+		for (int u = 0; u < m_vertices; ++u) {
+			for (auto i = m_csr.offsets[u]; i < m_csr.offsets[u + 1]; ++i) {
+				arcs.push_back({static_cast<VertexId>(u), m_csr.targets[i], m_csr.weights[i]});
+			}
+		}
+		arcs.insert(arcs.end(), m_pendingArcs.begin(), m_pendingArcs.end());
+		m_pendingArcs.clear();
+		m_pendingArcs.shrink_to_fit();
+
+		m_csr.build(m_vertices, std::move(arcs));
+		if (!m_symmetric) {
+			buildReverseCsr();
+		}
+	}
+
+	/**
+	 * @brief 由正向 CSR 构建转置的反向 CSR，供有向图上的 forEachInNeighbor 使用。
+	 */
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::buildReverseCsr()
+	{
+		std::vector<Edge<V, W>> arcs;
+		arcs.reserve(m_csr.targets.size());
+		for (int u = 0; u < m_vertices; ++u) {
+			for (auto i = m_csr.offsets[u]; i < m_csr.offsets[u + 1]; ++i) {
+				arcs.push_back({m_csr.targets[i], static_cast<VertexId>(u), m_csr.weights[i]});
+			}
 		}
+		m_reverseCsr.build(m_vertices, std::move(arcs));
 	}
 
 	/**
@@ -56,10 +364,12 @@ namespace route
 	 * @param dest 目标顶点。
 	 * @return 边的权重，如果顶点无效则返回-1。
 	 */
-	[[nodiscard]] inline int WGraph::getWeight(int const src, int const dest) const
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::getWeight(VertexId const src, VertexId const dest) const
+		-> Distance
 	{
-		if (src >= 0 && src < m_vertices && dest >= 0 && dest < m_vertices) {
-			return m_adjMatrix[src][dest];
+		if (hasVertex(src) && hasVertex(dest)) {
+			return edgeWeight(src, dest);
 		}
 		return -1;
 	}
@@ -67,15 +377,16 @@ namespace route
 	/**
 	 * @brief 获取指定索引的顶点信息。
 	 * @param id 顶点的索引。
-	 * @return 顶点信息，如果索引无效则返回nullptr。
+	 * @return 顶点信息视图，如果索引无效则返回空。
 	 */
-	[[nodiscard]] inline auto WGraph::getVertex(int const id) const -> std::shared_ptr<Object>
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::getVertex(VertexId const id) const
+		-> std::optional<VertexView>
 	{
-		if (auto const it = m_vertexMap.find(id);
-			it != m_vertexMap.end()) {
-			return it->second;
+		if (hasVertex(id) && m_vertexTable.contains(static_cast<int>(id))) {
+			return m_vertexTable.view(static_cast<int>(id));
 		}
-		return nullptr;
+		return std::nullopt;
 	}
 
 
@@ -85,209 +396,752 @@ namespace route
 	 * @param start 起始顶点。
 	 * @param end 结束顶点。
 	 * @return 一个包含最短路径和总距离的元组。如果找不到路径，距离为-1。
+	 * @tparam QueuePolicy 优先队列策略：IndexedHeapQueue（默认）、RadixHeapQueue 或 DialQueue，
+	 *         后两者只适用于整数权重。
+	 * @throw std::length_error 使用 DialQueue 且待处理键值的跨度超过 BucketQueue::max_buckets 时
 	 */
-	[[nodiscard]] inline auto WGraph::dijkstra(int const start, int const end) const -> std::pair<std::vector<int>, int>
+	template <typename V, typename W>
+	template <typename QueuePolicy>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::dijkstra(VertexId const start, VertexId const end,
+	                                                                 SearchStats* const stats) const
+		-> PathResult
 	{
-		if (start < 0 || start >= m_vertices || end < 0 || end >= m_vertices) {
+		if (!hasVertex(start) || !hasVertex(end)) {
 			return {{}, -1};
 		}
 
-		std::priority_queue<std::pair<int, int>,
-		                    std::vector<std::pair<int, int>>,
-		                    std::greater<>> pq;
-		std::vector<int> dist(m_vertices, std::numeric_limits<int>::max());
-		std::vector<int> prev(m_vertices, -1);
+		using Queue = typename QueuePolicy::template type<Distance>;
+		auto& ws = thread_workspace<SearchWorkspace<Distance, VertexId, Queue>>();
+		auto const lease = ws.lease(m_vertices, Traits::invalid_vertex);
 
-		dist[start] = 0;
-		pq.emplace(0, start);
+		SearchStats local{};
+		SearchStats& counters = stats != nullptr ? *stats : local;
 
-		while (!pq.empty()) {
-			int const u = pq.top().second;
-			pq.pop();
+		ws.set(start, 0, Traits::invalid_vertex);
+		ws.heap.pushOrDecrease(start, 0);
+		++counters.queue_operations;
+
+		while (!ws.heap.empty()) {
+			auto const [d, index] = ws.heap.pop();
+			auto const u = static_cast<VertexId>(index);
+			++counters.queue_operations;
+			++counters.settled;
 
 			if (u == end) {
 				break;
 			}
 
-			for (int v = 0; v < m_vertices; ++v) {
-				if (int const weight = m_adjMatrix[u][v];
-					weight != -1) {
-					if (dist[v] > dist[u] + weight) {
-						dist[v] = dist[u] + weight;
-						prev[v] = u;
-						pq.emplace(dist[v], v);
-					}
+			forEachNeighbor(u, [&](VertexId const v, Weight const weight)
+			{
+				if (Distance const candidate = d + weight; candidate < ws.dist[v]) {
+					ws.set(v, candidate, u);
+					ws.heap.pushOrDecrease(v, candidate);
+					++counters.queue_operations;
+					++counters.relaxed;
 				}
-			}
+			});
 		}
 
-		if (dist[end] == std::numeric_limits<int>::max()) {
+		if (ws.dist[end] == ws.infinity) {
 			return {{}, -1};
 		}
 
-		std::vector<int> path;
-		for (int at = end; at != -1; at = prev[at]) {
-			path.push_back(at);
+		return {tracePath(ws.prev, end), ws.dist[end]};
+	}
+
+	/**
+	 * @brief 使用 A* 算法计算最短路径
+	 *
+	 * 启发函数为 h(v) = k·|v end|，k 由 finalize 根据所有边的 权重 / 欧氏距离 取最小值得到，
+	 * 因此 h 总是一致的：每个顶点至多出队一次，结果与 dijkstra 相同。
+	 * 系数不可用（未调用 finalize、图被修改、顶点缺少坐标）时退化为 dijkstra，并在 stats 中标记。
+	 * @param start 起点
+	 * @param end 终点
+	 * @param stats 可选的统计输出
+	 * @return 最短路径和距离
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::aStar(VertexId const start, VertexId const end,
+	                                                              SearchStats* const stats) const
+		-> PathResult
+	{
+		if (!hasVertex(start) || !hasVertex(end)) {
+			return {{}, -1};
+		}
+		if (m_heuristicScale <= 0.0) {
+			if (stats != nullptr) {
+				stats->fallback = true;
+			}
+			return dijkstra(start, end, stats);
+		}
+
+		double const target_x = m_vertexTable.x(end);
+		double const target_y = m_vertexTable.y(end);
+		auto const heuristic = [&](VertexId const v)
+		{
+			return m_heuristicScale * std::hypot(m_vertexTable.x(v) - target_x, m_vertexTable.y(v) - target_y);
+		};
+
+		// 队列键值为 f = g + h，g 保存在 ws.dist 中
+		auto& ws = thread_workspace<SearchWorkspace<Distance, VertexId, IndexedHeap<double>>>();
+		auto const lease = ws.lease(m_vertices, Traits::invalid_vertex);
+
+		SearchStats local{};
+		SearchStats& counters = stats != nullptr ? *stats : local;
+
+		ws.set(start, 0, Traits::invalid_vertex);
+		ws.heap.pushOrDecrease(start, heuristic(start));
+		++counters.queue_operations;
+
+		while (!ws.heap.empty()) {
+			auto const u = static_cast<VertexId>(ws.heap.pop().index);
+			++counters.queue_operations;
+			++counters.settled;
+
+			if (u == end) {
+				break;
+			}
+
+			Distance const g = ws.dist[u];
+			forEachNeighbor(u, [&](VertexId const v, Weight const weight)
+			{
+				if (Distance const candidate = g + weight; candidate < ws.dist[v]) {
+					ws.set(v, candidate, u);
+					ws.heap.pushOrDecrease(v, static_cast<double>(candidate) + heuristic(v));
+					++counters.queue_operations;
+					++counters.relaxed;
+				}
+			});
 		}
-		std::ranges::reverse(path);
 
-		return {path, dist[end]};
+		if (ws.dist[end] == ws.infinity) {
+			return {{}, -1};
+		}
+
+		return {tracePath(ws.prev, end), ws.dist[end]};
 	}
 
 	/**
-	 * @brief 使用遗传算法计算最短路径
+	 * @brief 使用双向 Dijkstra 算法计算最短路径
+	 *
+	 * 正向搜索沿出边从 start 扩展，反向搜索沿入边（forEachInNeighbor）从 end 扩展，
+	 * 每次扩展队首距离较小的一侧。扫描到另一侧已到达的顶点时更新最优距离 best，
+	 * 当两侧队首距离之和不小于 best 时停止：此后任何经过未确定顶点的路径都不会更短。
+	 * 最终路径由正向前驱与反向后继在相遇顶点处拼接而成。
 	 * @param start 起点
 	 * @param end 终点
+	 * @param stats 可选的统计输出，settled 为两侧出队顶点数之和
 	 * @return 最短路径和距离
+	 * @tparam QueuePolicy 优先队列策略，见 dijkstra
 	 */
-	[[nodiscard]] inline auto 
-		WGraph::geneticAlgorithm(int const start, int const end) const 
-		-> std::pair<std::vector<int>, int>
+	template <typename V, typename W>
+	template <typename QueuePolicy>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::bidirectionalDijkstra(VertexId const start, VertexId const end,
+	                                                                              SearchStats* const stats) const
+		-> PathResult
 	{
-		// 检查起点和终点是否合法
-		if (start < 0 || start >= m_vertices || end < 0 || end >= m_vertices) {
+		if (!hasVertex(start) || !hasVertex(end)) {
 			return {{}, -1};
 		}
+		if (start == end) {
+			return {{start}, 0};
+		}
 
-		std::random_device rd;
-		std::mt19937 rng(rd());
+		using Workspace = SearchWorkspace<Distance, VertexId, typename QueuePolicy::template type<Distance>>;
+		constexpr Distance infinity = Workspace::infinity;
 
-		constexpr int POPULATION_SIZE = 100;
-		constexpr int MAX_GENERATIONS = 500;
-		constexpr double CROSSOVER_RATE = 0.85;
-		constexpr double MUTATION_RATE = 0.2;
-		constexpr int ELITE_SIZE = 5;
+		// 下标 0 为正向搜索，1 为反向搜索；prev 为正向的前驱或反向的后继
+		std::array<Workspace*, 2> const ws{&thread_workspace<Workspace, 0>(), &thread_workspace<Workspace, 1>()};
+		auto const forward_lease = ws[0]->lease(m_vertices, Traits::invalid_vertex);
+		auto const backward_lease = ws[1]->lease(m_vertices, Traits::invalid_vertex);
 
-		// 初始化种群
-		std::vector<Path> population = initialize_population(start, end, m_vertices, POPULATION_SIZE);
+		SearchStats local{};
+		SearchStats& counters = stats != nullptr ? *stats : local;
 
-		Path bestPath{};
+		Distance best = infinity;
+		VertexId meet = Traits::invalid_vertex;
 
-		for (int generation = 0; generation < MAX_GENERATIONS; ++generation) {
-			std::vector<Path> newPopulation;
-			std::vector<int> distances(population.size());
+		ws[0]->set(start, 0, Traits::invalid_vertex);
+		ws[1]->set(end, 0, Traits::invalid_vertex);
+		ws[0]->heap.pushOrDecrease(start, 0);
+		ws[1]->heap.pushOrDecrease(end, 0);
+		counters.queue_operations += 2;
 
-			int bestDistanceInGeneration = std::numeric_limits<int>::max();
+		// 任一侧队列耗尽时，该侧已扫描过可达范围内的全部边，best 已是最优
+		while (!ws[0]->heap.empty() && !ws[1]->heap.empty()) {
+			Distance const forward = ws[0]->heap.top().key;
+			Distance const backward = ws[1]->heap.top().key;
+			if (best != infinity && forward + backward >= best) {
+				break;
+			}
 
-			// 计算适应度和最佳路径
-			for (size_t i = 0; i < population.size(); ++i) {
-				const Path& path = population[i];
-				if (!is_valid_path(path, m_adjMatrix)) {
-					distances[i] = -1;
-					continue;
-				}
+			int const side = forward <= backward ? 0 : 1;
+			Workspace& self = *ws[side];
+			Workspace const& other = *ws[1 - side];
+			auto const [d, index] = self.heap.pop();
+			auto const u = static_cast<VertexId>(index);
+			++counters.queue_operations;
+			++counters.settled;
 
-				distances[i] = calculate_path_distance(path, m_adjMatrix);
-				if (distances[i] < bestDistanceInGeneration) {
-					bestDistanceInGeneration = distances[i];
-					Path bestPathInGeneration = path;
-					if (is_valid_path(bestPathInGeneration, m_adjMatrix)) {
-						bestPath = bestPathInGeneration;
-					}
+			auto const relax = [&](VertexId const v, Weight const weight)
+			{
+				Distance const candidate = d + weight;
+				if (candidate < self.dist[v]) {
+					self.set(v, candidate, u);
+					self.heap.pushOrDecrease(v, candidate);
+					++counters.queue_operations;
+					++counters.relaxed;
+				}
+				if (other.dist[v] != infinity && candidate + other.dist[v] < best) {
+					best = candidate + other.dist[v];
+					meet = v;
 				}
+			};
+			if (side == 0) {
+				forEachNeighbor(u, relax);
+			} else {
+				forEachInNeighbor(u, relax);
 			}
+		}
 
-			// 精英保留
-			std::vector<std::pair<int, const Path*>> elitePaths;
-			for (size_t i = 0; i < population.size(); ++i) {
-				if (distances[i] != -1) {
-					elitePaths.emplace_back(distances[i], &population[i]);
-				}
+		if (best == infinity) {
+			return {{}, -1};
+		}
+
+		// meet 处拼接：正向部分沿前驱回溯，反向部分沿后继前进
+		Path path = tracePath(ws[0]->prev, meet);
+		for (VertexId at = ws[1]->prev[meet]; at != Traits::invalid_vertex; at = ws[1]->prev[at]) {
+			path.push_back(at);
+		}
+		return {path, best};
+	}
+
+	/**
+	 * @brief 构建收缩层次，之后 contractionHierarchyQuery 使用它回答查询。
+	 *
+	 * 层次以 shared_ptr 保存，图的拷贝共享同一份预处理；addEdge、addArc 会丢弃它。
+	 * @param witness_limit 见证搜索的出队上限，见 ContractionHierarchy::build
+	 */
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::prepareContractionHierarchy(int const witness_limit)
+	{
+		finalize();
+		m_hierarchy = std::make_shared<ContractionHierarchy<V, W> const>(
+			ContractionHierarchy<V, W>::build(*this, witness_limit));
+	}
+
+	/**
+	 * @brief 使用已有的收缩层次（如 load_contraction_hierarchy 的结果）。
+	 * @return true 如果层次与当前图一致并被采用
+	 */
+	template <typename V, typename W>
+	inline bool WeightedAdjMatrixGraph<V, W>::useContractionHierarchy(ContractionHierarchy<V, W> hierarchy)
+	{
+		finalize();
+		if (!hierarchy.matches(*this)) {
+			return false;
+		}
+		m_hierarchy = std::make_shared<ContractionHierarchy<V, W> const>(std::move(hierarchy));
+		return true;
+	}
+
+	/**
+	 * @brief 使用收缩层次计算最短路径
+	 * 未调用 prepareContractionHierarchy（或之后修改了边）时退化为 dijkstra，并在 stats 中标记。
+	 * @param start 起点
+	 * @param end 终点
+	 * @param stats 可选的统计输出
+	 * @return 最短路径和距离
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::contractionHierarchyQuery(VertexId const start,
+	                                                                                  VertexId const end,
+	                                                                                  SearchStats* const stats) const
+		-> PathResult
+	{
+		if (m_hierarchy == nullptr) {
+			if (stats != nullptr) {
+				stats->fallback = true;
 			}
+			return dijkstra(start, end, stats);
+		}
+		if (!hasVertex(start) || !hasVertex(end)) {
+			return {{}, -1};
+		}
+		return m_hierarchy->query(start, end, stats);
+	}
 
-			if (!elitePaths.empty()) {
-				std::ranges::sort(elitePaths, [](const auto& a, const auto& b) { return a.first < b.first; });
+	/**
+	 * @brief 构建枢纽标签，之后 hubLabelQuery、hubLabelDistance 使用它回答查询。
+	 *
+	 * 已有收缩层次时按其收缩顺序的逆序（最重要的顶点在前）选取枢纽，标签明显更小；否则按度数降序。
+	 */
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::prepareHubLabels()
+	{
+		finalize();
+		std::vector<VertexId> order;
+		if (m_hierarchy != nullptr) {
+			order.resize(m_vertices);
+			std::iota(order.begin(), order.end(), VertexId{0});
+			std::ranges::sort(order, std::greater<>{}, [this](VertexId const v) { return m_hierarchy->rank(v); });
+		}
+		m_hubLabels = std::make_shared<HubLabelIndex<V, W> const>(HubLabelIndex<V, W>::build(*this, order));
+	}
 
-				for (int i = 0; i < ELITE_SIZE && i < static_cast<int>(elitePaths.size()); ++i) {
-					newPopulation.push_back(*elitePaths[i].second);
-				}
+	/**
+	 * @brief 使用已有的枢纽标签（如 load_hub_labels 的结果）。
+	 * @return true 如果标签与当前图一致并被采用
+	 */
+	template <typename V, typename W>
+	inline bool WeightedAdjMatrixGraph<V, W>::useHubLabels(HubLabelIndex<V, W> labels)
+	{
+		finalize();
+		if (!labels.matches(*this)) {
+			return false;
+		}
+		m_hubLabels = std::make_shared<HubLabelIndex<V, W> const>(std::move(labels));
+		return true;
+	}
+
+	/**
+	 * @brief 使用枢纽标签计算最短路径
+	 * 未准备标签（或之后修改了边）时退化为 dijkstra，并在 stats 中标记。
+	 * @param start 起点
+	 * @param end 终点
+	 * @param stats 可选的统计输出
+	 * @return 最短路径和距离
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::hubLabelQuery(VertexId const start, VertexId const end,
+	                                                                      SearchStats* const stats) const -> PathResult
+	{
+		if (m_hubLabels == nullptr) {
+			if (stats != nullptr) {
+				stats->fallback = true;
 			}
+			return dijkstra(start, end, stats);
+		}
+		if (!hasVertex(start) || !hasVertex(end)) {
+			return {{}, -1};
+		}
+		return m_hubLabels->query(start, end);
+	}
 
-			// 选择、交叉和变异
-			while (newPopulation.size() < POPULATION_SIZE) {
-				Path parent1 = select(population, m_adjMatrix, rng);
-				Path parent2 = select(population, m_adjMatrix, rng);
+	/**
+	 * @brief 使用枢纽标签只计算距离，不还原路径
+	 * @return 最短距离，不可达时为 -1
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::hubLabelDistance(VertexId const start, VertexId const end,
+	                                                                         SearchStats* const stats) const -> Distance
+	{
+		if (m_hubLabels == nullptr) {
+			if (stats != nullptr) {
+				stats->fallback = true;
+			}
+			return dijkstra(start, end, stats).second;
+		}
+		if (!hasVertex(start) || !hasVertex(end)) {
+			return -1;
+		}
+		return m_hubLabels->distance(start, end);
+	}
 
-				Path child;
-				if (std::uniform_real_distribution<>(0.0, 1.0)(rng) < CROSSOVER_RATE) {
-					child = crossover(parent1, parent2, rng);
-				}
-				else {
-					child = parent1;
-				}
+	/**
+	 * @brief 计算从 source 出发的完整最短路径树
+	 * @param source 起点，无效时返回的树中所有顶点均不可达
+	 * @param stats 可选的统计输出
+	 * @return 最短路径树
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::shortestPathTree(VertexId const source,
+	                                                                         SearchStats* const stats) const
+		-> ShortestPathTree<V, W>
+	{
+		std::vector<Distance> dist(m_vertices, -1);
+		std::vector<VertexId> prev(m_vertices, Traits::invalid_vertex);
+		if (!hasVertex(source)) {
+			return {source, std::move(dist), std::move(prev)};
+		}
+
+		auto& ws = thread_workspace<SearchWorkspace<Distance, VertexId>>();
+		auto const lease = ws.lease(m_vertices, Traits::invalid_vertex);
 
-				if (std::uniform_real_distribution<>(0.0, 1.0)(rng) < MUTATION_RATE) {
-					mutate(child, rng);
+		SearchStats local{};
+		SearchStats& counters = stats != nullptr ? *stats : local;
+
+		ws.set(source, 0, Traits::invalid_vertex);
+		ws.heap.pushOrDecrease(source, 0);
+		++counters.queue_operations;
+		while (!ws.heap.empty()) {
+			auto const [d, index] = ws.heap.pop();
+			auto const u = static_cast<VertexId>(index);
+			++counters.queue_operations;
+			++counters.settled;
+			dist[u] = d;
+			prev[u] = ws.prev[u];
+
+			forEachNeighbor(u, [&](VertexId const v, Weight const weight)
+			{
+				if (Distance const candidate = d + weight; candidate < ws.dist[v]) {
+					ws.set(v, candidate, u);
+					ws.heap.pushOrDecrease(v, candidate);
+					++counters.queue_operations;
+					++counters.relaxed;
 				}
+			});
+		}
+		return {source, std::move(dist), std::move(prev)};
+	}
+
+	/**
+	 * @brief 使用并行 Δ-stepping 计算从 source 出发的完整最短路径树
+	 *
+	 * 结果（包括前驱的选取）与线程数无关，距离与 shortestPathTree 相同。
+	 * @param source 起点，无效时返回的树中所有顶点均不可达
+	 * @param threads 线程数，0 表示使用全部硬件线程
+	 * @param delta 桶宽，0 表示根据权重分布自动选取
+	 * @return 最短路径树
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::deltaStepping(VertexId const source, unsigned const threads,
+	                                                                      Distance const delta) const
+		-> ShortestPathTree<V, W>
+	{
+		return delta_stepping::solve(*this, source, delta, threads);
+	}
+
+	/**
+	 * @brief 使用分块 Floyd–Warshall 计算任意两点间的最短距离与下一跳
+	 *
+	 * 需要 O(V²) 的空间与 O(V³) 的时间，适用于数千个顶点以内的图；结果与线程数无关。
+	 * @param threads 线程数，0 表示使用全部硬件线程
+	 * @return 全源距离与下一跳矩阵
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::allPairs(unsigned const threads) const
+		-> AllPairsMatrix<V, W>
+	{
+		return all_pairs::solve(*this, threads);
+	}
 
-				newPopulation.push_back(child);
+	/**
+	 * @brief 计算多对多距离表
+	 *
+	 * 每个起点做一次正向 Dijkstra，全部（去重后的）终点都出队后即停止，再按列读出距离。
+	 * 起点按连续分段分给 threads 个线程，每个线程使用自己的工作区，只写自己负责的行。
+	 * @param sources 起点，对应结果的行；无效顶点所在的行全部为 -1
+	 * @param targets 终点，对应结果的列；无效顶点所在的列全部为 -1
+	 * @param threads 线程数，0 表示使用全部硬件线程
+	 * @return 行主序的距离表
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::distanceTable(std::span<VertexId const> const sources,
+	                                                                      std::span<VertexId const> const targets,
+	                                                                      unsigned threads) const
+		-> DistanceTable<Distance>
+	{
+		DistanceTable<Distance> table;
+		table.rows = static_cast<int>(sources.size());
+		table.columns = static_cast<int>(targets.size());
+		table.values.assign(sources.size() * targets.size(), -1);
+
+		std::vector<std::uint8_t> is_target(m_vertices, 0);
+		int distinct = 0;
+		for (VertexId const t : targets) {
+			if (hasVertex(t) && is_target[t] == 0) {
+				is_target[t] = 1;
+				++distinct;
+			}
+		}
+		if (distinct == 0 || sources.empty()) {
+			return table;
+		}
+
+		auto const run = [&](std::size_t const first, std::size_t const last)
+		{
+			auto& ws = thread_workspace<SearchWorkspace<Distance, VertexId>>();
+			for (std::size_t row = first; row < last; ++row) {
+				VertexId const start = sources[row];
+				if (!hasVertex(start)) {
+					continue;
+				}
+				auto const lease = ws.lease(m_vertices, Traits::invalid_vertex);
+				ws.set(start, 0, Traits::invalid_vertex);
+				ws.heap.pushOrDecrease(start, 0);
+				int remaining = distinct;
+				while (!ws.heap.empty()) {
+					auto const [d, index] = ws.heap.pop();
+					auto const u = static_cast<VertexId>(index);
+					if (is_target[u] != 0 && --remaining == 0) {
+						break;
+					}
+					forEachNeighbor(u, [&](VertexId const v, Weight const weight)
+					{
+						if (Distance const candidate = d + weight; candidate < ws.dist[v]) {
+							ws.set(v, candidate, u);
+							ws.heap.pushOrDecrease(v, candidate);
+						}
+					});
+				}
+				Distance* const out = table.values.data() + row * targets.size();
+				for (std::size_t col = 0; col < targets.size(); ++col) {
+					if (VertexId const t = targets[col]; hasVertex(t) && ws.dist[t] != ws.infinity) {
+						out[col] = ws.dist[t];
+					}
+				}
 			}
+		};
 
-			population = std::move(newPopulation);
+		if (threads == 0) {
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		threads = static_cast<unsigned>(std::min<std::size_t>(threads, sources.size()));
+		if (threads == 1) {
+			run(0, sources.size());
+			return table;
+		}
+		std::vector<std::future<void>> futures;
+		futures.reserve(threads);
+		for (unsigned t = 0; t < threads; ++t) {
+			futures.emplace_back(std::async(std::launch::async, run, sources.size() * t / threads,
+			                                sources.size() * (t + 1) / threads));
+		}
+		for (auto& future : futures) {
+			future.get();
+		}
+		return table;
+	}
 
-			if constexpr (is_debug) {
-				std::print("\rGeneration: {} / {}, Best Distance: {}",
-				           generation + 1, MAX_GENERATIONS, bestDistanceInGeneration);
+	/**
+	 * @brief 具有指定属性的全部顶点，按编号升序，可作为 distanceTable 的起点或终点。
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::verticesWithAttribute(Attribute const attr) const
+		-> std::vector<VertexId>
+	{
+		std::vector<VertexId> result;
+		for (int v = 0; v < m_vertices; ++v) {
+			if (m_vertexTable.contains(v) && m_vertexTable.attr(v) == attr) {
+				result.push_back(static_cast<VertexId>(v));
 			}
 		}
+		return result;
+	}
 
-		if constexpr (is_debug) {
-			std::print("\n");
+	/**
+	 * @brief 由前驱数组还原从起点到 end 的路径。
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::tracePath(std::vector<VertexId> const& prev,
+	                                                                  VertexId const end) const -> Path
+	{
+		Path path;
+		for (VertexId at = end; at != Traits::invalid_vertex; at = prev[at]) {
+			path.push_back(at);
 		}
+		std::ranges::reverse(path);
+		return path;
+	}
 
-		// 找到最优路径
-		if (bestPath.empty()) {
+	/**
+	 * @brief 使用遗传算法计算最短路径
+	 * @param start 起点
+	 * @param end 终点
+	 * @param config 种群、代数、比率与选择算子，岛屿、线程与迁移参数不使用
+	 * @return 最短路径和距离
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto 
+		WeightedAdjMatrixGraph<V, W>::geneticAlgorithm(VertexId const start, VertexId const end,
+		                                               IslandConfig const& config) const 
+		-> PathResult
+	{
+		// 检查起点和终点是否合法
+		if (!hasVertex(start) || !hasVertex(end)) {
+			return {{}, -1};
+		}
+
+		std::uint32_t const seed = config.seed != 0 ? config.seed : std::random_device{}();
+		return withEdgeWeights([&](auto const weight_of) -> PathResult
+		{
+			genetic::Island<VertexId, decltype(weight_of)> island(start, end, m_vertices, config, weight_of, seed);
+
+			for (int generation = 0; generation < config.generations; ++generation) {
+				Distance const bestDistanceInGeneration = island.evolve();
+
+				if constexpr (is_debug) {
+					std::print("\rGeneration: {} / {}, Best Distance: {}",
+					           generation + 1, config.generations, bestDistanceInGeneration);
+				}
+			}
+
+			if constexpr (is_debug) {
+				std::print("\n");
+			}
+
+			// 找到最优路径
+			if (island.best().empty()) {
+				return {{}, -1};
+			}
+
+			return {island.best(), island.bestDistance()};
+		});
+	}
+
+	/**
+	 * @brief 使用岛屿模型的并行遗传算法计算路径
+	 *
+	 * 每个线程演化若干个独立的种群（岛屿），每隔 migration_interval 代按环形或随机拓扑迁移精英，
+	 * 有效种群为 islands × population_size；线程足够时耗时只取决于单个岛屿的规模。见 genetic::island_model。
+	 * @param start 起点
+	 * @param end 终点
+	 * @param config 岛屿、种群与迁移参数
+	 * @return 最短路径和距离
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::islandGeneticAlgorithm(VertexId const start,
+	                                                                               VertexId const end,
+	                                                                               IslandConfig const& config) const
+		-> PathResult
+	{
+		if (!hasVertex(start) || !hasVertex(end)) {
 			return {{}, -1};
 		}
 
-		int bestDistance = calculate_path_distance(bestPath, m_adjMatrix);
-		return {bestPath, bestDistance};
+		return withEdgeWeights([&](auto const weight_of) -> PathResult
+		{
+			Path bestPath = genetic::island_model(start, end, m_vertices, weight_of, config);
+			if (bestPath.empty()) {
+				return {{}, -1};
+			}
+
+			Distance const bestDistance = calculate_path_distance(bestPath, weight_of);
+			return {std::move(bestPath), bestDistance};
+		});
 	}
 
 	/**
 	 * @brief 使用局部搜索和模拟退火策略进行路径优化
 	 * 
 	 * 该函数通过贪心算法初始化路径，然后使用模拟退火策略进行路径优化，以找到从起点到终点的最短路径。
-	 * 在优化过程中，随机选择两个城市进行交换，并根据路径长度的变化决定是否接受交换。
-	 * 最终返回优化后的路径和总距离。
+	 * 每次迭代按 config 中的比例随机选择交换、2-opt 反转或 or-opt 插入，只根据相邻的边计算长度变化，
+	 * 接受后才修改路径（见 annealing::PathAnnealer），迭代过程中不分配内存。
+	 * 不存在的边按一个大于任何合法路径长度的惩罚值计入，最终返回搜索过程中最短的路径。
 	 * 
 	 * @param start 起点城市编号
 	 * @param end 终点城市编号
-	 * @return std::pair<std::vector<int>, int> 优化后的路径和总距离
+	 * @param config 迭代次数、降温方式与操作比例
+	 * @return PathResult 优化后的路径和总距离
 	 * 
-	 * @note 如果起点或终点无效，返回空路径和-1
+	 * @note 如果起点或终点无效，或找到的最短路径仍含不存在的边，返回空路径和-1
 	 */
-	[[nodiscard]] inline auto WGraph::localSearchOptimization(int const start,
-	                                                          int const end) const -> std::pair<std::vector<int>, int>
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::localSearchOptimization(VertexId const start,
+	                                                          VertexId const end, AnnealingConfig const& config) const
+		-> PathResult
 	{
-		if (start < 0 || start >= m_vertices || end < 0 || end >= m_vertices) {
+		if (!hasVertex(start) || !hasVertex(end)) {
 			return {{}, -1};
 		}
 
-		// 使用贪心算法初始化路径：从起点开始，每次选择最近的未访问城市
-		std::vector<int> currentPath;
+		Path currentPath = greedyPath(start, end);
+		std::int64_t const penalty = missingEdgePenalty(currentPath.size());
+		std::mt19937_64 rng(config.seed != 0 ? config.seed : std::random_device{}());
+
+		Path bestPath = withEdgeWeights([&](auto const weight_of)
+		{
+			auto const cost = [weight_of, penalty](VertexId const src, VertexId const dest) -> std::int64_t
+			{
+				Distance const weight = weight_of(src, dest);
+				return weight >= 0 ? weight : penalty;
+			};
+			annealing::PathAnnealer annealer(std::move(currentPath), cost, m_symmetric, config);
+
+			double temperature = config.initial_temperature;
+			for (std::int64_t iter = 0; iter < config.iterations && annealer.movable(); ++iter) {
+				annealer.step(temperature, rng);
+				temperature = std::max(temperature * config.cooling_rate, config.min_temperature);
+			}
+			return annealer.bestPath();
+		});
+
+		// 在最后返回时重新计算一遍完整的路径长度，确保准确性
+		Distance const finalDistance = pathDistance(bestPath);
+		if (finalDistance < 0) {
+			return {{}, -1};
+		}
+		return {std::move(bestPath), finalDistance};
+	}
+
+	/**
+	 * @brief 使用并行回火（副本交换）的模拟退火进行路径优化
+	 *
+	 * 从与 localSearchOptimization 相同的贪心路径出发，K 个副本在几何间隔的固定温度上各自做 Metropolis 迭代，
+	 * 每 exchange_interval 次迭代后相邻温度的副本按 Metropolis 准则交换构型，见 annealing::parallel_tempering。
+	 *
+	 * @param start 起点城市编号
+	 * @param end 终点城市编号
+	 * @param config 副本数、温度范围、迭代与交换间隔
+	 * @return 最优路径及其总距离，以及每个温度上的统计
+	 *
+	 * @note 如果起点或终点无效，返回空路径和-1，统计为空；最优路径仍含不存在的边时返回空路径和-1
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::parallelTempering(VertexId const start, VertexId const end,
+	                                                                          TemperingConfig const& config) const
+		-> TemperingResult<V, W>
+	{
+		if (!hasVertex(start) || !hasVertex(end)) {
+			return {{{}, -1}, {}};
+		}
+
+		Path initial = greedyPath(start, end);
+		std::int64_t const penalty = missingEdgePenalty(initial.size());
+		auto [bestPath, replicas] = withEdgeWeights([&](auto const weight_of)
+		{
+			auto const cost = [weight_of, penalty](VertexId const src, VertexId const dest) -> std::int64_t
+			{
+				Distance const weight = weight_of(src, dest);
+				return weight >= 0 ? weight : penalty;
+			};
+			return annealing::parallel_tempering(std::move(initial), cost, m_symmetric, config);
+		});
+		Distance const finalDistance = pathDistance(bestPath);
+		if (finalDistance < 0) {
+			return {{{}, -1}, std::move(replicas)};
+		}
+		return {{std::move(bestPath), finalDistance}, std::move(replicas)};
+	}
+
+	/**
+	 * @brief 贪心路径：从起点开始，每次选择最近的未访问城市，最后补上终点。
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::greedyPath(VertexId const start, VertexId const end) const
+		-> Path
+	{
+		Path currentPath;
 		currentPath.reserve(m_vertices);
 		currentPath.push_back(start);
 		std::vector<bool> visited(m_vertices, false);
 		visited[start] = true;
 
 		while (currentPath.size() < static_cast<size_t>(m_vertices)) {
-			int const lastCity = currentPath.back();
-			int nextCity = -1;
-			int minDistance = std::numeric_limits<int>::max();
-
-			for (int city = 0; city < m_vertices; ++city) {
-				if (int const distance = m_adjMatrix[lastCity][city];
-					!visited[city] && city != lastCity) {
-					if (distance < minDistance && distance != -1) {
-						// 确保距离有效
-						minDistance = distance;
-						nextCity = city;
-					}
+			VertexId const lastCity = currentPath.back();
+			VertexId nextCity = Traits::invalid_vertex;
+			Distance minDistance = std::numeric_limits<Distance>::max();
+
+			forEachNeighbor(lastCity, [&](VertexId const city, Weight const distance)
+			{
+				if (!visited[city] && city != lastCity && distance < minDistance) {
+					minDistance = distance;
+					nextCity = city;
 				}
-			}
+			});
 
-			if (nextCity == -1) break; // 无法继续扩展路径
+			if (nextCity == Traits::invalid_vertex) break; // 无法继续扩展路径
 			currentPath.push_back(nextCity);
 			visited[nextCity] = true;
 		}
@@ -296,273 +1150,222 @@ namespace route
 			currentPath.push_back(end); // 确保路径以终点结束
 		}
 
-		// 计算初始路径的总距离
-		int currentDistance = 0;
-		for (size_t i = 0; i < currentPath.size() - 1; ++i) {
-			currentDistance += m_adjMatrix[currentPath[i]][currentPath[i + 1]];
-		}
-
-		std::random_device rd;
-		std::mt19937 rng(rd());
-		std::uniform_int_distribution<int> dist(1, m_vertices - 2); // 避免交换起点和终点
-
-		constexpr int MAX_ITERATIONS = 10000;
-		constexpr double INITIAL_TEMPERATURE = 1000.0;
-		constexpr double COOLING_RATE = 0.995;
-
-		double temperature = INITIAL_TEMPERATURE;
-
-		for (int iter = 0; iter < MAX_ITERATIONS; ++iter) {
-			// 随机选择两个不同的位置进行交换
-			int pos1 = dist(rng);
-			int pos2 = dist(rng);
-			while (pos1 == pos2) pos2 = dist(rng);
-
-			// 创建候选路径
-			std::vector<int> candidatePath = currentPath;
-			std::swap(candidatePath[pos1], candidatePath[pos2]);
-
-			// 计算交换前后的路径长度变化
-			int delta = 0;
-
-			// 计算交换前涉及的边
-			int left1 = pos1 > 0 ? candidatePath[pos1 - 1] : -1;
-			int right1 = pos1 < static_cast<int>(candidatePath.size()) - 1 ? candidatePath[pos1 + 1] : -1;
-			int left2 = pos2 > 0 ? candidatePath[pos2 - 1] : -1;
-			int right2 = pos2 < static_cast<int>(candidatePath.size()) - 1 ? candidatePath[pos2 + 1] : -1;
-
-			// 交换后的路径中，涉及的边可能变化
-			int originalSum = 0, newSum = 0;
-
-			// 处理位置pos1的边
-			if (left1 != -1) originalSum += m_adjMatrix[left1][candidatePath[pos1]];
-			if (right1 != -1) originalSum += m_adjMatrix[candidatePath[pos1]][right1];
-
-			// 处理位置pos2的边
-			if (left2 != -1) originalSum += m_adjMatrix[left2][candidatePath[pos2]];
-			if (right2 != -1) originalSum += m_adjMatrix[candidatePath[pos2]][right2];
-
-			// 交换后的路径
-			std::swap(candidatePath[pos1], candidatePath[pos2]);
-
-			// 计算新路径中涉及的边
-			int newLeft1 = pos1 > 0 ? candidatePath[pos1 - 1] : -1;
-			int newRight1 = pos1 < static_cast<int>(candidatePath.size()) - 1 ? candidatePath[pos1 + 1] : -1;
-			int newLeft2 = pos2 > 0 ? candidatePath[pos2 - 1] : -1;
-			int newRight2 = pos2 < static_cast<int>(candidatePath.size()) - 1 ? candidatePath[pos2 + 1] : -1;
-
-			if (newLeft1 != -1) newSum += m_adjMatrix[newLeft1][candidatePath[pos1]];
-			if (newRight1 != -1) newSum += m_adjMatrix[candidatePath[pos1]][newRight1];
-			if (newLeft2 != -1) newSum += m_adjMatrix[newLeft2][candidatePath[pos2]];
-			if (newRight2 != -1) newSum += m_adjMatrix[candidatePath[pos2]][newRight2];
+		return currentPath;
+	}
 
-			delta = newSum - originalSum;
+	/**
+	 * @brief 退火时缺边的代价：大于任何由 length 个顶点、全部真实边组成的路径长度。
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::missingEdgePenalty(std::size_t const length) const
+		-> std::int64_t
+	{
+		std::int64_t max_weight = 0;
+		for (int u = 0; u < m_vertices; ++u) {
+			forEachNeighbor(static_cast<VertexId>(u), [&](VertexId, Weight const weight)
+			{
+				max_weight = std::max<std::int64_t>(max_weight, weight);
+			});
+		}
+		return (max_weight + 1) * static_cast<std::int64_t>(length);
+	}
 
-			// 如果交换后路径更短，则接受交换
-			if (delta < 0) {
-				currentPath = std::move(candidatePath);
-				currentDistance += delta;
-			}
-			// 否则以一定概率接受（模拟退火策略）
-			else {
-				std::uniform_real_distribution<double> d(0.0, 1.0);
-				if (d(rng) < std::exp(-delta / temperature)) {
-					currentPath = std::move(candidatePath);
-					currentDistance += delta;
+	/**
+	 * @brief 路径上相邻顶点间边权之和，路径中有不存在的边时返回 -1。
+	 */
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::pathDistance(Path const& path) const -> Distance
+	{
+		return withEdgeWeights([&path](auto const weight_of)
+		{
+			Distance distance = 0;
+			for (size_t i = 0; i + 1 < path.size(); ++i) {
+				Distance const weight = weight_of(path[i], path[i + 1]);
+				if (weight < 0) {
+					return Distance{-1};
 				}
+				distance += weight;
 			}
-
-			// 降低温度
-			temperature *= COOLING_RATE;
-		}
-
-		// 在最后返回时重新计算一遍完整的路径长度，确保准确性
-		int finalDistance = 0;
-		for (size_t i = 0; i < currentPath.size() - 1; ++i) {
-			finalDistance += m_adjMatrix[currentPath[i]][currentPath[i + 1]];
-		}
-
-		return {currentPath, finalDistance};
+			return distance;
+		});
 	}
 
 	/**
     * @brief 使用遗传算法和局部搜索优化路径
     * 
+    * 种群由贪心路径初始化，每代随机选择两个不同的父代做顺序交叉（起点和终点保持不动），
+    * 子代用 2-opt 局部搜索到局部最优，再与父代合并，保留最短的 population_size 条路径。
+    * 父代与子代存放在同一个 2 × population_size 行的 genetic::Population 中，与下一代的缓冲区交替使用；
+    * 2-opt 按相邻边计算长度变化并原地反转，缺边按 missingEdgePenalty 计入，每代不再分配内存。
+    * 
     * @param start 起始点
     * @param end 结束点
     * @param populationSize 种群大小
     * @param generations 迭代次数
-    * @return std::pair<std::vector<int>, int> 优化后的路径和总距离
+    * @param seed 随机种子，0 表示使用 std::random_device；相同的种子得到相同的结果
+    * @return PathResult 优化后的路径和总距离，最优路径仍含不存在的边时为空路径和-1
     */
-	[[nodiscard]] inline auto WGraph::geneticLocalSearchOptimization(
-		int start, int end, int const population_size, int const generations) const -> std::pair<std::vector<int>, int>
+	template <typename V, typename W>
+	[[nodiscard]] inline auto WeightedAdjMatrixGraph<V, W>::geneticLocalSearchOptimization(
+		VertexId start, VertexId end, int const population_size, int const generations, std::uint32_t const seed) const
+		-> PathResult
 	{
-		if (start < 0 || start >= m_vertices || end < 0 || end >= m_vertices) {
+		if (!hasVertex(start) || !hasVertex(end) || population_size <= 0) {
 			return {{}, -1};
 		}
 
-		// 初始化种群
-		std::vector<std::vector<int>> population;
-		for (int i = 0; i < population_size; ++i) {
-			// 贪心初始化
-			std::vector<int> path;
-			path.reserve(m_vertices);
-			path.push_back(start);
-			std::vector<bool> visited(m_vertices, false);
-			visited[start] = true;
-
-			while (path.size() < static_cast<size_t>(m_vertices)) {
-				int lastCity = path.back();
-				int nextCity = -1;
-				int minDistance = std::numeric_limits<int>::max();
-
-				for (int city = 0; city < m_vertices; ++city) {
-					if (!visited[city] && city != lastCity && m_adjMatrix[lastCity][city] != -1) {
-						if (m_adjMatrix[lastCity][city] < minDistance) {
-							minDistance = m_adjMatrix[lastCity][city];
-							nextCity = city;
-						}
-					}
-				}
-
-				if (nextCity == -1) break;
-				path.push_back(nextCity);
-				visited[nextCity] = true;
-			}
-
-			if (!path.empty() && path.back() != end) {
-				path.push_back(end);
-			}
-			population.push_back(path);
-		}
-
-		for (int gen = 0; gen < generations; ++gen) {
-			// 交叉操作生成新种群
-			std::vector<std::vector<int>> newPopulation;
-			while (newPopulation.size() < population_size) {
-				int parent1 = std::rand() % population_size;
-				int parent2 = std::rand() % population_size;
-				while (parent1 == parent2) parent2 = std::rand() % population_size;
-
-				// 交叉操作
-				std::vector<int> child;
-				child.reserve(population[parent1].size());
-
-				int startIdx = std::rand() % (population[parent1].size() - 1);
-				int endIdx = std::rand() % (population[parent1].size() - startIdx) + startIdx;
-
-				std::unordered_set<int> usedCities;
-				for (int i = startIdx; i <= endIdx; ++i) {
-					child.push_back(population[parent1][i]);
-					usedCities.insert(population[parent1][i]);
-				}
-
-				for (int city : population[parent2]) {
-					if (usedCities.find(city) == usedCities.end() && city != child.front() && city != child.
-						back()) {
-						child.push_back(city);
-						usedCities.insert(city);
-					}
+		// 贪心初始化：所有个体都从同一条贪心路径出发
+		Path const initial = greedyPath(start, end);
+		int const width = static_cast<int>(initial.size());
+		std::int64_t const penalty = missingEdgePenalty(initial.size());
+		return withEdgeWeights([&](auto const weight_of) -> PathResult
+		{
+			auto const cost = [weight_of, penalty](VertexId const src, VertexId const dest) -> std::int64_t
+			{
+				Distance const weight = weight_of(src, dest);
+				return weight >= 0 ? weight : penalty;
+			};
+			auto const total_cost = [&cost](std::span<VertexId const> const path)
+			{
+				std::int64_t total = 0;
+				for (size_t i = 0; i + 1 < path.size(); ++i) {
+					total += cost(path[i], path[i + 1]);
 				}
-
-				newPopulation.push_back(child);
+				return total;
+			};
+
+			// 前 population_size 行为父代，后 population_size 行为子代
+			using Individuals = genetic::Population<VertexId, std::int64_t>;
+			Individuals pool(2 * population_size, width);
+			Individuals next(2 * population_size, width);
+			for (int i = 0; i < population_size; ++i) {
+				std::ranges::copy(initial, pool[i].begin());
+				pool.distance(i) = total_cost(initial);
 			}
+			std::vector<std::uint8_t> used(m_vertices, 0);
+			std::vector<int> order(2 * static_cast<std::size_t>(population_size));
+			std::mt19937 rng(seed != 0 ? seed : std::random_device{}());
 
-			// 局部搜索优化
-			for (auto& path : newPopulation) {
-				// 2-opt局部搜索
+			// 2-opt：反转 path[i..j]，1 ≤ i < j ≤ width - 2，起点和终点不动
+			auto const two_opt = [&](std::span<VertexId> const path)
+			{
 				bool improved = true;
 				while (improved) {
 					improved = false;
-					for (size_t i = 1; i < path.size() - 2; ++i) {
-						for (size_t j = i + 1; j < path.size(); ++j) {
-							if (j - i == 1) continue;
-
-							std::vector<int> newPath = path;
-							std::reverse(newPath.begin() + i, newPath.begin() + j);
-
-							int currentDist = 0;
-							for (size_t k = 0; k < path.size() - 1; ++k) {
-								currentDist += m_adjMatrix[path[k]][path[k + 1]];
-							}
-
-							int newDist = 0;
-							for (size_t k = 0; k < newPath.size() - 1; ++k) {
-								newDist += m_adjMatrix[newPath[k]][newPath[k + 1]];
-							}
-
-							if (newDist < currentDist) {
-								path = std::move(newPath);
+					for (int i = 1; i + 2 < width; ++i) {
+						std::int64_t forward = 0, backward = 0; // path[i..j] 内部正向与反向的长度
+						for (int j = i + 1; j + 1 < width; ++j) {
+							forward += cost(path[j - 1], path[j]);
+							backward += m_symmetric ? cost(path[j - 1], path[j]) : cost(path[j], path[j - 1]);
+							std::int64_t const delta = cost(path[i - 1], path[j]) + cost(path[i], path[j + 1]) + backward
+								- cost(path[i - 1], path[i]) - cost(path[j], path[j + 1]) - forward;
+							if (delta < 0) {
+								std::reverse(path.begin() + i, path.begin() + j + 1);
 								improved = true;
+								break; // 反转后内部长度失效，从下一个 i 继续
 							}
 						}
 					}
 				}
-			}
+			};
+
+			std::uniform_int_distribution<int> pick(0, population_size - 1);
+			for (int gen = 0; gen < generations; ++gen) {
+				// 交叉操作生成新种群
+				for (int k = population_size; k < 2 * population_size; ++k) {
+					int const parent1 = pick(rng);
+					int parent2 = pick(rng);
+					while (population_size > 1 && parent1 == parent2) parent2 = pick(rng);
+
+					// 交叉操作，只交换中间的城市
+					auto const child = pool[k];
+					if (width > 2) {
+						crossover<VertexId>(std::as_const(pool)[parent1].subspan(1, width - 2),
+						                    std::as_const(pool)[parent2].subspan(1, width - 2),
+						                    child.subspan(1, width - 2), rng, used);
+						child.front() = start;
+						child.back() = end;
+					}
+					else {
+						std::ranges::copy(pool[parent1], child.begin());
+					}
 
-			// 合并并选择优胜个体
-			population.insert(population.end(), newPopulation.begin(), newPopulation.end());
-			std::sort(population.begin(), population.end(), [this, start, end](const auto& a, const auto& b)
-			{
-				int distA = 0, distB = 0;
-				for (size_t i = 0; i < a.size() - 1; ++i) distA += m_adjMatrix[a[i]][a[i + 1]];
-				for (size_t i = 0; i < b.size() - 1; ++i) distB += m_adjMatrix[b[i]][b[i + 1]];
-				return distA < distB;
-			});
-			population.resize(population_size);
-		}
+					// 2-opt局部搜索
+					two_opt(child);
+					pool.distance(k) = total_cost(child);
+				}
 
-		// 找出最优路径
-		auto bestPathIt = std::min_element(population.begin(), population.end(),
-		                                   [this, start, end](const auto& a, const auto& b)
-		                                   {
-			                                   int distA = 0, distB = 0;
-			                                   for (size_t i = 0; i < a.size() - 1; ++i)
-				                                   distA += m_adjMatrix[a[i]][
-					                                   a[i + 1]];
-			                                   for (size_t i = 0; i < b.size() - 1; ++i)
-				                                   distB += m_adjMatrix[b[i]][
-					                                   b[i + 1]];
-			                                   return distA < distB;
-		                                   });
-		std::vector<int> bestPath = *bestPathIt;
-		int bestDistance = 0;
-		for (size_t i = 0; i < bestPath.size() - 1; ++i) {
-			bestDistance += m_adjMatrix[bestPath[i]][bestPath[i + 1]];
-		}
+				// 合并并选择优胜个体
+				std::iota(order.begin(), order.end(), 0);
+				std::ranges::sort(order, [&pool](int const a, int const b)
+				{
+					return std::pair{pool.distance(a), a} < std::pair{pool.distance(b), b};
+				});
+				for (int i = 0; i < population_size; ++i) {
+					next.assign(i, pool, order[i]);
+				}
+				pool.swap(next);
+			}
 
-		return {bestPath, bestDistance};
+			// 找出最优路径
+			auto const distances = pool.distances().first(population_size);
+			auto const best = static_cast<int>(std::ranges::min_element(distances) - distances.begin());
+			Path bestPath(pool[best].begin(), pool[best].end());
+			Distance const bestDistance = pathDistance(bestPath);
+			if (bestDistance < 0) {
+				return {{}, -1};
+			}
+			return {std::move(bestPath), bestDistance};
+		});
 	}
 
 	/* 打印 */
     /**
      * @brief 打印图的结构，带有行号和列号。
      */
-    inline void WGraph::printGraph() const
+    template <typename V, typename W>
+    inline void WeightedAdjMatrixGraph<V, W>::printGraph() const
     {
+        // Csr 模式下按邻接表打印，避免输出 O(V²) 的矩阵
+        if (m_storage == Storage::Csr) {
+            std::println("带权重的图的邻接表表示：");
+            for (int i = 0; i < m_vertices; ++i) {
+                {
+                    auto col = zzj::Color(zzj::ColorName::CYAN);
+                    std::print("{: <4} ", externalId(static_cast<VertexId>(i)));
+                }
+                forEachNeighbor(static_cast<VertexId>(i), [this](VertexId const v, Weight const weight)
+                {
+                    std::print("{}({}) ", externalId(v), weight);
+                });
+                std::print("\n");
+            }
+            return;
+        }
+
         std::println("带权重的图的邻接矩阵表示：");
-        // 打印列号
+        // 打印列号，行号与列号均为文件中的顶点编号
         {
 			auto col = zzj::Color(zzj::ColorName::GREEN);
 	        std::print(R"(L\C  )");
-	        for (int j = 1; j < m_vertices+1; ++j) {
-	            std::print("{: <5} ", j);
+	        for (int j = 0; j < m_vertices; ++j) {
+	            std::print("{: <5} ", externalId(static_cast<VertexId>(j)));
 	        }
         }
         std::print("\n");
         // 打印矩阵
-        for (int i = 1; i < m_vertices; ++i) {
+        for (int i = 0; i < m_vertices; ++i) {
             // 打印行号
 			{
 				auto col = zzj::Color(zzj::ColorName::CYAN);
-				std::print("{: <4} ", i);
+				std::print("{: <4} ", externalId(static_cast<VertexId>(i)));
 			}
             for (int j = 0; j < m_vertices; ++j) {
-                if (m_adjMatrix[i][j] == -1) {
+                if (m_adjMatrix(i, j) == Traits::no_edge) {
                     std::print("{: <5} ", "∞");
                 }
                 else {
-                    std::print("{: <5} ", m_adjMatrix[i][j]);
+                    std::print("{: <5} ", m_adjMatrix(i, j));
                 }
             }
             std::print("\n");
@@ -574,7 +1377,8 @@ namespace route
 	 * @param path 最短路径。
 	 * @param distance 总距离。
 	 */
-	inline void WGraph::printPath(const std::vector<int>& path, int const distance) const
+	template <typename V, typename W>
+	inline void WeightedAdjMatrixGraph<V, W>::printPath(const Path& path, Distance const distance) const
 	{
 		if (path.empty()) {
 			std::println("未找到路径.");
@@ -583,12 +1387,12 @@ namespace route
 
 		std::print("最短路径为: ");
 		for (size_t i = 0; i < path.size(); ++i) {
-			if (auto it = m_vertexMap.find(path[i]);
-				it != m_vertexMap.end()) {
-				std::print("{}", it->second->m_name);
+			if (auto const id = static_cast<int>(path[i]);
+				m_vertexTable.contains(id)) {
+				std::print("{}", m_vertexTable.name(id));
 			}
 			else {
-				std::print("{}", path[i]);
+				std::print("{}", externalId(path[i]));
 			}
 			if (i != path.size() - 1) {
 				std::print(" -> ");
@@ -598,5 +1402,8 @@ namespace route
 		std::println("总距离: {}", distance);
 	}
 
-
+	/* 显式实例化 */
+	template class WeightedAdjMatrixGraph<std::int32_t, std::int32_t>;
+	template class WeightedAdjMatrixGraph<std::uint16_t, std::uint16_t>;
+	template class WeightedAdjMatrixGraph<std::uint16_t, std::uint32_t>;
 }
@@ -9,6 +9,7 @@
 
 #include "tool.hpp"
 #include "file_io.hpp"
+#include "heap.hpp"
 
 constexpr bool is_debug{false};
 
@@ -16,11 +17,15 @@ namespace route
 {
 	/// 别名声明
 	using IntType = std::int_fast32_t;
-	using VertexId = IntType;
-	using Weight = IntType;
-	using Path = std::vector<VertexId>;
-	using AdjMatrix = std::vector<std::vector<Weight>>;
-	using WGraph = class WeightedAdjMatrixGraph;
+	using AdjMatrix = std::vector<std::vector<IntType>>;
+
+	template <typename V = std::int32_t, typename W = std::int32_t>
+	class WeightedAdjMatrixGraph;
+	using WGraph = WeightedAdjMatrixGraph<>;
+	template <typename V, typename W>
+	class ContractionHierarchy;
+	template <typename V, typename W>
+	class HubLabelIndex;
 
 	template <typename T>
 	class BaseObject;
@@ -31,6 +36,8 @@ namespace route
 	    GeneticAlgorithm,
 	    Dijkstra,
 	    GeneticLocalSearch,
+	    ContractionHierarchies,
+	    HubLabels,
 	};
 
 	/* 全局变量 */
@@ -39,7 +46,45 @@ namespace route
 	            Algorithm::SimulatedAnnealing,
 	            Algorithm::GeneticAlgorithm,
 	            Algorithm::Dijkstra,
-	            Algorithm::GeneticLocalSearch>();
+	            Algorithm::GeneticLocalSearch,
+	            Algorithm::ContractionHierarchies,
+	            Algorithm::HubLabels>();
+
+	/**
+	 * @brief 图的数值类型特征。
+	 *
+	 * 由顶点编号类型 V 与权重类型 W 推导路径距离的累加类型 Distance：
+	 * 取能容纳“最大顶点数 × 最大权重”（任意简单路径长度的上界）的最小有符号整型，
+	 * 不存在这样的类型时编译失败，从而在编译期排除会发生累加溢出的类型组合。
+	 *
+	 * @tparam V 顶点编号类型
+	 * @tparam W 边权重类型
+	 */
+	template <typename V = std::int32_t, typename W = std::int32_t>
+	struct GraphTraits {
+	    static_assert(std::is_integral_v<V> && std::is_integral_v<W>, "顶点编号与权重必须为整型");
+
+	    using VertexId = V;
+	    using Weight = W;
+	    using EdgeIndex = std::uint32_t;
+
+	    /// 哨兵值：有符号类型取 -1，无符号类型取最大值
+	    static constexpr V invalid_vertex = static_cast<V>(-1);
+	    static constexpr W no_edge = static_cast<W>(-1);
+
+	    static constexpr auto max_vertices = static_cast<std::uint64_t>(std::numeric_limits<V>::max());
+	    static constexpr auto max_weight = static_cast<std::uint64_t>(std::numeric_limits<W>::max());
+
+	    template <typename D>
+	    static constexpr bool fits =
+	        max_weight <= static_cast<std::uint64_t>(std::numeric_limits<D>::max()) / max_vertices;
+
+	    using Distance = std::conditional_t<fits<std::int32_t>, std::int32_t, std::int64_t>;
+	    static_assert(fits<Distance>, "路径距离累加可能溢出，请选用更窄的顶点编号或权重类型");
+
+	    using Path = std::vector<V>;
+	    using PathResult = std::pair<Path, Distance>;
+	};
 
 	/**
 	 * 起始点类
@@ -49,11 +94,216 @@ namespace route
 	    int endVertex{};   ///< 结束顶点
     };
 
+	/**
+	 * @brief 单次最短路径查询的统计信息。
+	 */
+	struct SearchStats {
+	    std::size_t settled{}; ///< 出队并确定距离的顶点数
+	    std::size_t relaxed{}; ///< 成功松弛的边数
+	    std::size_t queue_operations{}; ///< 优先队列的插入、降键与弹出次数之和
+	    bool fallback{}; ///< A* 因启发函数不可用而退化为 Dijkstra
+	};
+
+	/**
+	 * @brief 模拟退火的参数：迭代次数、降温方式与三种邻域操作的比例。
+	 *
+	 * 温度每次迭代乘以 cooling_rate，但不低于 min_temperature。
+	 * 三种操作按权重随机选取，权重为 0 的操作不会被使用；默认只交换顶点，与原先的退火一致。
+	 */
+	struct AnnealingConfig {
+	    std::int64_t iterations{10000}; ///< 迭代次数
+	    double initial_temperature{1000.0}; ///< 初始温度
+	    double cooling_rate{0.995}; ///< 每次迭代的降温系数
+	    double min_temperature{1e-3}; ///< 温度下限
+	    double swap_weight{1.0}; ///< 交换两个顶点
+	    double reverse_weight{0.0}; ///< 2-opt：反转一段路径
+	    double insert_weight{0.0}; ///< or-opt：把 1 ~ 3 个连续顶点移到别处
+	    std::uint32_t seed{0}; ///< 随机种子，0 表示使用 std::random_device
+	};
+
+	/**
+	 * @brief 并行回火（副本交换）的参数
+	 *
+	 * 第 k 个副本的温度为 min_temperature × (max_temperature / min_temperature)^(k / (replicas - 1))，
+	 * 温度固定不降。三种操作的比例与随机种子取自 moves，其余字段不使用。
+	 */
+	struct TemperingConfig {
+	    int replicas{0}; ///< 副本数，0 表示硬件线程数（至少 2）
+	    unsigned threads{0}; ///< 线程数，0 表示使用全部硬件线程，不超过副本数
+	    std::int64_t iterations{100000}; ///< 每个副本的迭代次数
+	    int exchange_interval{500}; ///< 两次交换之间每个副本的迭代次数
+	    double min_temperature{1.0}; ///< 最低温度
+	    double max_temperature{1000.0}; ///< 最高温度
+	    std::int64_t target{std::numeric_limits<std::int64_t>::min()}; ///< 全局最优不高于此值时提前停止
+	    AnnealingConfig moves{.reverse_weight = 1.0, .insert_weight = 1.0}; ///< 操作比例与随机种子，默认三种操作各占一份
+	};
+
+	/**
+	 * @brief 岛屿模型中精英迁移的拓扑
+	 */
+	enum class MigrationTopology : std::uint_fast8_t
+	{
+		Ring = 0, ///< 第 k 个岛屿接收第 k - 1 个岛屿的精英
+		Random, ///< 每次迁移时每个岛屿随机选择另一个岛屿作为来源
+	};
+
+	/**
+	 * @brief 遗传算法的选择算子，均使用本代已计算的距离，适应度为 1 / (距离 + 1)，无效路径为 0
+	 */
+	enum class SelectionMethod : std::uint_fast8_t
+	{
+		Roulette = 0, ///< 轮盘赌：每代 O(P) 建立别名表，每次选择 O(1)
+		Tournament, ///< 锦标赛：每次随机抽取 tournament_size 个个体，取其中最短的
+		Universal, ///< 随机遍历抽样：每代按等间距指针一次抽出本代所需的全部父代
+	};
+
+	/**
+	 * @brief 遗传算法与岛屿模型的参数
+	 *
+	 * 种群、代数与各种比率对每个岛屿分别生效；geneticAlgorithm 只使用其中单个种群的参数。
+	 */
+	struct IslandConfig {
+	    int islands{0}; ///< 岛屿数，0 表示硬件线程数
+	    unsigned threads{0}; ///< 线程数，0 表示使用全部硬件线程，不超过岛屿数
+	    int population_size{100}; ///< 每个岛屿的种群大小
+	    int generations{500}; ///< 代数
+	    double crossover_rate{0.85}; ///< 交叉概率
+	    double mutation_rate{0.2}; ///< 变异概率
+	    int elite_size{5}; ///< 每代直接保留的精英数
+	    int migration_interval{20}; ///< 两次迁移之间的代数
+	    int migrants{2}; ///< 每次迁移每个岛屿送出的精英数
+	    MigrationTopology topology{MigrationTopology::Ring}; ///< 迁移拓扑
+	    SelectionMethod selection{SelectionMethod::Roulette}; ///< 选择算子
+	    int tournament_size{3}; ///< 锦标赛选择每次抽取的个体数
+	    std::uint32_t seed{0}; ///< 随机种子，0 表示使用 std::random_device
+	};
+
+	/**
+	 * @brief 并行回火中一个温度上的统计
+	 */
+	struct ReplicaStats {
+	    double temperature{}; ///< 该副本的温度
+	    std::int64_t proposed{}; ///< 在该温度上生成的候选操作数
+	    std::int64_t accepted{}; ///< 其中被接受的次数
+	    std::int64_t exchanges_attempted{}; ///< 与下一个（更高）温度尝试交换的次数
+	    std::int64_t exchanges_accepted{}; ///< 其中成功的次数
+	    std::int64_t cost{}; ///< 结束时该温度上路径的代价
+	};
+
+	/**
+	 * @brief 并行回火的结果：全局最优路径与每个温度上的统计（按温度升序）。
+	 */
+	template <typename V = std::int32_t, typename W = std::int32_t>
+	struct TemperingResult {
+	    typename GraphTraits<V, W>::PathResult best{}; ///< 最优路径与距离
+	    std::vector<ReplicaStats> replicas{}; ///< 每个温度上的统计
+	};
+
+	/**
+	 * @brief 多对多距离表，行主序：第 row 行为第 row 个起点到各终点的距离，不可达为 -1。
+	 */
+	template <typename Distance>
+	struct DistanceTable {
+	    int rows{}; ///< 起点数
+	    int columns{}; ///< 终点数
+	    std::vector<Distance> values{}; ///< rows × columns 个距离
+
+	    [[nodiscard]] Distance operator()(int const row, int const col) const noexcept
+	    {
+	        return values[static_cast<std::size_t>(row) * columns + col];
+	    }
+
+	    [[nodiscard]] std::span<Distance const> row(int const row) const noexcept
+	    {
+	        return {values.data() + static_cast<std::size_t>(row) * columns, static_cast<std::size_t>(columns)};
+	    }
+	};
+
+	/**
+	 * @brief 单源最短路径树，由 WeightedAdjMatrixGraph::shortestPathTree 构建。
+	 *
+	 * 保存每个顶点的距离与前驱：距离查询 O(1)，路径在需要时沿前驱还原，同一起点的多个终点共用一次搜索。
+	 *
+	 * @tparam V 顶点编号类型
+	 * @tparam W 边权重类型
+	 */
+	template <typename V = std::int32_t, typename W = std::int32_t>
+	class ShortestPathTree
+	{
+	public:
+	    using Traits = GraphTraits<V, W>;
+	    using VertexId = V;
+	    using Distance = typename Traits::Distance;
+	    using Path = typename Traits::Path;
+	    using PathResult = typename Traits::PathResult;
+
+	    ShortestPathTree() = default;
+
+	    /**
+	     * @param source 起点
+	     * @param dist 各顶点的距离，不可达为 -1
+	     * @param prev 各顶点的前驱，起点与不可达顶点为 invalid_vertex
+	     */
+	    ShortestPathTree(VertexId const source, std::vector<Distance> dist, std::vector<VertexId> prev)
+	        : m_source(source), m_dist(std::move(dist)), m_prev(std::move(prev))
+	    {
+	    }
+
+	    [[nodiscard]] VertexId source() const noexcept { return m_source; }
+	    [[nodiscard]] int vertexCount() const noexcept { return static_cast<int>(m_dist.size()); }
+
+	    /// 到 target 的距离，不可达或编号无效时为 -1
+	    [[nodiscard]] Distance distance(VertexId const target) const noexcept
+	    {
+	        return contains(target) ? m_dist[target] : -1;
+	    }
+
+	    [[nodiscard]] bool reachable(VertexId const target) const noexcept { return distance(target) >= 0; }
+
+	    /// 树中 target 的前驱，起点与不可达顶点为 invalid_vertex
+	    [[nodiscard]] VertexId parent(VertexId const target) const noexcept
+	    {
+	        return contains(target) ? m_prev[target] : Traits::invalid_vertex;
+	    }
+
+	    /// 起点到 target 的路径，不可达时为空
+	    [[nodiscard]] Path path(VertexId const target) const
+	    {
+	        Path result;
+	        if (!reachable(target)) {
+	            return result;
+	        }
+	        for (VertexId at = target; at != Traits::invalid_vertex; at = m_prev[at]) {
+	            result.push_back(at);
+	        }
+	        std::ranges::reverse(result);
+	        return result;
+	    }
+
+	    /// 与 dijkstra(source, target) 相同形式的结果
+	    [[nodiscard]] PathResult query(VertexId const target) const
+	    {
+	        return {path(target), distance(target)};
+	    }
+
+	private:
+	    [[nodiscard]] bool contains(VertexId const v) const noexcept
+	    {
+	        return static_cast<std::uint64_t>(v) < static_cast<std::uint64_t>(m_dist.size());
+	    }
+
+	    VertexId m_source{Traits::invalid_vertex}; ///< 起点
+	    std::vector<Distance> m_dist{}; ///< 距离，不可达为 -1
+	    std::vector<VertexId> m_prev{}; ///< 前驱
+	};
+
+	using WShortestPathTree = ShortestPathTree<>;
+
 	/**
 	 *	路径与时间类
 	 */
 	struct PathTimePair {
-	    std::pair<std::vector<int>, int> path_result;
+	    GraphTraits<>::PathResult path_result;
 	    std::chrono::nanoseconds execution_time;
 	};
 
@@ -68,6 +318,349 @@ namespace route
 		Occupied, ///< 表示被占用状态, 如被一个目标访问。
 	};
 
+	/**
+	 * @brief 枚举类，表示图的存储方式。
+	 */
+	enum class Storage : std::uint_fast8_t
+	{
+		Matrix = 0, ///< 邻接矩阵，适合小规模稠密图。
+		Csr, ///< 压缩稀疏行（CSR），适合大规模稀疏图。
+	};
+
+	/**
+	 * @brief 按指定字节对齐分配内存的分配器。
+	 * @tparam T 元素类型
+	 * @tparam Align 对齐字节数
+	 */
+	template <typename T, std::size_t Align>
+	struct AlignedAllocator {
+	    using value_type = T;
+
+	    template <typename U>
+	    struct rebind { using other = AlignedAllocator<U, Align>; };
+
+	    AlignedAllocator() noexcept = default;
+	    template <typename U>
+	    explicit(false) AlignedAllocator(AlignedAllocator<U, Align> const&) noexcept {}
+
+	    [[nodiscard]] T* allocate(std::size_t const n)
+	    {
+	        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Align}));
+	    }
+
+	    void deallocate(T* const p, std::size_t) noexcept
+	    {
+	        ::operator delete(p, std::align_val_t{Align});
+	    }
+
+	    template <typename U>
+	    bool operator==(AlignedAllocator<U, Align> const&) const noexcept { return true; }
+	};
+
+	/**
+	 * @brief 自有或外部映射的只读数组
+	 *
+	 * 默认持有一个 std::vector；也可以通过 map 引用外部只读内存（如内存映射的快照文件），
+	 * 此时 keepalive 负责维持该内存的生命周期，拷贝对象只会共享映射而不复制数据。
+	 * 读取总是经由 m_view，不区分两种情况；修改通过 assign、modify 或 mutable_data 进行，
+	 * 若当前引用的是外部内存则先复制为自有数据。
+	 *
+	 * @tparam T 元素类型
+	 * @tparam Alloc 自有数据的分配器
+	 */
+	template <typename T, typename Alloc = std::allocator<T>>
+	class ArrayStore
+	{
+	public:
+	    ArrayStore() = default;
+	    ArrayStore(ArrayStore const& other)
+	        : m_owned(other.m_owned), m_view(other.m_view), m_keepalive(other.m_keepalive)
+	    {
+	        if (!mapped()) {
+	            m_view = m_owned;
+	        }
+	    }
+	    ArrayStore(ArrayStore&& other) noexcept
+	        : m_owned(std::move(other.m_owned)), m_view(std::exchange(other.m_view, {})),
+	          m_keepalive(std::move(other.m_keepalive))
+	    {
+	    }
+	    ArrayStore& operator=(ArrayStore const& other)
+	    {
+	        if (this != &other) {
+	            *this = ArrayStore(other);
+	        }
+	        return *this;
+	    }
+	    ArrayStore& operator=(ArrayStore&& other) noexcept
+	    {
+	        m_owned = std::move(other.m_owned);
+	        m_view = std::exchange(other.m_view, {});
+	        m_keepalive = std::move(other.m_keepalive);
+	        return *this;
+	    }
+
+	    [[nodiscard]] T const* data() const noexcept { return m_view.data(); }
+	    [[nodiscard]] std::size_t size() const noexcept { return m_view.size(); }
+	    [[nodiscard]] bool empty() const noexcept { return m_view.empty(); }
+	    [[nodiscard]] bool mapped() const noexcept { return m_keepalive != nullptr; }
+
+	    [[nodiscard]] T const& operator[](std::size_t const i) const noexcept { return m_view[i]; }
+	    [[nodiscard]] T const* begin() const noexcept { return m_view.data(); }
+	    [[nodiscard]] T const* end() const noexcept { return m_view.data() + m_view.size(); }
+
+	    /**
+	     * @brief 以 values 替换全部数据。
+	     */
+	    void assign(std::vector<T, Alloc> values)
+	    {
+	        m_keepalive.reset();
+	        m_owned = std::move(values);
+	        m_view = m_owned;
+	    }
+
+	    /**
+	     * @brief 对自有数据调用 fn(std::vector&)，可以改变大小。
+	     */
+	    template <typename Fn>
+	    void modify(Fn&& fn)
+	    {
+	        own();
+	        fn(m_owned);
+	        m_view = m_owned;
+	    }
+
+	    /**
+	     * @brief 取得可写的元素指针，大小不变。
+	     */
+	    [[nodiscard]] T* mutable_data()
+	    {
+	        own();
+	        return m_owned.data();
+	    }
+
+	    /**
+	     * @brief 引用外部只读内存，释放原有的自有数据。
+	     * @param view 外部数组
+	     * @param keepalive 持有外部内存的对象
+	     */
+	    void map(std::span<T const> const view, std::shared_ptr<void const> keepalive)
+	    {
+	        m_owned = {};
+	        m_view = view;
+	        m_keepalive = std::move(keepalive);
+	    }
+
+	private:
+	    /// 若引用外部内存则先复制为自有数据
+	    void own()
+	    {
+	        if (mapped()) {
+	            m_owned.assign(m_view.begin(), m_view.end());
+	            m_keepalive.reset();
+	            m_view = m_owned;
+	        }
+	    }
+
+	    std::vector<T, Alloc> m_owned{}; ///< 自有数据
+	    std::span<T const> m_view{}; ///< 当前数据，指向 m_owned 或外部内存
+	    std::shared_ptr<void const> m_keepalive{}; ///< 外部数据的生命周期，自有数据时为空
+	};
+
+	/**
+	 * @brief 带权边，用于 CSR 的构建。
+	 */
+	template <typename V, typename W>
+	struct Edge {
+	    V src{};    ///< 起始顶点
+	    V dest{};   ///< 目标顶点
+	    W weight{}; ///< 边的权重
+	};
+
+	/**
+	 * @brief 压缩稀疏行（CSR）邻接表
+	 *
+	 * 顶点 u 的出边位于 [offsets[u], offsets[u + 1]) 区间内，
+	 * 每个区间内的 targets 升序排列，weights 与 targets 一一对应。
+	 */
+	template <typename V, typename W>
+	struct CsrAdjacency {
+	    using EdgeIndex = typename GraphTraits<V, W>::EdgeIndex;
+
+	    ArrayStore<EdgeIndex> offsets{}; ///< 行偏移，大小为 V + 1
+	    ArrayStore<V> targets{}; ///< 边的目标顶点
+	    ArrayStore<W> weights{}; ///< 边的权重
+
+	    void build(int const vertices, std::vector<Edge<V, W>> arcs);
+	    [[nodiscard]] W find(V const src, V const dest) const;
+	};
+
+	/**
+	 * @brief 连续存储、缓存行对齐的稠密邻接矩阵
+	 *
+	 * 所有权重存放在一块 64 字节对齐的行主序缓冲区中，行跨度向上补齐到整缓存行，
+	 * 使每一行都从缓存行边界开始，访问 (r, c) 只需一次乘加而无需经过行指针。
+	 *
+	 * @tparam T 元素类型
+	 */
+	template <typename T>
+	class DenseMatrix
+	{
+	public:
+	    static constexpr std::size_t alignment = 64; ///< 缓冲区与行的对齐字节数
+
+	    DenseMatrix() = default;
+
+	    /**
+	     * @brief 构造 n × n 的矩阵并以 fill 填充。
+	     */
+	    explicit(true) DenseMatrix(int const n, T const fill)
+	        : m_size(n), m_stride(padded_stride(n))
+	    {
+	        m_data.assign(std::vector<T, AlignedAllocator<T, alignment>>(static_cast<std::size_t>(m_stride) * n, fill));
+	    }
+
+	    [[nodiscard]] T& operator()(int const row, int const col)
+	    {
+	        return m_data.mutable_data()[static_cast<std::size_t>(row) * m_stride + col];
+	    }
+
+	    [[nodiscard]] T operator()(int const row, int const col) const noexcept
+	    {
+	        return m_data[static_cast<std::size_t>(row) * m_stride + col];
+	    }
+
+	    /// 返回第 row 行的首地址
+	    [[nodiscard]] T const* row(int const row) const noexcept
+	    {
+	        return m_data.data() + static_cast<std::size_t>(row) * m_stride;
+	    }
+
+	    [[nodiscard]] T* row(int const row)
+	    {
+	        return m_data.mutable_data() + static_cast<std::size_t>(row) * m_stride;
+	    }
+
+	    [[nodiscard]] int size() const noexcept { return m_size; }
+	    [[nodiscard]] int stride() const noexcept { return m_stride; }
+	    [[nodiscard]] auto const& storage() const noexcept { return m_data; }
+
+	    /**
+	     * @brief 引用外部的行主序数据，data 需 64 字节对齐且包含 n × stride 个元素。
+	     */
+	    void map(int const n, int const stride, std::span<T const> const data, std::shared_ptr<void const> keepalive)
+	    {
+	        m_size = n;
+	        m_stride = stride;
+	        m_data.map(data, std::move(keepalive));
+	    }
+
+	private:
+	    /// 将行长度补齐到整缓存行
+	    static constexpr int padded_stride(int const n) noexcept
+	    {
+	        constexpr int per_line = static_cast<int>(alignment / sizeof(T));
+	        return (n + per_line - 1) / per_line * per_line;
+	    }
+
+	    int m_size{0};   ///< 行（列）数
+	    int m_stride{0}; ///< 补齐后的行跨度（元素个数）
+	    ArrayStore<T, AlignedAllocator<T, alignment>> m_data{}; ///< 行主序数据
+	};
+
+	/**
+	 * @brief 全源最短路径矩阵，由 WeightedAdjMatrixGraph::allPairs 构建。
+	 *
+	 * 保存任意两点间的距离与下一跳：距离查询 O(1)，路径沿下一跳逐点还原。
+	 * 适用于需要在任意两点之间跳转的启发式算法（模拟退火、遗传算法等）。
+	 *
+	 * @tparam V 顶点编号类型
+	 * @tparam W 边权重类型
+	 */
+	template <typename V = std::int32_t, typename W = std::int32_t>
+	class AllPairsMatrix
+	{
+	public:
+	    using Traits = GraphTraits<V, W>;
+	    using VertexId = V;
+	    using Distance = typename Traits::Distance;
+	    using Path = typename Traits::Path;
+	    using PathResult = typename Traits::PathResult;
+
+	    /// 内部表示不可达的距离，两个相加不会溢出
+	    static constexpr Distance infinity = std::numeric_limits<Distance>::max() / 4;
+
+	    AllPairsMatrix() = default;
+
+	    /**
+	     * @param dist 距离矩阵，不可达为 infinity
+	     * @param next 下一跳矩阵，不可达为 invalid_vertex，next(v, v) = v
+	     */
+	    AllPairsMatrix(DenseMatrix<Distance> dist, DenseMatrix<VertexId> next)
+	        : m_dist(std::move(dist)), m_next(std::move(next))
+	    {
+	    }
+
+	    [[nodiscard]] int vertexCount() const noexcept { return m_dist.size(); }
+
+	    /// from 到 to 的距离，不可达或编号无效时为 -1
+	    [[nodiscard]] Distance distance(VertexId const from, VertexId const to) const noexcept
+	    {
+	        if (!contains(from) || !contains(to)) {
+	            return -1;
+	        }
+	        Distance const d = m_dist(static_cast<int>(from), static_cast<int>(to));
+	        return d < infinity ? d : -1;
+	    }
+
+	    [[nodiscard]] bool reachable(VertexId const from, VertexId const to) const noexcept
+	    {
+	        return distance(from, to) >= 0;
+	    }
+
+	    /// from 到 to 的最短路径上 from 之后的顶点，不可达时为 invalid_vertex
+	    [[nodiscard]] VertexId nextHop(VertexId const from, VertexId const to) const noexcept
+	    {
+	        return contains(from) && contains(to) ? m_next(static_cast<int>(from), static_cast<int>(to))
+	                                              : Traits::invalid_vertex;
+	    }
+
+	    /// from 到 to 的路径，不可达时为空
+	    [[nodiscard]] Path path(VertexId const from, VertexId const to) const
+	    {
+	        Path result;
+	        if (!reachable(from, to)) {
+	            return result;
+	        }
+	        result.push_back(from);
+	        for (VertexId at = from; at != to;) {
+	            at = m_next(static_cast<int>(at), static_cast<int>(to));
+	            result.push_back(at);
+	        }
+	        return result;
+	    }
+
+	    /// 与 dijkstra(from, to) 相同形式的结果
+	    [[nodiscard]] PathResult query(VertexId const from, VertexId const to) const
+	    {
+	        return {path(from, to), distance(from, to)};
+	    }
+
+	    /// 距离矩阵，不可达为 infinity
+	    [[nodiscard]] DenseMatrix<Distance> const& distances() const noexcept { return m_dist; }
+
+	private:
+	    [[nodiscard]] bool contains(VertexId const v) const noexcept
+	    {
+	        return static_cast<std::uint64_t>(v) < static_cast<std::uint64_t>(m_dist.size());
+	    }
+
+	    DenseMatrix<Distance> m_dist{}; ///< 距离
+	    DenseMatrix<VertexId> m_next{}; ///< 下一跳
+	};
+
+	using WAllPairsMatrix = AllPairsMatrix<>;
+
 	/**
 	 * @brief 基础物体类
 	 * @tparam T 
@@ -108,55 +701,349 @@ namespace route
 		}
 	};
 
+	/**
+	 * @brief 顶点信息的只读视图，字段名与 BaseObject 保持一致以兼容旧代码。
+	 */
+	struct VertexView {
+	    std::string_view m_name{}; ///< name 物体的名称，指向顶点表的名称池。
+	    IntType m_id{}; ///< id 物体的唯一标识符。
+	    std::pair<IntType, IntType> m_location{}; ///< location 物体的位置。
+	    Attribute m_attr{Attribute::Empty}; ///< attr 物体的属性。
+	};
+
+	/**
+	 * @brief 结构数组（SoA）形式的顶点表
+	 *
+	 * 以顶点编号为下标，坐标与属性分别存放在独立的连续数组中，
+	 * 名称统一追加到一个字符串池，每个顶点只记录其在池中的偏移与长度。
+	 * 相比 map + shared_ptr 的存储，每个顶点省去了树节点、控制块与独立的字符串分配。
+	 */
+	class VertexTable
+	{
+	public:
+	    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max(); ///< 空位标记
+
+	    VertexTable() = default;
+	    explicit(true) VertexTable(int const n) { resize(n); }
+
+	    void resize(int const n);
+	    void reserveNames(std::size_t const bytes);
+	    void set(int const id, std::string_view const name, std::int32_t const x, std::int32_t const y,
+	             Attribute const attr);
+
+	    [[nodiscard]] int size() const noexcept { return static_cast<int>(m_nameOffset.size()); }
+
+	    /// 编号为 id 的顶点是否已设置
+	    [[nodiscard]] bool contains(int const id) const noexcept
+	    {
+	        return id >= 0 && id < size() && m_nameOffset[id] != npos;
+	    }
+
+	    [[nodiscard]] std::string_view name(int const id) const noexcept
+	    {
+	        return {m_namePool.data() + m_nameOffset[id], m_nameLength[id]};
+	    }
+
+	    [[nodiscard]] std::int32_t x(int const id) const noexcept { return m_x[id]; }
+	    [[nodiscard]] std::int32_t y(int const id) const noexcept { return m_y[id]; }
+	    [[nodiscard]] Attribute attr(int const id) const noexcept { return m_attr[id]; }
+
+	    /// 返回编号为 id 的顶点视图，需保证 contains(id)
+	    [[nodiscard]] VertexView view(int const id) const noexcept
+	    {
+	        return {name(id), id, {m_x[id], m_y[id]}, m_attr[id]};
+	    }
+
+	private:
+	    ArrayStore<std::int32_t> m_x{}; ///< 横坐标
+	    ArrayStore<std::int32_t> m_y{}; ///< 纵坐标
+	    ArrayStore<Attribute> m_attr{}; ///< 属性
+	    ArrayStore<std::uint32_t> m_nameOffset{}; ///< 名称在名称池中的偏移，npos 表示空位
+	    ArrayStore<std::uint32_t> m_nameLength{}; ///< 名称长度
+	    ArrayStore<char> m_namePool{}; ///< 名称池
+
+	    template <typename V, typename W>
+	    friend bool save_snapshot(WeightedAdjMatrixGraph<V, W>& graph, const std::string& filename,
+	                              const std::string& source);
+	    template <typename V, typename W>
+	    friend std::optional<WeightedAdjMatrixGraph<V, W>> load_snapshot(const std::string& filename,
+	                                                                     bool verify_checksum, const std::string& source);
+	};
+
 	/**
 	 * @brief 类，表示一个带权邻接矩阵图。
+	 * @tparam V 顶点编号类型，例如 std::uint16_t
+	 * @tparam W 边权重类型，例如 std::uint16_t / std::uint32_t
 	 */
+	template <typename V, typename W>
 	class WeightedAdjMatrixGraph
 	{
+	public:
+		using Traits = GraphTraits<V, W>;
+		using VertexId = V;
+		using Weight = W;
+		using Distance = typename Traits::Distance;
+		using Path = typename Traits::Path;
+		using PathResult = typename Traits::PathResult;
+
 	private:
-		IntType m_vertices;	///> 顶点
+		int m_vertices;	///> 顶点
 		IntType m_edges;	///> 边
-		std::map<IntType, std::shared_ptr<Object>> m_vertexMap; ///> 使用 map 存储顶点，键为顶点的 id
-		std::vector<std::vector<IntType>> m_adjMatrix; ///> 边权重
+		Storage m_storage;	///> 存储方式
+		VertexTable m_vertexTable; ///> 顶点表，以顶点编号为下标
+		DenseMatrix<W> m_adjMatrix; ///> 边权重（Matrix 模式）
+		CsrAdjacency<V, W> m_csr; ///> 边权重（Csr 模式）
+		std::vector<Edge<V, W>> m_pendingArcs; ///> 尚未并入 CSR 的有向弧
+		CsrAdjacency<V, W> m_reverseCsr; ///> 反向邻接（Csr 模式下的有向图）
+		bool m_symmetric{true}; ///> 是否只含无向边，此时入边与出边相同
+		double m_heuristicScale{0.0}; ///> A* 启发函数的比例系数，0 表示不可用，由 finalize 计算
+		std::shared_ptr<ContractionHierarchy<V, W> const> m_hierarchy{}; ///> 收缩层次，拷贝间共享，修改边时丢弃
+		std::shared_ptr<HubLabelIndex<V, W> const> m_hubLabels{}; ///> 枢纽标签，拷贝间共享，修改边时丢弃
+		VertexIdMap m_ids{}; ///> 文件中的顶点编号，为空表示与图内编号相同
 
 	public:
 		/**
 		 * @brief 构造一个新的 WeightedAdjMatrixGraph 对象。
 		 * @param v 图中的顶点数。
+		 * @param storage 存储方式，Csr 模式下不分配 O(V²) 的邻接矩阵。
+		 * @throw std::invalid_argument 如果顶点数超出顶点编号类型的表示范围
 		 */
-		explicit(true) WeightedAdjMatrixGraph(int const v) : m_vertices(v), m_edges(0)
+		explicit(true) WeightedAdjMatrixGraph(int const v, Storage const storage = Storage::Matrix)
+			: m_vertices(v), m_edges(0), m_storage(storage)
 		{
-			m_adjMatrix.resize(v, std::vector<int>(v, -1));
+			if (v < 0 || static_cast<std::uint64_t>(v) > Traits::max_vertices) {
+				throw std::invalid_argument("顶点数超出顶点编号类型的表示范围");
+			}
+			m_vertexTable.resize(v);
+			if (m_storage == Storage::Matrix) {
+				m_adjMatrix = DenseMatrix<W>(v, Traits::no_edge);
+			} else {
+				m_csr.offsets.assign(std::vector<typename Traits::EdgeIndex>(static_cast<size_t>(v) + 1, 0));
+			}
 		}
 
 		/* 基础方法 */
 		void addVertex(const std::shared_ptr<Object>& vertex);
+		void addVertex(std::string_view const name, IntType const id, std::pair<IntType, IntType> const location,
+		               Attribute const attr = Attribute::Empty);
 		template <typename... Args>
 		void addVertices(Args&&... vertices);
-		void addEdge(int const src, int const dest, int const weight);
-		[[nodiscard]] int getWeight(int const src, int const dest) const;
-		[[nodiscard]] auto getVertex(int const id) const->std::shared_ptr<Object>;
+		void addEdge(VertexId const src, VertexId const dest, Weight const weight);
+		void addArc(VertexId const src, VertexId const dest, Weight const weight);
+		void reserve(std::size_t const edges, std::size_t const name_bytes = 0);
+		void finalize();
+		[[nodiscard]] Distance getWeight(VertexId const src, VertexId const dest) const;
+		[[nodiscard]] auto getVertex(VertexId const id) const->std::optional<VertexView>;
+		[[nodiscard]] VertexTable const& vertices() const noexcept { return m_vertexTable; }
+		[[nodiscard]] Storage storage() const noexcept { return m_storage; }
+		[[nodiscard]] int vertexCount() const noexcept { return m_vertices; }
+		[[nodiscard]] bool symmetric() const noexcept { return m_symmetric; }
+		void setVertexIds(VertexIdMap ids);
+		[[nodiscard]] VertexIdMap const& vertexIds() const noexcept { return m_ids; }
+
+		/**
+		 * @brief 图内编号在输入文件中的编号，用于打印与写回文件。
+		 */
+		[[nodiscard]] std::int64_t externalId(VertexId const v) const noexcept
+		{
+			return m_ids.external(static_cast<int>(v));
+		}
+
+		/**
+		 * @brief 判断顶点编号是否在图的范围内。
+		 */
+		[[nodiscard]] bool hasVertex(VertexId const v) const noexcept
+		{
+			if constexpr (std::is_signed_v<VertexId>) {
+				if (v < 0) {
+					return false;
+				}
+			}
+			return static_cast<std::uint64_t>(v) < static_cast<std::uint64_t>(m_vertices);
+		}
+
+		/**
+		 * @brief 不做边界检查的边权重访问，供算法热路径使用。
+		 * @return 边的权重，无边时返回-1。
+		 */
+		[[nodiscard]] Distance edgeWeight(VertexId const src, VertexId const dest) const
+		{
+			Weight const weight = m_storage == Storage::Matrix ? m_adjMatrix(src, dest) : m_csr.find(src, dest);
+			return weight == Traits::no_edge ? Distance{-1} : static_cast<Distance>(weight);
+		}
+
+		/**
+		 * @brief Matrix 模式的边权重访问器，按行跨度直接读取矩阵，无边时返回-1。
+		 */
+		struct MatrixWeights {
+		    W const* data; ///< 矩阵首地址
+		    std::size_t stride; ///< 行跨度（元素个数）
+
+		    [[nodiscard]] Distance operator()(VertexId const src, VertexId const dest) const noexcept
+		    {
+		        W const weight = data[static_cast<std::size_t>(src) * stride + dest];
+		        return weight == Traits::no_edge ? Distance{-1} : static_cast<Distance>(weight);
+		    }
+		};
+
+		/**
+		 * @brief Csr 模式的边权重访问器，在 src 的出边区间内二分查找，无边时返回-1。
+		 */
+		struct CsrWeights {
+		    CsrAdjacency<V, W> const* csr; ///< 邻接表
+
+		    [[nodiscard]] Distance operator()(VertexId const src, VertexId const dest) const
+		    {
+		        W const weight = csr->find(src, dest);
+		        return weight == Traits::no_edge ? Distance{-1} : static_cast<Distance>(weight);
+		    }
+		};
+
+		/**
+		 * @brief 按存储方式只分派一次，以对应的边权重访问器调用 fn(weight_of)。
+		 *
+		 * 逐边调用的热循环（路径评估、遗传算法、退火）应放在 fn 中，
+		 * 使循环体内不再判断存储方式；返回 fn 的返回值。
+		 */
+		template <typename Fn>
+		decltype(auto) withEdgeWeights(Fn&& fn) const
+		{
+			if (m_storage == Storage::Matrix) {
+				return std::forward<Fn>(fn)(MatrixWeights{m_adjMatrix.row(0),
+				                                          static_cast<std::size_t>(m_adjMatrix.stride())});
+			}
+			return std::forward<Fn>(fn)(CsrWeights{&m_csr});
+		}
+
+		/**
+		 * @brief 遍历顶点 u 的所有出边，对每条边调用 fn(v, weight)。
+		 *
+		 * Csr 模式下只访问实际存在的边，Matrix 模式下扫描整行并跳过无边项。
+		 */
+		template <typename Fn>
+		void forEachNeighbor(VertexId const u, Fn&& fn) const
+		{
+			if (m_storage == Storage::Csr) {
+				for (auto i = m_csr.offsets[u]; i < m_csr.offsets[u + 1]; ++i) {
+					fn(m_csr.targets[i], m_csr.weights[i]);
+				}
+				return;
+			}
+			W const* row = m_adjMatrix.row(u);
+			for (int v = 0; v < m_vertices; ++v) {
+				if (row[v] != Traits::no_edge) {
+					fn(static_cast<VertexId>(v), row[v]);
+				}
+			}
+		}
+
+		/**
+		 * @brief 遍历顶点 u 的所有入边，对每条边 (v, u) 调用 fn(v, weight)。
+		 *
+		 * 无向图上与 forEachNeighbor 相同；有向图在 Csr 模式下使用 finalize 构建的反向 CSR，
+		 * Matrix 模式下按列扫描。
+		 */
+		template <typename Fn>
+		void forEachInNeighbor(VertexId const u, Fn&& fn) const
+		{
+			if (m_symmetric) {
+				forEachNeighbor(u, std::forward<Fn>(fn));
+				return;
+			}
+			if (m_storage == Storage::Csr) {
+				for (auto i = m_reverseCsr.offsets[u]; i < m_reverseCsr.offsets[u + 1]; ++i) {
+					fn(m_reverseCsr.targets[i], m_reverseCsr.weights[i]);
+				}
+				return;
+			}
+			for (int v = 0; v < m_vertices; ++v) {
+				if (W const weight = m_adjMatrix(v, u); weight != Traits::no_edge) {
+					fn(static_cast<VertexId>(v), weight);
+				}
+			}
+		}
 
 		/* 路径算法 */
-		[[nodiscard]] auto dijkstra(int const start, int const end)
-		const -> std::pair<std::vector<int>, int>;
-		[[nodiscard]] auto geneticAlgorithm(int const start, int const end)
-		const -> std::pair<std::vector<int>, int>;
-		[[nodiscard]] auto localSearchOptimization(int const start, int const end)
-		const -> std::pair<std::vector<int>, int>;
-		[[nodiscard]] auto geneticLocalSearchOptimization(int start, int end, int const population_size = 50,
-		                                                  int const generations = 100)
-		const -> std::pair<std::vector<int>, int>;
+		template <typename QueuePolicy = DefaultQueue>
+		[[nodiscard]] auto dijkstra(VertexId const start, VertexId const end, SearchStats* stats = nullptr)
+		const -> PathResult;
+		[[nodiscard]] auto aStar(VertexId const start, VertexId const end, SearchStats* stats = nullptr)
+		const -> PathResult;
+		template <typename QueuePolicy = DefaultQueue>
+		[[nodiscard]] auto bidirectionalDijkstra(VertexId const start, VertexId const end, SearchStats* stats = nullptr)
+		const -> PathResult;
+		[[nodiscard]] auto contractionHierarchyQuery(VertexId const start, VertexId const end,
+		                                             SearchStats* stats = nullptr)
+		const -> PathResult;
+		[[nodiscard]] auto hubLabelQuery(VertexId const start, VertexId const end, SearchStats* stats = nullptr)
+		const -> PathResult;
+		[[nodiscard]] auto hubLabelDistance(VertexId const start, VertexId const end, SearchStats* stats = nullptr)
+		const -> Distance;
+		[[nodiscard]] auto shortestPathTree(VertexId const source, SearchStats* stats = nullptr)
+		const -> ShortestPathTree<V, W>;
+		[[nodiscard]] auto deltaStepping(VertexId const source, unsigned threads = 0, Distance delta = 0)
+		const -> ShortestPathTree<V, W>;
+		[[nodiscard]] auto allPairs(unsigned threads = 0) const -> AllPairsMatrix<V, W>;
+		[[nodiscard]] auto distanceTable(std::span<VertexId const> sources, std::span<VertexId const> targets,
+		                                 unsigned threads = 0)
+		const -> DistanceTable<Distance>;
+		[[nodiscard]] auto verticesWithAttribute(Attribute attr) const -> std::vector<VertexId>;
+		[[nodiscard]] auto geneticAlgorithm(VertexId const start, VertexId const end, IslandConfig const& config = {})
+		const -> PathResult;
+		[[nodiscard]] auto islandGeneticAlgorithm(VertexId const start, VertexId const end,
+		                                          IslandConfig const& config = {})
+		const -> PathResult;
+		[[nodiscard]] auto localSearchOptimization(VertexId const start, VertexId const end,
+		                                           AnnealingConfig const& config = {})
+		const -> PathResult;
+		[[nodiscard]] auto parallelTempering(VertexId const start, VertexId const end, TemperingConfig const& config = {})
+		const -> TemperingResult<V, W>;
+		[[nodiscard]] auto geneticLocalSearchOptimization(VertexId start, VertexId end, int const population_size = 50,
+		                                                  int const generations = 100, std::uint32_t const seed = 0)
+		const -> PathResult;
+
+		/* 预处理 */
+		void prepareContractionHierarchy(int const witness_limit = 500);
+		[[nodiscard]] bool hasContractionHierarchy() const noexcept { return m_hierarchy != nullptr; }
+		bool useContractionHierarchy(ContractionHierarchy<V, W> hierarchy);
+		[[nodiscard]] ContractionHierarchy<V, W> const* contractionHierarchy() const noexcept { return m_hierarchy.get(); }
+		void prepareHubLabels();
+		bool useHubLabels(HubLabelIndex<V, W> labels);
+		[[nodiscard]] HubLabelIndex<V, W> const* hubLabels() const noexcept { return m_hubLabels.get(); }
 
 		/* 打印 */
 		void printGraph() const;
-		void printPath(const std::vector<int>& path, int const distance) const;
+		[[nodiscard]] double heuristicScale() const noexcept { return m_heuristicScale; }
+		void printPath(const Path& path, Distance const distance) const;
+
+	private:
+		void mergePendingArcs();
+		void buildReverseCsr();
+		void updateHeuristicScale();
+		[[nodiscard]] Path tracePath(std::vector<VertexId> const& prev, VertexId end) const;
+		[[nodiscard]] Path greedyPath(VertexId start, VertexId end) const;
+		[[nodiscard]] std::int64_t missingEdgePenalty(std::size_t length) const;
+		[[nodiscard]] Distance pathDistance(Path const& path) const;
 
+	public:
 		/* 友元文件 IO 函数 */
-		friend inline bool read_from_file(WGraph& graph, const std::string& filename);
-		friend inline bool write_to_file(WGraph& graph, const std::string& filename);
+		template <typename V2, typename W2>
+		friend bool read_from_file(WeightedAdjMatrixGraph<V2, W2>& graph, const std::string& filename);
+		template <typename V2, typename W2>
+		friend bool write_to_file(WeightedAdjMatrixGraph<V2, W2>& graph, const std::string& filename, unsigned threads);
+		template <typename V2, typename W2>
+		friend bool save_snapshot(WeightedAdjMatrixGraph<V2, W2>& graph, const std::string& filename,
+		                          const std::string& source);
+		template <typename V2, typename W2>
+		friend std::optional<WeightedAdjMatrixGraph<V2, W2>> load_snapshot(const std::string& filename,
+		                                                                   bool verify_checksum, const std::string& source);
 
 	};
+
+	/* 显式实例化声明，定义位于 data.cpp */
+	extern template class WeightedAdjMatrixGraph<std::int32_t, std::int32_t>;
+	extern template class WeightedAdjMatrixGraph<std::uint16_t, std::uint16_t>;
+	extern template class WeightedAdjMatrixGraph<std::uint16_t, std::uint32_t>;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,277 @@
+﻿// Purpose: 并行 Δ-stepping 单源最短路径
+// Author:  Cmixed
+#pragma once
+
+#ifndef DELTA_STEPPING_HPP
+#define DELTA_STEPPING_HPP
+
+#include "pch.hpp"
+#include "data.hpp"
+
+namespace route::delta_stepping
+{
+	/*****************************************************************
+	 *
+	 *		Δ-stepping
+	 *
+	 *****************************************************************/
+
+	inline constexpr int max_ring = 4096; ///< 每个线程的桶数上限
+
+	/**
+	 * @brief 按轻边（权重 ≤ delta）在前、重边在后重排的邻接表，每个顶点的两段各自保持原有顺序。
+	 */
+	template <typename V, typename W>
+	struct SplitAdjacency {
+	    std::vector<std::size_t> offsets{}; ///< 行偏移，大小为 V + 1
+	    std::vector<std::size_t> heavy{}; ///< 每行重边的起始位置
+	    std::vector<V> targets{};
+	    std::vector<W> weights{};
+	};
+
+	/**
+	 * @brief 根据权重分布选取 delta：取平均权重除以平均出度，但不小于最小权重。
+	 *
+	 * 轻边在桶内可能被反复松弛，delta 越大重复越多；delta 越小桶越多、同步轮次越多。
+	 * 平均权重 / 平均出度时，一个顶点经由轻边期望只有常数个邻居落在同一个桶中。
+	 */
+	template <typename V, typename W>
+	inline auto choose_delta(WeightedAdjMatrixGraph<V, W> const& graph) -> typename GraphTraits<V, W>::Distance
+	{
+		using Distance = typename GraphTraits<V, W>::Distance;
+		std::size_t arcs = 0;
+		double total = 0.0;
+		W minimum = std::numeric_limits<W>::max();
+		for (int u = 0; u < graph.vertexCount(); ++u) {
+			graph.forEachNeighbor(static_cast<V>(u), [&](V, W const weight)
+			{
+				++arcs;
+				total += static_cast<double>(weight);
+				minimum = std::min(minimum, weight);
+			});
+		}
+		if (arcs == 0) {
+			return 1;
+		}
+		double const mean = total / static_cast<double>(arcs);
+		double const degree = static_cast<double>(arcs) / graph.vertexCount();
+		return std::max<Distance>({1, static_cast<Distance>(minimum), static_cast<Distance>(mean / degree)});
+	}
+
+	/**
+	 * @brief 并行 Δ-stepping
+	 *
+	 * 距离为原子变量，以 CAS 取最小值更新。每个线程持有自己的一圈桶（桶 b 位于 b mod ring），
+	 * 当前桶为所有线程同号桶的并集，按下标均分给各线程：
+	 *  - 轻边阶段：处理当前桶中的顶点，松弛其轻边；落回当前桶的顶点写入线程自己的 pending，
+	 *    屏障后与当前桶交换，直到当前桶为空；
+	 *  - 重边阶段：每个线程松弛自己在本桶处理过的顶点的重边，重边不会落回当前桶；
+	 *  - 所有线程在屏障之后读取相同的共享状态，得出相同的下一个非空桶或结束的判断。
+	 * 同一阶段内重复出现的顶点只处理一次。距离收敛后并行地为每个顶点选取编号最小的紧前驱
+	 * （dist[u] + w = dist[v]，权重为正故不成环），结果与线程数和调度无关。
+	 *
+	 * @param graph 图，需已 finalize
+	 * @param source 起点
+	 * @param delta 桶宽，0 表示使用 choose_delta；小于 max_weight / (max_ring - 2) 时调大到该值，
+	 * 使每个线程的桶数不超过 max_ring
+	 * @param threads 线程数，0 表示使用全部硬件线程
+	 * @return 最短路径树
+	 */
+	template <typename V, typename W>
+	inline auto solve(WeightedAdjMatrixGraph<V, W> const& graph, V const source,
+	                  typename GraphTraits<V, W>::Distance delta, unsigned threads) -> ShortestPathTree<V, W>
+	{
+		using Traits = GraphTraits<V, W>;
+		using Distance = typename Traits::Distance;
+		constexpr Distance infinity = std::numeric_limits<Distance>::max();
+		int const n = graph.vertexCount();
+
+		std::vector<Distance> result(n, -1);
+		std::vector<V> prev(n, Traits::invalid_vertex);
+		if (!graph.hasVertex(source)) {
+			return {source, std::move(result), std::move(prev)};
+		}
+		if (delta <= 0) {
+			delta = choose_delta(graph);
+		}
+		if (threads == 0) {
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		threads = static_cast<unsigned>(std::clamp(n / 1024, 1, static_cast<int>(threads)));
+
+		// 在 threads 个线程上执行 fn(t, first, last)，顶点区间按线程均分
+		auto const parallel_for = [threads, n](auto&& fn)
+		{
+			std::vector<std::future<void>> futures;
+			futures.reserve(threads);
+			for (unsigned t = 0; t < threads; ++t) {
+				futures.emplace_back(std::async(std::launch::async, [&fn, t, threads, n]()
+				{
+					fn(t, static_cast<int>(static_cast<long long>(n) * t / threads),
+					   static_cast<int>(static_cast<long long>(n) * (t + 1) / threads));
+				}));
+			}
+			for (auto& future : futures) {
+				future.get();
+			}
+		};
+
+		// 重排邻接表：先统计度数与最大权重，再按顶点区间并行填充
+		SplitAdjacency<V, W> adjacency;
+		adjacency.offsets.assign(static_cast<std::size_t>(n) + 1, 0);
+		adjacency.heavy.assign(n, 0);
+		W max_weight = 0;
+		for (int u = 0; u < n; ++u) {
+			std::size_t degree = 0;
+			graph.forEachNeighbor(static_cast<V>(u), [&](V, W const weight)
+			{
+				++degree;
+				max_weight = std::max(max_weight, weight);
+			});
+			adjacency.offsets[u + 1] = adjacency.offsets[u] + degree;
+		}
+		delta = std::max<Distance>(delta, (static_cast<Distance>(max_weight) + max_ring - 3) / (max_ring - 2));
+		adjacency.targets.resize(adjacency.offsets[n]);
+		adjacency.weights.resize(adjacency.offsets[n]);
+		parallel_for([&](unsigned, int const first, int const last)
+		{
+			for (int u = first; u < last; ++u) {
+				std::size_t light = adjacency.offsets[u];
+				graph.forEachNeighbor(static_cast<V>(u), [&](V const v, W const weight)
+				{
+					if (static_cast<Distance>(weight) <= delta) {
+						adjacency.targets[light] = v;
+						adjacency.weights[light++] = weight;
+					}
+				});
+				adjacency.heavy[u] = light;
+				graph.forEachNeighbor(static_cast<V>(u), [&](V const v, W const weight)
+				{
+					if (static_cast<Distance>(weight) > delta) {
+						adjacency.targets[light] = v;
+						adjacency.weights[light++] = weight;
+					}
+				});
+			}
+		});
+
+		std::vector<std::atomic<Distance>> dist(n);
+		std::vector<std::atomic<std::uint32_t>> processed(n); ///< 顶点最近一次被处理的阶段号
+		for (int v = 0; v < n; ++v) {
+			dist[v].store(infinity, std::memory_order_relaxed);
+			processed[v].store(0, std::memory_order_relaxed);
+		}
+		dist[source].store(0, std::memory_order_relaxed);
+
+		// 新距离至多比当前桶的下界大 delta - 1 + max_weight，ring 个桶足以容纳所有未决的桶
+		auto const ring = static_cast<std::size_t>(static_cast<Distance>(max_weight) / delta + 2);
+		std::vector<std::vector<std::vector<V>>> buckets(threads, std::vector<std::vector<V>>(ring));
+		std::vector<std::vector<V>> pending(threads), settled(threads);
+		buckets[0][0].push_back(source);
+
+		std::barrier sync(static_cast<std::ptrdiff_t>(threads));
+		parallel_for([&](unsigned const t, int, int)
+		{
+			auto const relax = [&](V const v, Distance const candidate, std::size_t const current)
+			{
+				Distance known = dist[v].load(std::memory_order_relaxed);
+				while (candidate < known) {
+					if (dist[v].compare_exchange_weak(known, candidate, std::memory_order_relaxed)) {
+						auto const bucket = static_cast<std::size_t>(candidate / delta);
+						(bucket == current ? pending[t] : buckets[t][bucket % ring]).push_back(v);
+						return;
+					}
+				}
+			};
+
+			std::size_t current = 0;
+			std::uint32_t phase = 0;
+			while (true) {
+				sync.arrive_and_wait();
+				std::size_t const slot = current % ring;
+				std::size_t total = 0;
+				for (unsigned k = 0; k < threads; ++k) {
+					total += buckets[k][slot].size();
+				}
+
+				if (total > 0) {
+					// 轻边阶段：处理当前桶中第 [first, last) 个顶点
+					++phase;
+					std::size_t const first = total * t / threads, last = total * (t + 1) / threads;
+					std::size_t offset = 0;
+					for (unsigned k = 0; k < threads && offset < last; ++k) {
+						auto const& items = buckets[k][slot];
+						std::size_t const begin = std::max(first, offset), end = std::min(last, offset + items.size());
+						for (std::size_t i = begin; i < end; ++i) {
+							V const u = items[i - offset];
+							Distance const d = dist[u].load(std::memory_order_relaxed);
+							if (static_cast<std::size_t>(d / delta) != current
+								|| processed[u].exchange(phase, std::memory_order_relaxed) == phase) {
+								continue;
+							}
+							settled[t].push_back(u);
+							for (std::size_t e = adjacency.offsets[u]; e < adjacency.heavy[u]; ++e) {
+								relax(adjacency.targets[e], d + adjacency.weights[e], current);
+							}
+						}
+						offset += items.size();
+					}
+					sync.arrive_and_wait();
+					buckets[t][slot].clear();
+					std::swap(buckets[t][slot], pending[t]);
+					continue;
+				}
+
+				// 重边阶段，同一顶点可能在本桶中被处理多次，取最终距离松弛一次即可
+				std::ranges::sort(settled[t]);
+				settled[t].erase(std::ranges::unique(settled[t]).begin(), settled[t].end());
+				for (V const u : settled[t]) {
+					Distance const d = dist[u].load(std::memory_order_relaxed);
+					for (std::size_t e = adjacency.heavy[u]; e < adjacency.offsets[u + 1]; ++e) {
+						relax(adjacency.targets[e], d + adjacency.weights[e], current);
+					}
+				}
+				settled[t].clear();
+				sync.arrive_and_wait();
+
+				std::size_t step = 1;
+				for (; step < ring; ++step) {
+					std::size_t const next = (current + step) % ring;
+					bool const found = std::ranges::any_of(buckets, [next](auto const& own) { return !own[next].empty(); });
+					if (found) {
+						break;
+					}
+				}
+				if (step == ring) {
+					break;
+				}
+				current += step;
+			}
+		});
+
+		// 确定性的前驱：编号最小的紧前驱
+		parallel_for([&](unsigned, int const first, int const last)
+		{
+			for (int v = first; v < last; ++v) {
+				Distance const d = dist[v].load(std::memory_order_relaxed);
+				if (d == infinity) {
+					continue;
+				}
+				result[v] = d;
+				if (v == source) {
+					continue;
+				}
+				graph.forEachInNeighbor(static_cast<V>(v), [&](V const u, W const weight)
+				{
+					Distance const du = dist[u].load(std::memory_order_relaxed);
+					if (du != infinity && du + weight == d && (prev[v] == Traits::invalid_vertex || u < prev[v])) {
+						prev[v] = u;
+					}
+				});
+			}
+		});
+		return {source, std::move(result), std::move(prev)};
+	}
+}
+
+#endif
@@ -1,6 +1,24 @@
 ﻿#include "file_io.hpp"
+#include "landmark.hpp"
+#include "ch.hpp"
+#include "hub_label.hpp"
 #include "menu.hpp"
 
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace route
 {
 	/*****************************************************************
@@ -8,85 +26,529 @@ namespace route
 	 *		IO 函数实现
 	 *
 	 *****************************************************************/
+	/* 文本解析辅助函数 */
+	/// 是否为分隔字段的空白字符（兼容 CRLF 换行）
+	inline constexpr bool is_blank(char const c) noexcept
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+	}
+
+	/**
+	 * @brief 从 rest 中取出下一个以空白分隔的字段，并将 rest 前移。
+	 * @return 字段视图，没有更多字段时返回空视图
+	 */
+	inline std::string_view next_token(std::string_view& rest) noexcept
+	{
+		std::size_t i = 0;
+		while (i < rest.size() && is_blank(rest[i])) {
+			++i;
+		}
+		std::size_t j = i;
+		while (j < rest.size() && !is_blank(rest[j])) {
+			++j;
+		}
+		std::string_view const token = rest.substr(i, j - i);
+		rest.remove_prefix(j);
+		return token;
+	}
+
+	/**
+	 * @brief 使用 std::from_chars 将整个字段解析为整数。
+	 * @return true 如果字段完整地表示一个范围内的整数
+	 */
+	template <typename T>
+	inline bool parse_number(std::string_view const token, T& value) noexcept
+	{
+		auto const [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+		return ec == std::errc{} && ptr == token.data() + token.size();
+	}
+
+	/// 坐标能否无损存入顶点表（VertexTable 以 int32 保存坐标）
+	inline constexpr bool valid_location(std::int64_t const x, std::int64_t const y) noexcept
+	{
+		return std::in_range<std::int32_t>(x) && std::in_range<std::int32_t>(y);
+	}
+
+	/**
+	 * @brief 调用记录回调；回调返回 bool 时以其值表示是否接受该记录，返回 void 时总是接受。
+	 */
+	template <typename Fn, typename... Args>
+	inline bool accept_record(Fn& fn, Args const... args)
+	{
+		if constexpr (std::is_same_v<std::invoke_result_t<Fn&, Args const...>, bool>) {
+			return fn(args...);
+		} else {
+			fn(args...);
+			return true;
+		}
+	}
+
+	/**
+	 * @brief 解析内存中的整段图文本
+	 *
+	 * 按行扫描 text，字段均以 std::string_view 引用原缓冲区，数值用 std::from_chars 转换，
+	 * 解析过程中不做任何堆分配。格式与 read_from_file 相同：
+	 * - 以 “#” 开头的行（允许前导空白）与空行被跳过；
+	 * - 顶点：[Vertex] <名称> <ID> <位置X> <位置Y> [<属性>]；
+	 * - 边：[Edge] <源顶点ID> <目标顶点ID> <权重>；
+	 * - 其他行被忽略，字段多于所需时忽略多余字段；
+	 * - 所有数值字段都必须是完整的十进制整数，“1.5” 之类的坐标按 ParseError::Number 报告，不做截断。
+	 *
+	 * @param text 图文本
+	 * @param on_vertex 顶点回调 on_vertex(name, id, x, y, attr)，name 指向 text 内部
+	 * @param on_edge 边回调 on_edge(src, dest, weight)，数值均为 std::int64_t
+	 * 两个回调可以返回 bool，返回 false 表示数值超出调用方的类型范围，该行按 ParseError::Range 报告
+	 * @param on_error 错误回调 on_error(line_number, ParseError, line)，出错的行被跳过
+	 * @param first_line text 首行的行号，用于分块解析时报告全局行号
+	 * @return ParseStats 解析统计
+	 */
+	template <typename OnVertex, typename OnEdge, typename OnError>
+	ParseStats parse_graph_text(std::string_view const text, OnVertex&& on_vertex, OnEdge&& on_edge,
+	                            OnError&& on_error, std::size_t const first_line)
+	{
+		ParseStats stats{};
+		std::size_t line_number = first_line;
+		std::size_t pos = 0;
+
+		for (; pos < text.size(); ++line_number) {
+			std::size_t eol = text.find('\n', pos);
+			if (eol == std::string_view::npos) {
+				eol = text.size();
+			}
+			std::string_view const line = text.substr(pos, eol - pos);
+			pos = eol + 1;
+			++stats.lines;
+
+			std::string_view rest = line;
+			std::string_view const head = next_token(rest);
+
+			// 跳过空行和注释行
+			if (head.empty() || head.front() == '#') {
+				continue;
+			}
+
+			if (head == "[Vertex]") {
+				std::array<std::string_view, 5> fields{};
+				std::size_t count = 0;
+				while (count < fields.size() && !(fields[count] = next_token(rest)).empty()) {
+					++count;
+				}
+				if (count < 4) {
+					++stats.errors;
+					on_error(line_number, ParseError::VertexFormat, line);
+					continue;
+				}
+
+				std::int64_t id{}, x{}, y{};
+				int attr_value = 0;
+				if (!parse_number(fields[1], id) || !parse_number(fields[2], x) || !parse_number(fields[3], y)
+					|| (count == 5 && !parse_number(fields[4], attr_value))) {
+					++stats.errors;
+					on_error(line_number, ParseError::Number, line);
+					continue;
+				}
+
+				if (!accept_record(on_vertex, fields[0], id, x, y, static_cast<Attribute>(attr_value))) {
+					++stats.errors;
+					on_error(line_number, ParseError::Range, line);
+					continue;
+				}
+				++stats.vertices;
+			}
+			else if (head == "[Edge]") {
+				std::array<std::string_view, 3> fields{};
+				std::size_t count = 0;
+				while (count < fields.size() && !(fields[count] = next_token(rest)).empty()) {
+					++count;
+				}
+				if (count < 3) {
+					++stats.errors;
+					on_error(line_number, ParseError::EdgeFormat, line);
+					continue;
+				}
+
+				std::int64_t src{}, dest{}, weight{};
+				if (!parse_number(fields[0], src) || !parse_number(fields[1], dest) || !parse_number(fields[2], weight)) {
+					++stats.errors;
+					on_error(line_number, ParseError::Number, line);
+					continue;
+				}
+
+				if (!accept_record(on_edge, src, dest, weight)) {
+					++stats.errors;
+					on_error(line_number, ParseError::Range, line);
+					continue;
+				}
+				++stats.edges;
+			}
+		}
+
+		return stats;
+	}
+
+	/**
+	 * @brief 将解析错误打印到标准错误流。
+	 */
+	inline void print_parse_error(std::size_t const line_number, ParseError const error, std::string_view const line)
+	{
+		std::string_view message;
+		switch (error) {
+		case ParseError::VertexFormat:
+			message = "顶点格式错误";
+			break;
+		case ParseError::EdgeFormat:
+			message = "边格式错误";
+			break;
+		case ParseError::Number:
+			message = "数值格式错误";
+			break;
+		case ParseError::Range:
+			message = "数值超出范围";
+			break;
+		}
+		std::println(std::cerr, "第 {} 行: {}: {}", line_number, message, line);
+	}
+
+	/**
+	 * @brief 将整个文件读入内存。
+	 * @return 文件内容，无法打开时返回空
+	 */
+	inline auto read_file_buffer(const std::string& filename) -> std::optional<std::string>
+	{
+		std::ifstream file(filename, std::ios::binary);
+		if (!file.is_open()) {
+			return std::nullopt;
+		}
+
+		file.seekg(0, std::ios::end);
+		auto const size = file.tellg();
+		file.seekg(0, std::ios::beg);
+
+		std::string buffer(size > 0 ? static_cast<std::size_t>(size) : 0, '\0');
+		file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		buffer.resize(static_cast<std::size_t>(file.gcount()));
+		return buffer;
+	}
+
 	/**
 	 * @brief 从文件中读取图数据
 	 * 
-	 * 该函数尝试打开指定的文件，并解析其中的内容以构建图的顶点和边。
+	 * 该函数将指定文件一次性读入内存，再由 parse_graph_text 解析其中的内容以构建图的顶点和边。
 	 * 文件中的每一行代表一个顶点或一条边，格式如下：
-	 * - 顶点：Vertex <名称> <ID> <位置X> <位置Y> [<属性>]
-	 * - 边：Edge <源顶点ID> <目标顶点ID> <权重>
+	 * - 顶点：[Vertex] <名称> <ID> <位置X> <位置Y> [<属性>]
+	 * - 边：[Edge] <源顶点ID> <目标顶点ID> <权重>
+	 * 格式错误的行（包括带小数的坐标），以及顶点编号超出 V、坐标超出 int32、权重超出 W 表示范围的行，
+	 * 会连同行号打印到标准错误流并被跳过。
 	 * @param graph 图
 	 * @param filename 文件路径
 	 * @return true 如果文件成功打开并解析
-	 * @return false 如果文件无法打开或解析过程中出现错误
+	 * @return false 如果文件无法打开
 	 */
-	bool read_from_file(WeightedAdjMatrixGraph& graph, const std::string& filename)
+	template <typename V, typename W>
+	bool read_from_file(WeightedAdjMatrixGraph<V, W>& graph, const std::string& filename)
 	{
-	    std::ifstream file(filename);
-	    if (!file.is_open()) {
+	    auto const buffer = read_file_buffer(filename);
+	    if (!buffer.has_value()) {
 	        std::cerr << "无法打开文件: " << filename << "\n";
 	        return false;
 	    }
 
-	    std::string line;
-	    while (std::getline(file, line)) {
-	        // 跳过空行和注释行
-	        if (line.empty() || line[0] == '#') {
-	            continue;
-	        }
-
-	        // 去掉行首的空白字符（如果有的话）
-	        size_t start = line.find_first_not_of(" \t");
-	        if (start == std::string::npos) {
-	            continue;  // 空行或全是空白字符的行
-	        }
-	        line = line.substr(start);
-
-	        std::istringstream iss(line);
-	        std::vector<std::string> tokens;
-	        std::string token;
-	        while (iss >> token) {
-	            tokens.push_back(token);
-	        }
-
-	        if (tokens.empty()) {
-	            continue;
-	        }
-
-	        if (tokens[0] == "[Vertex]") {
-	            if (tokens.size() < 5) {
-	                std::cerr << "顶点格式错误: " << line << "\n";
-	                continue;
+	    parse_graph_text(*buffer,
+	        [&](std::string_view const name, std::int64_t const id, std::int64_t const x, std::int64_t const y,
+	            Attribute const attr)
+	        {
+	            if (!std::in_range<V>(id) || !valid_location(x, y)) {
+	                return false;
 	            }
-
-	            std::string const& name = tokens[1];
-	            IntType id = std::stoi(tokens[2]);
-	            int locationA = std::stoi(tokens[3]);
-	            int locationB = std::stoi(tokens[4]);
-	            auto attr = Attribute::Empty;
-	            if (tokens.size() >= 6) {
-	                int attrValue = std::stoi(tokens[5]);
-	                attr = static_cast<Attribute>(attrValue);
+	            graph.addVertex(name, static_cast<IntType>(id), {static_cast<IntType>(x), static_cast<IntType>(y)}, attr);
+	            return true;
+	        },
+	        [&](std::int64_t const src, std::int64_t const dest, std::int64_t const weight)
+	        {
+	            if (!std::in_range<V>(src) || !std::in_range<V>(dest) || !std::in_range<W>(weight)) {
+	                return false;
 	            }
+	            graph.addEdge(static_cast<V>(src), static_cast<V>(dest), static_cast<W>(weight));
+	            return true;
+	        },
+	        print_parse_error);
 
-	            auto vertex = Object::create(name, id, {locationA, locationB}, attr);
-	            graph.addVertex(vertex);
-	        }
-	        else if (tokens[0] == "[Edge]") {
-	            if (tokens.size() < 4) {
-	                std::cerr << "边格式错误: " << line << "\n";
-	                continue;
-	            }
+	    graph.finalize();
+	    return true;
+	}
 
-	            int src = std::stoi(tokens[1]);
-	            int dest = std::stoi(tokens[2]);
-	            int weight = std::stoi(tokens[3]);
-	            graph.addEdge(src, dest, weight);
-	        }
-	    }
+	/**
+	 * @brief 一个文本块的解析结果，字段引用原缓冲区。
+	 */
+	struct ParsedChunk {
+	    struct VertexRecord {
+	        std::string_view name;
+	        std::int64_t id, x, y;
+	        Attribute attr;
+	    };
+	    struct EdgeRecord {
+	        std::int64_t src, dest, weight;
+	    };
+	    struct ErrorRecord {
+	        std::size_t line; ///< 块内行号，从 0 开始
+	        ParseError error;
+	        std::string_view text;
+	    };
 
-	    file.close();
-	    return true;
+	    std::vector<VertexRecord> vertices{};
+	    std::vector<EdgeRecord> edges{};
+	    std::vector<ErrorRecord> errors{};
+	    ParseStats stats{};
+	};
+
+	/**
+	 * @brief 将 text 切分为不超过 count 个以换行结尾的块。
+	 *
+	 * 除最后一块外，每块都恰好结束在换行符之后，因此块内行数即为块内换行符个数。
+	 */
+	inline auto split_lines(std::string_view const text, std::size_t const count) -> std::vector<std::string_view>
+	{
+		std::vector<std::string_view> chunks;
+		chunks.reserve(count);
+		std::size_t const target = text.size() / std::max<std::size_t>(count, 1);
+		std::size_t begin = 0;
+		while (begin < text.size()) {
+			std::size_t end = chunks.size() + 1 < count ? begin + std::max<std::size_t>(target, 1) : text.size();
+			if (end < text.size()) {
+				end = text.find('\n', end - 1);
+				end = end == std::string_view::npos ? text.size() : end + 1;
+			} else {
+				end = text.size();
+			}
+			chunks.push_back(text.substr(begin, end - begin));
+			begin = end;
+		}
+		return chunks;
+	}
+
+	/**
+	 * @brief 多线程读取图数据
+	 *
+	 * 文件被映射到内存后按换行切分为若干块，每个线程用 parse_graph_text 将一块解析到各自的缓冲区，
+	 * 最后按块的先后顺序把顶点、边和错误依次应用到图上。数值范围在解析时检查，由于合并顺序与文件顺序一致，
+	 * 重复边、越界边的处理以及错误输出都与 read_from_file 完全相同。
+	 * 小于 chunk_bytes 的文件只使用一个块。
+	 * @param graph 图
+	 * @param filename 文件路径
+	 * @param threads 线程数，0 表示使用硬件并发数
+	 * @return true 如果文件成功打开并解析
+	 * @return false 如果文件无法打开
+	 */
+	template <typename V, typename W>
+	bool read_from_file_parallel(WeightedAdjMatrixGraph<V, W>& graph, const std::string& filename, unsigned threads)
+	{
+		constexpr std::size_t chunk_bytes = std::size_t{1} << 20; ///< 每块的最小字节数
+
+		MappedFile file;
+		if (!file.open(filename)) {
+			// 空文件或无法映射的文件交给顺序读取处理
+			return read_from_file(graph, filename);
+		}
+		std::string_view const text(reinterpret_cast<char const*>(file.data()), file.size());
+
+		if (threads == 0) {
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		std::size_t const count = std::clamp<std::size_t>(text.size() / chunk_bytes, 1, threads);
+		auto const chunks = split_lines(text, count);
+
+		// 各块独立解析
+		std::vector<ParsedChunk> parsed(chunks.size());
+		std::vector<std::future<void>> futures;
+		futures.reserve(chunks.size());
+		for (std::size_t i = 0; i < chunks.size(); ++i) {
+			futures.emplace_back(std::async(std::launch::async, [&chunk = chunks[i], &out = parsed[i]]()
+			{
+				out.stats = parse_graph_text(chunk,
+					[&](std::string_view const name, std::int64_t const id, std::int64_t const x, std::int64_t const y,
+					    Attribute const attr)
+					{
+						if (!std::in_range<V>(id) || !valid_location(x, y)) {
+							return false;
+						}
+						out.vertices.push_back({name, id, x, y, attr});
+						return true;
+					},
+					[&](std::int64_t const src, std::int64_t const dest, std::int64_t const weight)
+					{
+						if (!std::in_range<V>(src) || !std::in_range<V>(dest) || !std::in_range<W>(weight)) {
+							return false;
+						}
+						out.edges.push_back({src, dest, weight});
+						return true;
+					},
+					[&](std::size_t const line, ParseError const error, std::string_view const line_text)
+					{
+						out.errors.push_back({line, error, line_text});
+					},
+					0);
+			}));
+		}
+		for (auto& future : futures) {
+			future.get();
+		}
+
+		// 按文件顺序合并
+		std::size_t total_edges = 0;
+		for (auto const& chunk : parsed) {
+			total_edges += chunk.edges.size();
+		}
+		graph.reserve(total_edges);
+
+		std::size_t first_line = 1;
+		for (auto const& chunk : parsed) {
+			for (auto const& [name, id, x, y, attr] : chunk.vertices) {
+				graph.addVertex(name, static_cast<IntType>(id), {static_cast<IntType>(x), static_cast<IntType>(y)}, attr);
+			}
+			for (auto const& [src, dest, weight] : chunk.edges) {
+				graph.addEdge(static_cast<V>(src), static_cast<V>(dest), static_cast<W>(weight));
+			}
+			for (auto const& [line, error, line_text] : chunk.errors) {
+				print_parse_error(first_line + line, error, line_text);
+			}
+			first_line += chunk.stats.lines;
+		}
+
+		graph.finalize();
+		return true;
+	}
+
+	/*****************************************************************
+	 *
+	 *		自动确定规模的读取
+	 *
+	 *****************************************************************/
+	inline bool VertexIdMap::identity() const noexcept
+	{
+		return original.empty() || (original.front() == 0 && original.back() == size() - 1);
+	}
+
+	inline int VertexIdMap::dense(std::int64_t const id) const noexcept
+	{
+		if (identity()) {
+			return id >= 0 && id < size() ? static_cast<int>(id) : -1;
+		}
+		auto const it = std::ranges::lower_bound(original, id);
+		return it != original.end() && *it == id ? static_cast<int>(it - original.begin()) : -1;
+	}
+
+	/**
+	 * @brief 读取图文件并按文件内容确定图的规模
+	 *
+	 * 第一遍只解析不建图：收集 [Vertex] 行与 [Edge] 行中出现的全部顶点编号，统计边数与名称总长度，
+	 * 格式错误的行、坐标超出 int32 的顶点与权重超出 W 表示范围的边在这一遍打印，第二遍跳过同样的行。
+	 * 编号排序去重后得到 VertexIdMap，图据此一次性按准确的顶点数构造，
+	 * 边缓冲区与名称池也按统计值预留，第二遍逐行写入时不再重新分配。
+	 * 文件编号不必从 0 开始或连续，图内统一使用映射后的连续编号；映射同时保存在图中（见 setVertexIds），
+	 * write_to_file 与打印函数据此还原文件中的编号。
+	 * @param filename 文件路径
+	 * @param storage 邻接存储方式
+	 * @return 图及编号映射；文件无法打开或顶点数超出 V 的表示范围时返回 std::nullopt
+	 */
+	template <typename V, typename W>
+	auto load_graph(const std::string& filename, Storage const storage) -> std::optional<LoadedGraph<V, W>>
+	{
+		auto const buffer = read_file_buffer(filename);
+		if (!buffer.has_value()) {
+			std::cerr << "无法打开文件: " << filename << "\n";
+			return std::nullopt;
+		}
+
+		// 第一遍：收集顶点编号。ids 超过上次去重后大小的两倍时再去重一次，内存与不同编号数同阶
+		std::vector<std::int64_t> ids;
+		std::size_t compacted = 0;
+		std::size_t edges = 0;
+		std::size_t name_bytes = 0;
+		auto const compact = [&ids, &compacted]()
+		{
+			std::ranges::sort(ids);
+			ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+			compacted = ids.size();
+		};
+		auto const collect = [&](std::int64_t const id)
+		{
+			ids.push_back(id);
+			if (ids.size() >= 2 * compacted + 1024) {
+				compact();
+			}
+		};
+		ParseStats const stats = parse_graph_text(*buffer,
+			[&](std::string_view const name, std::int64_t const id, std::int64_t const x, std::int64_t const y,
+			    Attribute)
+			{
+				if (!valid_location(x, y)) {
+					return false;
+				}
+				collect(id);
+				name_bytes += name.size();
+				return true;
+			},
+			[&](std::int64_t const src, std::int64_t const dest, std::int64_t const weight)
+			{
+				if (!std::in_range<W>(weight)) {
+					return false;
+				}
+				collect(src);
+				collect(dest);
+				++edges;
+				return true;
+			},
+			print_parse_error);
+		compact();
+
+		if (ids.size() > static_cast<std::size_t>(GraphTraits<V, W>::max_vertices)) {
+			std::cerr << "顶点数超出顶点编号类型的表示范围: " << filename << "\n";
+			return std::nullopt;
+		}
+
+		LoadedGraph<V, W> loaded{
+			WeightedAdjMatrixGraph<V, W>(static_cast<int>(ids.size()), storage),
+			VertexIdMap{std::move(ids)},
+			stats
+		};
+		auto& graph = loaded.graph;
+		VertexIdMap const& map = loaded.ids;
+		graph.setVertexIds(map);
+		graph.reserve(edges, name_bytes);
+
+		// 第二遍：按映射后的编号建图，错误已在第一遍报告
+		parse_graph_text(*buffer,
+			[&](std::string_view const name, std::int64_t const id, std::int64_t const x, std::int64_t const y,
+			    Attribute const attr)
+			{
+				if (valid_location(x, y)) {
+					graph.addVertex(name, map.dense(id), {static_cast<IntType>(x), static_cast<IntType>(y)}, attr);
+				}
+			},
+			[&](std::int64_t const src, std::int64_t const dest, std::int64_t const weight)
+			{
+				if (std::in_range<W>(weight)) {
+					graph.addEdge(static_cast<V>(map.dense(src)), static_cast<V>(map.dense(dest)), static_cast<W>(weight));
+				}
+			},
+			[](std::size_t, ParseError, std::string_view) {});
+
+		graph.finalize();
+		return loaded;
+	}
+
+	/**
+	 * @brief 用 std::to_chars 将整数逐个以空格为前缀追加到 out，并以换行结尾。
+	 */
+	template <typename... Ints>
+	inline void append_fields(std::string& out, Ints const... values)
+	{
+		std::array<char, (sizeof...(Ints)) * 21 + 1> buffer; // 每个字段至多 1 个空格与 20 个字符
+		char* ptr = buffer.data();
+		char* const last = buffer.data() + buffer.size() - 1; // 留给换行符
+		((*ptr++ = ' ', ptr = std::to_chars(ptr, last, values).ptr), ...);
+		*ptr++ = '\n';
+		out.append(buffer.data(), ptr);
 	}
 
 	/**
@@ -94,39 +556,1143 @@ namespace route
 	 * 
 	 * 该函数将当前图的所有顶点和边信息写入指定的文件。
 	 * 文件格式与 readFromFile 函数读取的格式相同，便于后续读取和解析。
+	 * 记录先用 std::to_chars 格式化到可复用的大缓冲区，缓冲区写满 flush_bytes 后一次性写出；
+	 * 边通过 forEachNeighbor 遍历，Csr 模式下只访问实际存在的边。
+	 * threads 大于 1 时按顶点区间分块并行格式化，各块仍按顶点顺序写出，输出与单线程完全相同。
+	 * 顶点编号按图中保存的映射（见 setVertexIds）写为输入文件中的编号。
 	 *
 	 * @param graph 图
 	 * @param filename 文件路径
+	 * @param threads 格式化使用的线程数，0 表示使用硬件并发数
 	 * @return true 如果文件成功打开并写入
 	 * @return false 如果文件无法打开或写入过程中出现错误
 	 */
-	bool write_to_file(WeightedAdjMatrixGraph& graph, const std::string& filename)
+	template <typename V, typename W>
+	bool write_to_file(WeightedAdjMatrixGraph<V, W>& graph, const std::string& filename, unsigned threads)
 	{
-		std::ofstream file(filename);
+		constexpr std::size_t flush_bytes = std::size_t{1} << 20; ///< 单线程缓冲区的写出阈值
+		constexpr int blocks_per_thread = 8; ///< 每个线程每轮处理的块数
+
+		// 文本格式中的 [Edge] 表示无向边，无法表示 addArc 添加的有向弧
+		if (!graph.m_symmetric) {
+			std::cerr << "有向图无法写入文本格式: " << filename << "\n";
+			return false;
+		}
+
+		// 以二进制模式打开，换行符在各平台上都保持为 LF
+		std::ofstream file(filename, std::ios::binary);
 		if (!file.is_open()) {
 			std::cerr << "无法打开文件: " << filename << "\n";
 			return false;
 		}
 
-		// 写入顶点
-		std::println(file, "# 支持 “#” 号 行注释\n\n# [VERTEX] LISTS");
-		for (const auto& vertex : graph.m_vertexMap | std::views::values) {
-			std::println(file, "[Vertex] {} {} {} {} {}",
-				vertex->m_name, vertex->m_id, vertex->m_location.first, vertex->m_location.second,
-				static_cast<int>(vertex->m_attr));
-		}
+		VertexTable const& table = graph.m_vertexTable;
+		int const vertices = graph.m_vertices;
 
-		// 写入边
-		std::println(file, "\n# [EDGE] LISTS");
-		for (int i = 0; i < graph.m_vertices; ++i) {
-			for (int j = i + 1; j < graph.m_vertices; ++j) {
-				if (graph.m_adjMatrix[i][j] != -1) {
-					std::println(file, "[Edge] {} {} {}", i, j, graph.m_adjMatrix[i][j]);
+		// 将顶点区间 [first, last) 内的顶点与边分别追加到缓冲区
+		VertexIdMap const& ids = graph.m_ids;
+		auto const format_vertices = [&table, &ids](int const first, int const last, std::string& out)
+		{
+			for (int id = first; id < last; ++id) {
+				if (table.contains(id)) {
+					out += "[Vertex] ";
+					out += table.name(id);
+					append_fields(out, ids.external(id), table.x(id), table.y(id), static_cast<int>(table.attr(id)));
 				}
 			}
+		};
+		auto const format_edges = [&graph, &ids](int const first, int const last, std::string& out)
+		{
+			for (int i = first; i < last; ++i) {
+				graph.forEachNeighbor(static_cast<V>(i), [&](V const j, W const weight)
+				{
+					if (static_cast<int>(j) > i) {
+						out += "[Edge]";
+						append_fields(out, ids.external(i), ids.external(static_cast<int>(j)), weight);
+					}
+				});
+			}
+		};
+		auto const write = [&file](std::string& out)
+		{
+			file.write(out.data(), static_cast<std::streamsize>(out.size()));
+			out.clear();
+		};
+
+		if (threads == 0) {
+			threads = std::max(1u, std::thread::hardware_concurrency());
 		}
 
+		// 依次格式化顶点与边两段，每段按顶点区间分块
+		auto const emit = [&](auto const& format)
+		{
+			if (threads <= 1) {
+				std::string buffer;
+				buffer.reserve(flush_bytes + 4096);
+				for (int first = 0; first < vertices; ) {
+					// 每次格式化一小段顶点，缓冲区超过阈值后写出
+					int const last = std::min(vertices, first + 1024);
+					format(first, last, buffer);
+					if (buffer.size() >= flush_bytes) {
+						write(buffer);
+					}
+					first = last;
+				}
+				write(buffer);
+				return;
+			}
+
+			int const blocks = static_cast<int>(threads) * blocks_per_thread;
+			int const rows = std::max(1, (vertices + blocks - 1) / blocks);
+			std::vector<std::string> buffers(threads);
+			for (int wave = 0; wave < vertices; wave += rows * static_cast<int>(threads)) {
+				std::vector<std::future<void>> futures;
+				futures.reserve(threads);
+				for (unsigned t = 0; t < threads; ++t) {
+					int const first = std::min(vertices, wave + static_cast<int>(t) * rows);
+					int const last = std::min(vertices, first + rows);
+					futures.emplace_back(std::async(std::launch::async, [&, first, last, t]()
+					{
+						format(first, last, buffers[t]);
+					}));
+				}
+				for (unsigned t = 0; t < threads; ++t) {
+					futures[t].get();
+					write(buffers[t]);
+				}
+			}
+		};
+
+		constexpr std::string_view vertex_header = "# 支持 “#” 号 行注释\n\n# [VERTEX] LISTS\n";
+		constexpr std::string_view edge_header = "\n# [EDGE] LISTS\n";
+		file.write(vertex_header.data(), static_cast<std::streamsize>(vertex_header.size()));
+		emit(format_vertices);
+		file.write(edge_header.data(), static_cast<std::streamsize>(edge_header.size()));
+		emit(format_edges);
+
 		file.close();
+		return !file.fail();
+	}
+
+	/*****************************************************************
+	 *
+	 *		二进制快照
+	 *
+	 *****************************************************************/
+	/* 内存映射 */
+	inline MappedFile::~MappedFile()
+	{
+		if (m_data == nullptr) {
+			return;
+		}
+#ifdef _WIN32
+		UnmapViewOfFile(m_data);
+#else
+		munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+	}
+
+	inline bool MappedFile::open(const std::string& filename)
+	{
+		if (m_data != nullptr) {
+			return false;
+		}
+#ifdef _WIN32
+		HANDLE const file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+			CloseHandle(file);
+			return false;
+		}
+		HANDLE const mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (mapping == nullptr) {
+			return false;
+		}
+		void const* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping); // 视图会保持映射对象存活
+		if (view == nullptr) {
+			return false;
+		}
+		m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+		int const fd = ::open(filename.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+		struct stat st{};
+		if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+			close(fd);
+			return false;
+		}
+		void* view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+		close(fd); // 映射建立后即可关闭描述符
+		if (view == MAP_FAILED) {
+			return false;
+		}
+		m_size = static_cast<std::size_t>(st.st_size);
+#endif
+		m_data = static_cast<std::byte const*>(view);
 		return true;
-	}	
+	}
+
+	/* 快照格式 */
+	namespace snapshot
+	{
+		inline constexpr std::array<char, 8> magic{'R', 'T', 'G', 'R', 'A', 'P', 'H', '\0'};
+		inline constexpr std::uint32_t version = 4;
+		inline constexpr std::uint32_t endian_marker = 0x01020304;
+		inline constexpr std::size_t alignment = 64; ///< 数据段按缓存行对齐，与 DenseMatrix 一致
+
+		/// 数据段种类
+		enum class Section : std::uint32_t
+		{
+			X = 0, Y, Attr, NameOffset, NameLength, NamePool, // 顶点表
+			Offsets, Targets, Weights, // CSR
+			Matrix, // 邻接矩阵
+			Ids, // 文件中的顶点编号（VertexIdMap），恒等映射时为空
+		};
+		inline constexpr std::uint32_t section_kinds = 11;
+
+		/**
+		 * @brief 文件头，位于文件起始处。
+		 *
+		 * 之后紧跟 section_count 个 SectionEntry，再之后是各个对齐的数据段。
+		 * checksum 覆盖文件头之后的全部字节；source_size 与 source_mtime 记录生成快照时的源文件，为 0 表示未记录。
+		 */
+		struct Header {
+		    std::array<char, 8> magic;
+		    std::uint32_t version;
+		    std::uint32_t endian;
+		    std::uint8_t vertex_size, vertex_signed; ///< 顶点编号类型
+		    std::uint8_t weight_size, weight_signed; ///< 权重类型
+		    std::uint8_t storage; ///< Storage
+		    std::uint8_t directed; ///< 是否含有向弧
+		    std::uint8_t reserved[2];
+		    std::uint32_t section_count;
+		    std::uint32_t matrix_stride; ///< 邻接矩阵行跨度，Csr 模式为 0
+		    std::uint64_t vertices;
+		    std::uint64_t edges;
+		    std::uint64_t checksum; ///< FNV-1a 64
+		    double heuristic_scale; ///< A* 启发函数系数，避免加载后重新扫描全部边
+		    std::uint64_t source_size; ///< 源文件字节数
+		    std::int64_t source_mtime; ///< 源文件修改时间（file_time_type 的计数）
+		};
+
+		struct SectionEntry {
+		    std::uint32_t kind;
+		    std::uint32_t reserved;
+		    std::uint64_t offset; ///< 相对文件起始的字节偏移
+		    std::uint64_t bytes; ///< 数据段字节数
+		};
+
+		static_assert(std::is_trivially_copyable_v<Header> && std::is_trivially_copyable_v<SectionEntry>);
+
+		/// 源文件的大小与修改时间
+		struct SourceStamp {
+		    std::uint64_t size;
+		    std::int64_t mtime;
+		};
+
+		/// 读取源文件的大小与修改时间，文件不存在或无法访问时返回 std::nullopt
+		inline std::optional<SourceStamp> source_stamp(const std::string& filename)
+		{
+			std::error_code ec;
+			auto const size = std::filesystem::file_size(filename, ec);
+			if (ec) {
+				return std::nullopt;
+			}
+			auto const time = std::filesystem::last_write_time(filename, ec);
+			if (ec) {
+				return std::nullopt;
+			}
+			return SourceStamp{static_cast<std::uint64_t>(size),
+			                   static_cast<std::int64_t>(time.time_since_epoch().count())};
+		}
+
+		/// FNV-1a 64 位散列
+		inline std::uint64_t fnv1a(std::byte const* data, std::size_t const size) noexcept
+		{
+			std::uint64_t hash = 0xcbf29ce484222325ULL;
+			for (std::size_t i = 0; i < size; ++i) {
+				hash ^= static_cast<std::uint64_t>(data[i]);
+				hash *= 0x100000001b3ULL;
+			}
+			return hash;
+		}
+
+		/// 将 store 的内容作为 kind 数据段追加到 out 末尾（按 alignment 对齐）
+		template <typename Store>
+		inline void append_section(std::vector<std::byte>& out, std::vector<SectionEntry>& table,
+		                           Section const kind, Store const& store)
+		{
+			std::size_t const offset = (out.size() + alignment - 1) / alignment * alignment;
+			std::size_t const bytes = store.size() * sizeof(*store.data());
+			out.resize(offset + bytes);
+			if (bytes > 0) {
+				std::memcpy(out.data() + offset, store.data(), bytes);
+			}
+			table.push_back({static_cast<std::uint32_t>(kind), 0, offset, bytes});
+		}
+
+		/// 将数据段解释为 T 数组，段缺失、越界、未对齐或元素个数不为 expected 时返回 std::nullopt
+		template <typename T>
+		inline auto section_view(MappedFile const& file, std::optional<SectionEntry> const& entry,
+		                         std::size_t const expected = std::dynamic_extent)
+			-> std::optional<std::span<T const>>
+		{
+			if (!entry.has_value() || entry->offset > file.size() || entry->bytes > file.size() - entry->offset
+				|| entry->offset % alignof(T) != 0 || entry->bytes % sizeof(T) != 0) {
+				return std::nullopt;
+			}
+			auto const count = static_cast<std::size_t>(entry->bytes / sizeof(T));
+			if (expected != std::dynamic_extent && count != expected) {
+				return std::nullopt;
+			}
+			return std::span<T const>(reinterpret_cast<T const*>(file.data() + entry->offset), count);
+		}
+	}
+
+	/**
+	 * @brief 将图保存为二进制快照
+	 *
+	 * 快照直接保存顶点表、CSR 或邻接矩阵的内存表示以及文件中的顶点编号，load_snapshot 映射文件后原地使用这些数组，
+	 * 启动时无需解析文本。快照带有版本号、字节序标记和类型标签，只能由相同 V、W 的图读取。
+	 * Csr 模式下会先调用 finalize 合并待插入的边。给出 source 时记录其大小与修改时间，
+	 * 之后 load_snapshot 据此判断快照是否已过期。
+	 * @param graph 图
+	 * @param filename 文件路径
+	 * @param source 生成该图的文本文件，为空表示不记录
+	 * @return true 如果写入成功
+	 */
+	template <typename V, typename W>
+	bool save_snapshot(WeightedAdjMatrixGraph<V, W>& graph, const std::string& filename, const std::string& source)
+	{
+		using namespace snapshot;
+		SourceStamp stamp{0, 0};
+		if (!source.empty()) {
+			if (auto const current = source_stamp(source)) {
+				stamp = *current;
+			} else {
+				std::cerr << "无法读取源文件信息: " << source << "\n";
+				return false;
+			}
+		}
+		graph.finalize();
+
+		VertexTable const& table = graph.m_vertexTable;
+		std::uint32_t const section_count = graph.m_storage == Storage::Csr ? 10 : 8;
+
+		std::vector<std::byte> out(sizeof(Header) + section_count * sizeof(SectionEntry));
+		std::vector<SectionEntry> sections;
+		sections.reserve(section_count);
+
+		append_section(out, sections, Section::X, table.m_x);
+		append_section(out, sections, Section::Y, table.m_y);
+		append_section(out, sections, Section::Attr, table.m_attr);
+		append_section(out, sections, Section::NameOffset, table.m_nameOffset);
+		append_section(out, sections, Section::NameLength, table.m_nameLength);
+		append_section(out, sections, Section::NamePool, table.m_namePool);
+		if (graph.m_storage == Storage::Csr) {
+			append_section(out, sections, Section::Offsets, graph.m_csr.offsets);
+			append_section(out, sections, Section::Targets, graph.m_csr.targets);
+			append_section(out, sections, Section::Weights, graph.m_csr.weights);
+		} else {
+			append_section(out, sections, Section::Matrix, graph.m_adjMatrix.storage());
+		}
+		append_section(out, sections, Section::Ids, graph.m_ids.original);
+		std::memcpy(out.data() + sizeof(Header), sections.data(), sections.size() * sizeof(SectionEntry));
+
+		Header header{};
+		header.magic = magic;
+		header.version = version;
+		header.endian = endian_marker;
+		header.vertex_size = sizeof(V);
+		header.vertex_signed = std::is_signed_v<V>;
+		header.weight_size = sizeof(W);
+		header.weight_signed = std::is_signed_v<W>;
+		header.storage = static_cast<std::uint8_t>(graph.m_storage);
+		header.directed = graph.m_symmetric ? 0 : 1;
+		header.section_count = section_count;
+		header.matrix_stride = graph.m_storage == Storage::Matrix
+			? static_cast<std::uint32_t>(graph.m_adjMatrix.stride()) : 0;
+		header.vertices = static_cast<std::uint64_t>(graph.m_vertices);
+		header.edges = static_cast<std::uint64_t>(graph.m_edges);
+		header.heuristic_scale = graph.m_heuristicScale;
+		header.source_size = stamp.size;
+		header.source_mtime = stamp.mtime;
+		header.checksum = fnv1a(out.data() + sizeof(Header), out.size() - sizeof(Header));
+		std::memcpy(out.data(), &header, sizeof(Header));
+
+		std::ofstream file(filename, std::ios::binary);
+		if (!file.is_open()) {
+			std::cerr << "无法打开文件: " << filename << "\n";
+			return false;
+		}
+		file.write(reinterpret_cast<char const*>(out.data()), static_cast<std::streamsize>(out.size()));
+		return file.good();
+	}
+
+	/**
+	 * @brief 映射二进制快照并原地构建图
+	 *
+	 * 顶点表与邻接数组直接引用映射的内存，不解析也不复制；返回的图（及其拷贝）共享该映射，
+	 * 最后一个引用释放时解除映射。之后若修改图（如 addVertex、addEdge），被修改的数组会先复制为自有数据。
+	 * 每次加载都检查文件头、类型标签、各数据段的边界，以及映射后会被直接下标访问的不变式：
+	 * 每个名称区间位于名称池内，CSR 行偏移单调不减，目标顶点小于顶点数，顶点编号映射为空或 n 个严格递增的编号。
+	 * 这些检查为 O(V + E)，截断或损坏的文件在这里被拒绝，而不会在之后越界读取。逐字节校验需要读遍整个文件且每字节一次乘法，
+	 * 默认关闭，可通过 verify_checksum 开启。给出 source 时，快照记录的源文件大小与修改时间必须与其当前状态相同，
+	 * 否则视为过期而拒绝，调用方应重新解析源文件。
+	 * @param filename 文件路径
+	 * @param verify_checksum 是否校验数据的 FNV-1a 散列
+	 * @param source 生成快照的文本文件，为空表示不检查
+	 * @return 图；文件无法映射、格式不符或已过期时返回 std::nullopt
+	 */
+	template <typename V, typename W>
+	std::optional<WeightedAdjMatrixGraph<V, W>> load_snapshot(const std::string& filename, bool const verify_checksum,
+	                                                          const std::string& source)
+	{
+		using namespace snapshot;
+		using Traits = GraphTraits<V, W>;
+
+		auto const file = std::make_shared<MappedFile>();
+		if (!file->open(filename)) {
+			std::cerr << "无法打开文件: " << filename << "\n";
+			return std::nullopt;
+		}
+		auto const fail = [&](char const* reason) -> std::optional<WeightedAdjMatrixGraph<V, W>>
+		{
+			std::cerr << "快照无效: " << filename << ": " << reason << "\n";
+			return std::nullopt;
+		};
+
+		Header header{};
+		if (file->size() < sizeof(Header)) {
+			return fail("文件过短");
+		}
+		std::memcpy(&header, file->data(), sizeof(Header));
+		if (header.magic != magic || header.version != version) {
+			return fail("文件头或版本不匹配");
+		}
+		if (header.endian != endian_marker) {
+			return fail("字节序不匹配");
+		}
+		if (!source.empty()) {
+			auto const stamp = source_stamp(source);
+			if (!stamp || stamp->size != header.source_size || stamp->mtime != header.source_mtime) {
+				return fail("源文件已修改");
+			}
+		}
+		if (header.vertex_size != sizeof(V) || header.vertex_signed != std::is_signed_v<V>
+			|| header.weight_size != sizeof(W) || header.weight_signed != std::is_signed_v<W>) {
+			return fail("顶点或权重类型不匹配");
+		}
+		if (header.storage > static_cast<std::uint8_t>(Storage::Csr)
+			|| header.vertices > static_cast<std::uint64_t>(Traits::max_vertices)
+			|| !std::in_range<IntType>(header.edges)
+			|| !(header.heuristic_scale >= 0.0) || !std::isfinite(header.heuristic_scale)) {
+			return fail("存储方式或规模无效");
+		}
+		if (header.section_count > section_kinds
+			|| file->size() - sizeof(Header) < header.section_count * sizeof(SectionEntry)) {
+			return fail("数据段表越界");
+		}
+		if (verify_checksum && fnv1a(file->data() + sizeof(Header), file->size() - sizeof(Header)) != header.checksum) {
+			return fail("校验和不匹配");
+		}
+
+		std::array<std::optional<SectionEntry>, section_kinds> sections{};
+		for (std::uint32_t i = 0; i < header.section_count; ++i) {
+			SectionEntry entry{};
+			std::memcpy(&entry, file->data() + sizeof(Header) + i * sizeof(SectionEntry), sizeof(SectionEntry));
+			if (entry.kind >= section_kinds) {
+				return fail("未知的数据段");
+			}
+			sections[entry.kind] = entry;
+		}
+
+		auto const entry = [&](Section const kind) -> std::optional<SectionEntry> const&
+		{
+			return sections[static_cast<std::size_t>(kind)];
+		};
+
+		auto const n = static_cast<std::size_t>(header.vertices);
+		auto const x = section_view<std::int32_t>(*file, entry(Section::X), n);
+		auto const y = section_view<std::int32_t>(*file, entry(Section::Y), n);
+		auto const attr = section_view<Attribute>(*file, entry(Section::Attr), n);
+		auto const name_offset = section_view<std::uint32_t>(*file, entry(Section::NameOffset), n);
+		auto const name_length = section_view<std::uint32_t>(*file, entry(Section::NameLength), n);
+		auto const name_pool = section_view<char>(*file, entry(Section::NamePool));
+		auto const ids = section_view<std::int64_t>(*file, entry(Section::Ids));
+		if (!x || !y || !attr || !name_offset || !name_length || !name_pool) {
+			return fail("顶点表数据段无效");
+		}
+		// VertexIdMap::dense 对映射做二分查找
+		if (!ids || (!ids->empty() && ids->size() != n)
+			|| std::ranges::adjacent_find(*ids, std::ranges::greater_equal{}) != ids->end()) {
+			return fail("顶点编号映射无效");
+		}
+		for (std::size_t i = 0; i < n; ++i) {
+			if ((*name_offset)[i] != VertexTable::npos
+				&& std::uint64_t{(*name_offset)[i]} + (*name_length)[i] > name_pool->size()) {
+				return fail("顶点名称越界");
+			}
+		}
+
+		auto const storage = static_cast<Storage>(header.storage);
+		WeightedAdjMatrixGraph<V, W> graph(0, storage);
+		graph.m_vertices = static_cast<int>(n);
+		graph.m_edges = static_cast<IntType>(header.edges);
+		graph.m_heuristicScale = header.heuristic_scale;
+		graph.m_symmetric = header.directed == 0;
+
+		if (storage == Storage::Csr) {
+			auto const offsets = section_view<typename Traits::EdgeIndex>(*file, entry(Section::Offsets), n + 1);
+			if (!offsets || offsets->front() != 0) {
+				return fail("CSR 行偏移无效");
+			}
+			auto const arcs = static_cast<std::size_t>(offsets->back());
+			auto const targets = section_view<V>(*file, entry(Section::Targets), arcs);
+			auto const weights = section_view<W>(*file, entry(Section::Weights), arcs);
+			if (!targets || !weights) {
+				return fail("CSR 数据段无效");
+			}
+			if (std::ranges::adjacent_find(*offsets, std::ranges::greater{}) != offsets->end()) {
+				return fail("CSR 行偏移不单调");
+			}
+			// 负的编号转换为无符号数后同样不小于 n
+			if (std::ranges::any_of(*targets, [n](V const v) { return static_cast<std::uint64_t>(v) >= n; })) {
+				return fail("CSR 目标顶点越界");
+			}
+			graph.m_csr.offsets.map(*offsets, file);
+			graph.m_csr.targets.map(*targets, file);
+			graph.m_csr.weights.map(*weights, file);
+		} else {
+			std::size_t const stride = header.matrix_stride;
+			if (stride < n) {
+				return fail("邻接矩阵行跨度无效");
+			}
+			auto const matrix = section_view<W>(*file, entry(Section::Matrix), n * stride);
+			if (!matrix || reinterpret_cast<std::uintptr_t>(matrix->data()) % DenseMatrix<W>::alignment != 0) {
+				return fail("邻接矩阵数据段无效");
+			}
+			graph.m_adjMatrix.map(static_cast<int>(n), static_cast<int>(stride), *matrix, file);
+		}
+
+		VertexTable& table = graph.m_vertexTable;
+		table.m_x.map(*x, file);
+		table.m_y.map(*y, file);
+		table.m_attr.map(*attr, file);
+		table.m_nameOffset.map(*name_offset, file);
+		table.m_nameLength.map(*name_length, file);
+		table.m_namePool.map(*name_pool, file);
+		graph.m_ids.original.assign(ids->begin(), ids->end());
+
+		// 反向 CSR 不存入快照，有向图加载时由正向 CSR 重建
+		if (!graph.m_symmetric && storage == Storage::Csr) {
+			graph.buildReverseCsr();
+		}
+
+		return graph;
+	}
+
+	/*****************************************************************
+	 *
+	 *		地标预处理文件
+	 *
+	 *****************************************************************/
+	namespace landmark_file
+	{
+		inline constexpr std::array<char, 8> magic{'R', 'T', 'L', 'M', 'A', 'R', 'K', '\0'};
+		inline constexpr std::uint32_t version = 1;
+
+		/**
+		 * @brief 文件头，之后是按 snapshot::alignment 对齐的地标数组与距离表。
+		 * fingerprint 为构建时图的边散列，加载时与当前图比较；checksum 覆盖文件头之后的全部字节。
+		 */
+		struct Header {
+		    std::array<char, 8> magic;
+		    std::uint32_t version;
+		    std::uint32_t endian;
+		    std::uint8_t vertex_size, vertex_signed; ///< 顶点编号类型
+		    std::uint8_t weight_size, weight_signed; ///< 权重类型
+		    std::uint8_t directed; ///< 是否分别存储到达与离开地标的距离
+		    std::uint8_t reserved[3];
+		    std::uint32_t landmark_count;
+		    std::uint64_t vertices;
+		    std::uint64_t fingerprint;
+		    std::uint64_t landmarks_offset;
+		    std::uint64_t distances_offset;
+		    std::uint64_t checksum; ///< FNV-1a 64
+		};
+
+		static_assert(std::is_trivially_copyable_v<Header>);
+	}
+
+	/**
+	 * @brief 将地标预处理写入二进制文件，通常与图文件放在一起（如 graph.txt.alt）。
+	 * @return true 如果写入成功
+	 */
+	template <typename V, typename W>
+	bool save_landmarks(LandmarkIndex<V, W> const& index, const std::string& filename)
+	{
+		using namespace landmark_file;
+		using snapshot::alignment;
+
+		auto const aligned = [](std::size_t const offset) { return (offset + alignment - 1) / alignment * alignment; };
+		std::size_t const landmarks_offset = aligned(sizeof(Header));
+		std::size_t const landmarks_bytes = index.m_landmarks.size() * sizeof(V);
+		std::size_t const distances_offset = aligned(landmarks_offset + landmarks_bytes);
+		std::size_t const distances_bytes = index.m_distances.size() * sizeof(std::uint32_t);
+
+		std::vector<std::byte> out(distances_offset + distances_bytes);
+		if (landmarks_bytes > 0) {
+			std::memcpy(out.data() + landmarks_offset, index.m_landmarks.data(), landmarks_bytes);
+		}
+		if (distances_bytes > 0) {
+			std::memcpy(out.data() + distances_offset, index.m_distances.data(), distances_bytes);
+		}
+
+		Header header{};
+		header.magic = magic;
+		header.version = version;
+		header.endian = snapshot::endian_marker;
+		header.vertex_size = sizeof(V);
+		header.vertex_signed = std::is_signed_v<V>;
+		header.weight_size = sizeof(W);
+		header.weight_signed = std::is_signed_v<W>;
+		header.directed = index.m_directed ? 1 : 0;
+		header.landmark_count = static_cast<std::uint32_t>(index.m_count);
+		header.vertices = static_cast<std::uint64_t>(index.m_vertices);
+		header.fingerprint = index.m_fingerprint;
+		header.landmarks_offset = landmarks_offset;
+		header.distances_offset = distances_offset;
+		header.checksum = snapshot::fnv1a(out.data() + sizeof(Header), out.size() - sizeof(Header));
+		std::memcpy(out.data(), &header, sizeof(Header));
+
+		std::ofstream file(filename, std::ios::binary);
+		if (!file.is_open()) {
+			std::cerr << "无法打开文件: " << filename << "\n";
+			return false;
+		}
+		file.write(reinterpret_cast<char const*>(out.data()), static_cast<std::streamsize>(out.size()));
+		return file.good();
+	}
+
+	/**
+	 * @brief 映射地标预处理文件，距离表直接引用映射的内存。
+	 *
+	 * 文件不存在时静默返回 std::nullopt，调用方据此重新构建；
+	 * 文件存在但格式不符、校验和不符或与 graph 不一致（图在构建之后被修改）时输出原因。
+	 * @param graph 预处理所对应的图
+	 * @param filename 文件路径
+	 * @return 地标预处理；文件不存在或无效时返回 std::nullopt
+	 */
+	template <typename V, typename W>
+	std::optional<LandmarkIndex<V, W>> load_landmarks(WeightedAdjMatrixGraph<V, W> const& graph,
+	                                                  const std::string& filename)
+	{
+		using namespace landmark_file;
+		using Index = LandmarkIndex<V, W>;
+
+		auto const file = std::make_shared<MappedFile>();
+		if (!file->open(filename)) {
+			return std::nullopt;
+		}
+		auto const fail = [&](char const* reason) -> std::optional<Index>
+		{
+			std::cerr << "地标文件无效: " << filename << ": " << reason << "\n";
+			return std::nullopt;
+		};
+
+		Header header{};
+		if (file->size() < sizeof(Header)) {
+			return fail("文件过短");
+		}
+		std::memcpy(&header, file->data(), sizeof(Header));
+		if (header.magic != magic || header.version != version || header.endian != snapshot::endian_marker) {
+			return fail("文件头、版本或字节序不匹配");
+		}
+		if (header.vertex_size != sizeof(V) || header.vertex_signed != std::is_signed_v<V>
+			|| header.weight_size != sizeof(W) || header.weight_signed != std::is_signed_v<W>) {
+			return fail("顶点或权重类型不匹配");
+		}
+		if (header.vertices != static_cast<std::uint64_t>(graph.vertexCount())
+			|| header.directed != (graph.symmetric() ? 0 : 1)
+			|| header.landmark_count > static_cast<std::uint32_t>(Index::max_landmarks)
+			|| header.landmark_count > header.vertices) {
+			return fail("规模与图不一致");
+		}
+		if (snapshot::fnv1a(file->data() + sizeof(Header), file->size() - sizeof(Header)) != header.checksum) {
+			return fail("校验和不匹配");
+		}
+		if (header.fingerprint != landmark::fingerprint(graph)) {
+			return fail("图已被修改，需要重新构建");
+		}
+
+		std::size_t const count = header.landmark_count;
+		std::size_t const columns = count * (header.directed != 0 ? 2 : 1);
+		auto const landmarks = snapshot::section_view<V>(
+			*file, snapshot::SectionEntry{0, 0, header.landmarks_offset, count * sizeof(V)}, count);
+		auto const distances = snapshot::section_view<std::uint32_t>(
+			*file, snapshot::SectionEntry{0, 0, header.distances_offset, header.vertices * columns * sizeof(std::uint32_t)},
+			header.vertices * columns);
+		if (!landmarks || !distances) {
+			return fail("数据段越界");
+		}
+		for (V const v : *landmarks) {
+			if (!graph.hasVertex(v)) {
+				return fail("地标编号越界");
+			}
+		}
+
+		Index index;
+		index.m_vertices = graph.vertexCount();
+		index.m_count = static_cast<int>(count);
+		index.m_directed = header.directed != 0;
+		index.m_fingerprint = header.fingerprint;
+		index.m_landmarks.map(*landmarks, file);
+		index.m_distances.map(*distances, file);
+		return index;
+	}
+
+	/*****************************************************************
+	 *
+	 *		收缩层次文件
+	 *
+	 *****************************************************************/
+	namespace hierarchy_file
+	{
+		inline constexpr std::array<char, 8> magic{'R', 'T', 'C', 'H', 'I', 'E', 'R', '\0'};
+		inline constexpr std::uint32_t version = 1;
+
+		/**
+		 * @brief 文件头，之后是按 snapshot::alignment 对齐的收缩顺序、上行 CSR 与下行 CSR。
+		 * fingerprint 为构建时图的边散列，加载时与当前图比较；checksum 覆盖文件头之后的全部字节。
+		 */
+		struct Header {
+		    std::array<char, 8> magic;
+		    std::uint32_t version;
+		    std::uint32_t endian;
+		    std::uint8_t vertex_size, vertex_signed; ///< 顶点编号类型
+		    std::uint8_t weight_size, weight_signed; ///< 权重类型
+		    std::uint8_t arc_size; ///< 层次中一条边的字节数
+		    std::uint8_t reserved[3];
+		    std::uint64_t vertices;
+		    std::uint64_t shortcuts;
+		    std::uint64_t fingerprint;
+		    std::uint64_t up_arcs, down_arcs; ///< 上行、下行边数
+		    std::uint64_t rank_offset;
+		    std::uint64_t up_offsets_offset, up_offset;
+		    std::uint64_t down_offsets_offset, down_offset;
+		    std::uint64_t checksum; ///< FNV-1a 64
+		};
+
+		static_assert(std::is_trivially_copyable_v<Header>);
+	}
+
+	/**
+	 * @brief 将收缩层次写入二进制文件，通常与图文件放在一起（如 graph.txt.ch）。
+	 * @return true 如果写入成功
+	 */
+	template <typename V, typename W>
+	bool save_contraction_hierarchy(ContractionHierarchy<V, W> const& hierarchy, const std::string& filename)
+	{
+		using namespace hierarchy_file;
+		using snapshot::alignment;
+		using Arc = typename ContractionHierarchy<V, W>::Arc;
+
+		std::vector<std::byte> out(sizeof(Header));
+		auto const append = [&out](auto const& values)
+		{
+			std::size_t const offset = (out.size() + alignment - 1) / alignment * alignment;
+			std::size_t const bytes = values.size() * sizeof(*values.data());
+			out.resize(offset + bytes);
+			if (bytes > 0) {
+				std::memcpy(out.data() + offset, values.data(), bytes);
+			}
+			return static_cast<std::uint64_t>(offset);
+		};
+
+		Header header{};
+		header.rank_offset = append(hierarchy.m_rank);
+		header.up_offsets_offset = append(hierarchy.m_upOffsets);
+		header.up_offset = append(hierarchy.m_up);
+		header.down_offsets_offset = append(hierarchy.m_downOffsets);
+		header.down_offset = append(hierarchy.m_down);
+
+		header.magic = magic;
+		header.version = version;
+		header.endian = snapshot::endian_marker;
+		header.vertex_size = sizeof(V);
+		header.vertex_signed = std::is_signed_v<V>;
+		header.weight_size = sizeof(W);
+		header.weight_signed = std::is_signed_v<W>;
+		header.arc_size = sizeof(Arc);
+		header.vertices = static_cast<std::uint64_t>(hierarchy.m_vertices);
+		header.shortcuts = hierarchy.m_shortcuts;
+		header.fingerprint = hierarchy.m_fingerprint;
+		header.up_arcs = hierarchy.m_up.size();
+		header.down_arcs = hierarchy.m_down.size();
+		header.checksum = snapshot::fnv1a(out.data() + sizeof(Header), out.size() - sizeof(Header));
+		std::memcpy(out.data(), &header, sizeof(Header));
+
+		std::ofstream file(filename, std::ios::binary);
+		if (!file.is_open()) {
+			std::cerr << "无法打开文件: " << filename << "\n";
+			return false;
+		}
+		file.write(reinterpret_cast<char const*>(out.data()), static_cast<std::streamsize>(out.size()));
+		return file.good();
+	}
+
+	/**
+	 * @brief 读取收缩层次文件。
+	 *
+	 * 文件不存在时静默返回 std::nullopt，调用方据此重新构建；
+	 * 文件存在但格式不符、校验和不符或与 graph 不一致（图在构建之后被修改）时输出原因。
+	 * 除边界外还检查查询与捷径展开依赖的不变式：收缩顺序是全部顶点的排列，CSR 行偏移单调，
+	 * 每条边指向更高层的顶点，捷径的中间顶点低于边的低层端点，因此展开总会结束。
+	 * @param graph 层次所对应的图
+	 * @param filename 文件路径
+	 * @return 收缩层次；文件不存在或无效时返回 std::nullopt
+	 */
+	template <typename V, typename W>
+	std::optional<ContractionHierarchy<V, W>> load_contraction_hierarchy(WeightedAdjMatrixGraph<V, W> const& graph,
+	                                                                     const std::string& filename)
+	{
+		using namespace hierarchy_file;
+		using Hierarchy = ContractionHierarchy<V, W>;
+		using Arc = typename Hierarchy::Arc;
+		constexpr V invalid = WeightedAdjMatrixGraph<V, W>::Traits::invalid_vertex;
+
+		MappedFile file;
+		if (!file.open(filename)) {
+			return std::nullopt;
+		}
+		auto const fail = [&](char const* reason) -> std::optional<Hierarchy>
+		{
+			std::cerr << "收缩层次文件无效: " << filename << ": " << reason << "\n";
+			return std::nullopt;
+		};
+
+		Header header{};
+		if (file.size() < sizeof(Header)) {
+			return fail("文件过短");
+		}
+		std::memcpy(&header, file.data(), sizeof(Header));
+		if (header.magic != magic || header.version != version || header.endian != snapshot::endian_marker) {
+			return fail("文件头、版本或字节序不匹配");
+		}
+		if (header.vertex_size != sizeof(V) || header.vertex_signed != std::is_signed_v<V>
+			|| header.weight_size != sizeof(W) || header.weight_signed != std::is_signed_v<W>
+			|| header.arc_size != sizeof(Arc)) {
+			return fail("顶点或权重类型不匹配");
+		}
+		if (header.vertices != static_cast<std::uint64_t>(graph.vertexCount())) {
+			return fail("规模与图不一致");
+		}
+		if (snapshot::fnv1a(file.data() + sizeof(Header), file.size() - sizeof(Header)) != header.checksum) {
+			return fail("校验和不匹配");
+		}
+		if (header.fingerprint != landmark::fingerprint(graph)) {
+			return fail("图已被修改，需要重新构建");
+		}
+
+		auto const n = static_cast<std::size_t>(header.vertices);
+		auto const view = [&]<typename T>(std::type_identity<T>, std::uint64_t const offset, std::uint64_t const count)
+		{
+			return count > file.size() / sizeof(T) ? std::nullopt
+				: snapshot::section_view<T>(file, snapshot::SectionEntry{0, 0, offset, count * sizeof(T)}, count);
+		};
+		auto const rank = view(std::type_identity<std::uint32_t>{}, header.rank_offset, n);
+		auto const up_offsets = view(std::type_identity<std::uint32_t>{}, header.up_offsets_offset, n + 1);
+		auto const up = view(std::type_identity<Arc>{}, header.up_offset, header.up_arcs);
+		auto const down_offsets = view(std::type_identity<std::uint32_t>{}, header.down_offsets_offset, n + 1);
+		auto const down = view(std::type_identity<Arc>{}, header.down_offset, header.down_arcs);
+		if (!rank || !up_offsets || !up || !down_offsets || !down) {
+			return fail("数据段越界");
+		}
+
+		std::vector<bool> seen(n, false);
+		for (std::uint32_t const r : *rank) {
+			if (r >= n || seen[r]) {
+				return fail("收缩顺序无效");
+			}
+			seen[r] = true;
+		}
+		// 每条边指向更高层，捷径的中间顶点低于存放它的顶点
+		auto const valid_csr = [&](std::span<std::uint32_t const> const offsets, std::span<Arc const> const arcs)
+		{
+			if (offsets.front() != 0 || offsets.back() != arcs.size()
+				|| std::ranges::adjacent_find(offsets, std::ranges::greater{}) != offsets.end()) {
+				return false;
+			}
+			for (std::size_t v = 0; v < n; ++v) {
+				for (std::size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+					Arc const& arc = arcs[i];
+					auto const target = static_cast<std::uint64_t>(arc.target);
+					auto const middle = static_cast<std::uint64_t>(arc.middle);
+					if (arc.weight < 0 || target >= n || (*rank)[target] <= (*rank)[v]
+						|| (arc.middle != invalid && (middle >= n || (*rank)[middle] >= (*rank)[v]))) {
+						return false;
+					}
+				}
+			}
+			return true;
+		};
+		if (!valid_csr(*up_offsets, *up) || !valid_csr(*down_offsets, *down)) {
+			return fail("层次数据无效");
+		}
+
+		Hierarchy hierarchy;
+		hierarchy.m_vertices = graph.vertexCount();
+		hierarchy.m_fingerprint = header.fingerprint;
+		hierarchy.m_shortcuts = static_cast<std::size_t>(header.shortcuts);
+		hierarchy.m_rank.assign(rank->begin(), rank->end());
+		hierarchy.m_upOffsets.assign(up_offsets->begin(), up_offsets->end());
+		hierarchy.m_up.assign(up->begin(), up->end());
+		hierarchy.m_downOffsets.assign(down_offsets->begin(), down_offsets->end());
+		hierarchy.m_down.assign(down->begin(), down->end());
+		return hierarchy;
+	}
+
+	/*****************************************************************
+	 *
+	 *		枢纽标签文件
+	 *
+	 *****************************************************************/
+
+	namespace hub_label_file
+	{
+		inline constexpr std::array<char, 8> magic{'R', 'T', 'H', 'U', 'B', 'L', 'B', '\0'};
+		inline constexpr std::uint32_t version = 1;
+
+		/**
+		 * @brief 文件头，之后是变长整数编码的数据：枢纽顺序，然后依次为离开标签与（有向图的）到达标签。
+		 *
+		 * 每个顶点先写标签项数，每项依次写枢纽序号与前一项的差、距离、相邻顶点与 v 之差的 zigzag 编码加一
+		 * （0 表示枢纽自身）。枢纽序号递增且相邻顶点多与 v 编号接近，大部分字段只占一两个字节。
+		 */
+		struct Header {
+		    std::array<char, 8> magic;
+		    std::uint32_t version;
+		    std::uint32_t endian;
+		    std::uint8_t vertex_size, vertex_signed; ///< 顶点编号类型
+		    std::uint8_t weight_size, weight_signed; ///< 权重类型
+		    std::uint8_t directed; ///< 是否包含到达标签
+		    std::uint8_t reserved[3];
+		    std::uint64_t vertices;
+		    std::uint64_t entries; ///< 全部标签项数
+		    std::uint64_t fingerprint;
+		    std::uint64_t checksum; ///< FNV-1a 64，覆盖文件头之后的全部字节
+		};
+
+		static_assert(std::is_trivially_copyable_v<Header>);
+
+		/// LEB128 无符号变长整数
+		inline void put(std::vector<std::byte>& out, std::uint64_t value)
+		{
+			while (value >= 0x80) {
+				out.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+				value >>= 7;
+			}
+			out.push_back(static_cast<std::byte>(value));
+		}
+
+		/**
+		 * @brief 顺序读取变长整数，越界或编码超长时置 failed。
+		 */
+		struct Reader {
+		    std::byte const* at;
+		    std::byte const* end;
+		    bool failed{false};
+
+		    std::uint64_t next() noexcept
+		    {
+		        std::uint64_t value = 0;
+		        for (int shift = 0; shift < 64; shift += 7) {
+		            if (at == end) {
+		                break;
+		            }
+		            auto const byte = static_cast<std::uint64_t>(*at++);
+		            value |= (byte & 0x7F) << shift;
+		            if ((byte & 0x80) == 0) {
+		                return value;
+		            }
+		        }
+		        failed = true;
+		        return 0;
+		    }
+		};
+
+		inline std::uint64_t zigzag(std::int64_t const value) noexcept
+		{
+			return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+		}
+
+		inline std::int64_t unzigzag(std::uint64_t const value) noexcept
+		{
+			return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+		}
+	}
+
+	/**
+	 * @brief 将枢纽标签以变长整数压缩写入二进制文件，通常与图文件放在一起（如 graph.txt.hl）。
+	 * @return true 如果写入成功
+	 */
+	template <typename V, typename W>
+	bool save_hub_labels(HubLabelIndex<V, W> const& index, const std::string& filename)
+	{
+		using namespace hub_label_file;
+
+		std::vector<std::byte> out(sizeof(Header));
+		out.reserve(sizeof(Header) + index.entryCount() * 4);
+		for (V const v : index.m_order) {
+			put(out, static_cast<std::uint64_t>(v));
+		}
+		for (int side = 0; side < (index.m_directed ? 2 : 1); ++side) {
+			auto const& labels = index.m_labels[side];
+			for (int v = 0; v < index.m_vertices; ++v) {
+				put(out, labels.offsets[v + 1] - labels.offsets[v]);
+				std::uint32_t previous = 0;
+				for (std::size_t i = labels.offsets[v]; i < labels.offsets[v + 1]; ++i) {
+					put(out, labels.hubs[i] - previous);
+					put(out, labels.distances[i]);
+					V const parent = labels.parents[i];
+					put(out, parent == WeightedAdjMatrixGraph<V, W>::Traits::invalid_vertex
+						         ? 0
+						         : zigzag(static_cast<std::int64_t>(parent) - v) + 1);
+					previous = labels.hubs[i];
+				}
+			}
+		}
+
+		Header header{};
+		header.magic = magic;
+		header.version = version;
+		header.endian = snapshot::endian_marker;
+		header.vertex_size = sizeof(V);
+		header.vertex_signed = std::is_signed_v<V>;
+		header.weight_size = sizeof(W);
+		header.weight_signed = std::is_signed_v<W>;
+		header.directed = index.m_directed ? 1 : 0;
+		header.vertices = static_cast<std::uint64_t>(index.m_vertices);
+		header.entries = index.entryCount();
+		header.fingerprint = index.m_fingerprint;
+		header.checksum = snapshot::fnv1a(out.data() + sizeof(Header), out.size() - sizeof(Header));
+		std::memcpy(out.data(), &header, sizeof(Header));
+
+		std::ofstream file(filename, std::ios::binary);
+		if (!file.is_open()) {
+			std::cerr << "无法打开文件: " << filename << "\n";
+			return false;
+		}
+		file.write(reinterpret_cast<char const*>(out.data()), static_cast<std::streamsize>(out.size()));
+		return file.good();
+	}
+
+	/**
+	 * @brief 读取并解码枢纽标签文件。
+	 *
+	 * 文件不存在时静默返回 std::nullopt，调用方据此重新构建；
+	 * 文件存在但格式不符、校验和不符、解码出的数据越界或与 graph 不一致时输出原因。
+	 * @param graph 标签所对应的图
+	 * @param filename 文件路径
+	 * @return 枢纽标签；文件不存在或无效时返回 std::nullopt
+	 */
+	template <typename V, typename W>
+	std::optional<HubLabelIndex<V, W>> load_hub_labels(WeightedAdjMatrixGraph<V, W> const& graph,
+	                                                   const std::string& filename)
+	{
+		using namespace hub_label_file;
+		using Index = HubLabelIndex<V, W>;
+
+		MappedFile file;
+		if (!file.open(filename)) {
+			return std::nullopt;
+		}
+		auto const fail = [&](char const* reason) -> std::optional<Index>
+		{
+			std::cerr << "枢纽标签文件无效: " << filename << ": " << reason << "\n";
+			return std::nullopt;
+		};
+
+		Header header{};
+		if (file.size() < sizeof(Header)) {
+			return fail("文件过短");
+		}
+		std::memcpy(&header, file.data(), sizeof(Header));
+		if (header.magic != magic || header.version != version || header.endian != snapshot::endian_marker) {
+			return fail("文件头、版本或字节序不匹配");
+		}
+		if (header.vertex_size != sizeof(V) || header.vertex_signed != std::is_signed_v<V>
+			|| header.weight_size != sizeof(W) || header.weight_signed != std::is_signed_v<W>) {
+			return fail("顶点或权重类型不匹配");
+		}
+		if (header.vertices != static_cast<std::uint64_t>(graph.vertexCount())
+			|| header.directed != (graph.symmetric() ? 0 : 1)) {
+			return fail("规模与图不一致");
+		}
+		if (snapshot::fnv1a(file.data() + sizeof(Header), file.size() - sizeof(Header)) != header.checksum) {
+			return fail("校验和不匹配");
+		}
+		if (header.fingerprint != landmark::fingerprint(graph)) {
+			return fail("图已被修改，需要重新构建");
+		}
+
+		auto const n = static_cast<std::uint64_t>(header.vertices);
+		Reader reader{file.data() + sizeof(Header), file.data() + file.size()};
+		Index index;
+		index.m_vertices = graph.vertexCount();
+		index.m_directed = header.directed != 0;
+		index.m_fingerprint = header.fingerprint;
+		index.m_order.resize(n);
+		for (V& v : index.m_order) {
+			std::uint64_t const value = reader.next();
+			if (value >= n) {
+				return fail("数据越界");
+			}
+			v = static_cast<V>(value);
+		}
+		for (int side = 0; side < (index.m_directed ? 2 : 1); ++side) {
+			auto& labels = index.m_labels[side];
+			labels.offsets.assign(n + 1, 0);
+			for (std::uint64_t v = 0; v < n; ++v) {
+				std::uint64_t const count = reader.next();
+				if (count > n || labels.hubs.size() + count > header.entries) {
+					return fail("数据越界");
+				}
+				std::uint64_t hub = 0;
+				for (std::uint64_t i = 0; i < count; ++i) {
+					std::uint64_t const delta = reader.next();
+					if (delta >= n || (i > 0 && delta == 0)) {
+						return fail("数据越界");
+					}
+					hub += delta;
+					std::uint64_t const distance = reader.next();
+					std::uint64_t const parent = reader.next();
+					std::int64_t const neighbor = parent == 0 ? -1 : static_cast<std::int64_t>(v) + unzigzag(parent - 1);
+					if (hub >= n || distance >= Index::max_distance
+						|| (parent != 0 && (neighbor < 0 || static_cast<std::uint64_t>(neighbor) >= n))) {
+						return fail("数据越界");
+					}
+					labels.hubs.push_back(static_cast<std::uint32_t>(hub));
+					labels.distances.push_back(static_cast<std::uint32_t>(distance));
+					labels.parents.push_back(parent == 0
+						                         ? WeightedAdjMatrixGraph<V, W>::Traits::invalid_vertex
+						                         : static_cast<V>(neighbor));
+				}
+				labels.offsets[v + 1] = labels.hubs.size();
+			}
+		}
+		if (reader.failed || reader.at != reader.end || index.entryCount() != header.entries) {
+			return fail("数据长度不一致");
+		}
+		return index;
+	}
 }
@@ -13,11 +13,143 @@ namespace route
 	 *
 	 *****************************************************************/
 
+	template <typename V, typename W>
 	class WeightedAdjMatrixGraph;
+	template <typename V, typename W>
+	class LandmarkIndex;
+	template <typename V, typename W>
+	class ContractionHierarchy;
+	template <typename V, typename W>
+	class HubLabelIndex;
+	enum class Storage : std::uint_fast8_t;
 
-	/* 两个友元函数 */
-	bool read_from_file(WeightedAdjMatrixGraph& graph, const std::string& filename);
-	bool write_to_file(WeightedAdjMatrixGraph& graph, const std::string& filename);
+	/**
+	 * @brief 文本解析错误的类型。
+	 */
+	enum class ParseError : std::uint_fast8_t
+	{
+		VertexFormat = 0, ///< [Vertex] 行字段不足。
+		EdgeFormat, ///< [Edge] 行字段不足。
+		Number, ///< 数值字段不是合法整数或超出范围。
+		Range, ///< 数值超出图的顶点编号或权重类型的表示范围。
+	};
+
+	/**
+	 * @brief 一次解析的统计信息。
+	 */
+	struct ParseStats {
+	    std::size_t lines{};    ///< 扫描的行数
+	    std::size_t vertices{}; ///< 成功解析的顶点行数
+	    std::size_t edges{};    ///< 成功解析的边行数
+	    std::size_t errors{};   ///< 出错的行数
+	};
+
+	/* 文本解析 */
+	template <typename OnVertex, typename OnEdge, typename OnError>
+	ParseStats parse_graph_text(std::string_view text, OnVertex&& on_vertex, OnEdge&& on_edge,
+	                            OnError&& on_error, std::size_t first_line = 1);
+
+	/**
+	 * @brief 只读内存映射文件
+	 *
+	 * POSIX 下使用 mmap，Windows 下使用 CreateFileMapping / MapViewOfFile。
+	 * 析构时解除映射，不可拷贝。
+	 */
+	class MappedFile
+	{
+	public:
+	    MappedFile() = default;
+	    ~MappedFile();
+	    MappedFile(MappedFile const&) = delete;
+	    MappedFile& operator=(MappedFile const&) = delete;
+
+	    /**
+	     * @brief 映射整个文件。
+	     * @return true 如果文件存在、非空且映射成功
+	     */
+	    bool open(const std::string& filename);
+
+	    [[nodiscard]] std::byte const* data() const noexcept { return m_data; }
+	    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+	private:
+	    std::byte const* m_data{nullptr}; ///< 映射起始地址
+	    std::size_t m_size{0}; ///< 映射字节数
+	};
+
+	/**
+	 * @brief 文件中的顶点编号与图内连续编号之间的映射。
+	 *
+	 * original 按升序保存文件中出现过的顶点编号，图内编号即其下标。
+	 * 文件编号恰为 0..n-1 时映射为恒等映射，查找不做二分。
+	 */
+	struct VertexIdMap {
+	    std::vector<std::int64_t> original{}; ///< 图内编号 -> 文件编号
+
+	    [[nodiscard]] bool identity() const noexcept;
+	    [[nodiscard]] int size() const noexcept { return static_cast<int>(original.size()); }
+	    /// 文件编号对应的图内编号，不存在时返回 -1
+	    [[nodiscard]] int dense(std::int64_t id) const noexcept;
+	    /// 图内编号对应的文件编号，映射为空时二者相同
+	    [[nodiscard]] std::int64_t external(int const id) const noexcept
+	    {
+	        return original.empty() ? id : original[static_cast<std::size_t>(id)];
+	    }
+	};
+
+	/**
+	 * @brief load_graph 的结果。
+	 */
+	template <typename V, typename W>
+	struct LoadedGraph {
+	    WeightedAdjMatrixGraph<V, W> graph; ///< 按实际规模构建的图
+	    VertexIdMap ids; ///< 顶点编号映射
+	    ParseStats stats; ///< 解析统计
+	};
+
+	/* 友元函数 */
+	template <typename V, typename W>
+	bool read_from_file(WeightedAdjMatrixGraph<V, W>& graph, const std::string& filename);
+	template <typename V, typename W>
+	bool read_from_file_parallel(WeightedAdjMatrixGraph<V, W>& graph, const std::string& filename,
+	                             unsigned threads = 0);
+	template <typename V, typename W>
+	bool write_to_file(WeightedAdjMatrixGraph<V, W>& graph, const std::string& filename, unsigned threads = 1);
+
+	/* 自动确定规模的读取 */
+	template <typename V = std::int32_t, typename W = std::int32_t>
+	auto load_graph(const std::string& filename, Storage storage = Storage{} /* Matrix */)
+		-> std::optional<LoadedGraph<V, W>>;
+
+	/* 二进制快照 */
+	template <typename V, typename W>
+	bool save_snapshot(WeightedAdjMatrixGraph<V, W>& graph, const std::string& filename,
+	                   const std::string& source = {});
+	template <typename V, typename W>
+	std::optional<WeightedAdjMatrixGraph<V, W>> load_snapshot(const std::string& filename,
+	                                                          bool verify_checksum = false,
+	                                                          const std::string& source = {});
+
+	/* 地标预处理 */
+	template <typename V, typename W>
+	bool save_landmarks(LandmarkIndex<V, W> const& index, const std::string& filename);
+	template <typename V, typename W>
+	std::optional<LandmarkIndex<V, W>> load_landmarks(WeightedAdjMatrixGraph<V, W> const& graph,
+	                                                  const std::string& filename);
+
+	/* 收缩层次 */
+	template <typename V, typename W>
+	bool save_contraction_hierarchy(ContractionHierarchy<V, W> const& hierarchy, const std::string& filename);
+	template <typename V, typename W>
+	std::optional<ContractionHierarchy<V, W>> load_contraction_hierarchy(WeightedAdjMatrixGraph<V, W> const& graph,
+	                                                                     const std::string& filename);
+
+	/* 枢纽标签 */
+	template <typename V, typename W>
+	bool save_hub_labels(HubLabelIndex<V, W> const& index, const std::string& filename);
+	template <typename V, typename W>
+	std::optional<HubLabelIndex<V, W>> load_hub_labels(WeightedAdjMatrixGraph<V, W> const& graph,
+	                                                   const std::string& filename);
 
 }
 
@@ -0,0 +1,576 @@
+﻿// Purpose: 遗传算法的种群演化与岛屿模型
+// Author:  Cmixed
+#pragma once
+
+#ifndef GENETIC_HPP
+#define GENETIC_HPP
+
+#include "pch.hpp"
+#include "data.hpp"
+#include "tool.hpp"
+
+namespace route::genetic
+{
+	/*****************************************************************
+	 *
+	 *		Population 类
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 连续存储的种群
+	 *
+	 * 所有个体按行存放在同一块 size × width 的缓冲区中，第 i 行即第 i 条路径，另有一个并行的距离数组。
+	 * 构造后不再分配内存，演化时在两个种群之间交替读写，每代结束后交换（见 swap）。
+	 *
+	 * @tparam Vertex 顶点编号类型
+	 * @tparam Distance 路径距离类型，-1 表示无效或尚未计算
+	 */
+	template <typename Vertex, typename Distance>
+	class Population
+	{
+	public:
+	    Population() = default;
+
+	    /**
+	     * @param size 个体数
+	     * @param width 每条路径的顶点数
+	     */
+	    Population(int const size, int const width)
+	        : m_size(size), m_width(width),
+	          m_genes(static_cast<std::size_t>(size) * static_cast<std::size_t>(width)),
+	          m_distances(static_cast<std::size_t>(size), -1)
+	    {}
+
+	    [[nodiscard]] int size() const noexcept { return m_size; }
+	    [[nodiscard]] int width() const noexcept { return m_width; }
+
+	    /// 第 i 条路径
+	    [[nodiscard]] std::span<Vertex> operator[](int const i) noexcept
+	    {
+	        return {m_genes.data() + static_cast<std::size_t>(i) * m_width, static_cast<std::size_t>(m_width)};
+	    }
+
+	    [[nodiscard]] std::span<Vertex const> operator[](int const i) const noexcept
+	    {
+	        return {m_genes.data() + static_cast<std::size_t>(i) * m_width, static_cast<std::size_t>(m_width)};
+	    }
+
+	    /// 第 i 条路径的距离，-1 表示无效
+	    [[nodiscard]] Distance& distance(int const i) noexcept { return m_distances[i]; }
+	    [[nodiscard]] Distance distance(int const i) const noexcept { return m_distances[i]; }
+	    [[nodiscard]] std::span<Distance const> distances() const noexcept { return m_distances; }
+
+	    /// 把 source 的第 from 个个体（路径与距离）复制为本种群的第 to 个个体
+	    void assign(int const to, Population const& source, int const from) noexcept
+	    {
+	        std::ranges::copy(source[from], (*this)[to].begin());
+	        m_distances[to] = source.m_distances[from];
+	    }
+
+	    void swap(Population& other) noexcept
+	    {
+	        std::swap(m_size, other.m_size);
+	        std::swap(m_width, other.m_width);
+	        m_genes.swap(other.m_genes);
+	        m_distances.swap(other.m_distances);
+	    }
+
+	private:
+	    int m_size{0}; ///< 个体数
+	    int m_width{0}; ///< 每条路径的顶点数
+	    std::vector<Vertex> m_genes{}; ///< 按行存放的路径
+	    std::vector<Distance> m_distances{}; ///< 每条路径的距离
+	};
+
+	/*****************************************************************
+	 *
+	 *		Selector 类
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 基于已缓存距离的选择算子
+	 *
+	 * 每代先以本代的距离调用一次 prepare，此后每次 next 返回一个父代的下标，都不再重新评估路径。
+	 * 适应度为 1 / (距离 + 1)，无效路径（距离为 -1）为 0；所有路径都无效时按均匀分布选择。
+	 *  - Roulette：prepare 用 Vose 方法在 O(P) 内建立别名表，next 为 O(1)；
+	 *  - Tournament：prepare 不做任何事，next 随机抽取 tournament_size 个个体（可重复），取距离最短的有效个体；
+	 *  - Universal：prepare 用 draws 个等间距指针一次抽出本代全部父代并打乱顺序，next 依次取出，
+	 *    每个个体被选中的次数与期望值相差不到 1。
+	 * 所有缓冲区在构造时按种群大小分配，prepare 与 next 不分配内存。
+	 *
+	 * @tparam Distance 路径距离类型
+	 */
+	template <typename Distance>
+	class Selector
+	{
+	public:
+	    Selector() = default;
+
+	    /**
+	     * @param method 选择算子
+	     * @param tournament_size 锦标赛选择每次抽取的个体数，至少为 1
+	     * @param population_size 种群大小
+	     */
+	    Selector(SelectionMethod const method, int const tournament_size, int const population_size)
+	        : m_method(method), m_tournamentSize(std::max(1, tournament_size))
+	    {
+	        auto const size = static_cast<std::size_t>(population_size);
+	        if (method == SelectionMethod::Roulette) {
+	            m_probability.resize(size);
+	            m_alias.resize(size);
+	            m_small.resize(size);
+	            m_large.resize(size);
+	        }
+	        else if (method == SelectionMethod::Universal) {
+	            m_picks.resize(2 * size);
+	        }
+	    }
+
+	    /**
+	     * @brief 以本代的距离准备选择。
+	     * @param distances 种群中每条路径的距离，无效为 -1，在下一次 prepare 之前须保持不变
+	     * @param draws 本代将调用 next 的次数，至多为种群大小的两倍，只有 Universal 使用
+	     * @param rng 随机数生成器
+	     */
+	    void prepare(std::span<Distance const> const distances, int const draws, std::mt19937& rng)
+	    {
+	        m_distances = distances;
+	        int const size = static_cast<int>(distances.size());
+	        double total = 0.0;
+	        for (Distance const distance : distances) {
+	            total += fitness(distance);
+	        }
+	        m_uniform = total == 0.0;
+
+	        if (m_method == SelectionMethod::Roulette && size > 0) {
+	            // Vose 别名表：把 size 个缩放后的概率两两配对，每列至多两个个体
+	            int small = 0, large = 0;
+	            for (int i = 0; i < size; ++i) {
+	                m_probability[i] = m_uniform ? 1.0 : fitness(distances[i]) * size / total;
+	                (m_probability[i] < 1.0 ? m_small[small++] : m_large[large++]) = i;
+	            }
+	            while (small > 0 && large > 0) {
+	                int const less = m_small[--small];
+	                int const more = m_large[--large];
+	                m_alias[less] = more;
+	                m_probability[more] -= 1.0 - m_probability[less];
+	                (m_probability[more] < 1.0 ? m_small[small++] : m_large[large++]) = more;
+	            }
+	            // 剩余的列只因舍入误差偏离 1
+	            while (large > 0) {
+	                m_probability[m_large[--large]] = 1.0;
+	            }
+	            while (small > 0) {
+	                m_probability[m_small[--small]] = 1.0;
+	            }
+	        }
+	        else if (m_method == SelectionMethod::Universal && size > 0) {
+	            m_count = std::clamp(draws, 0, static_cast<int>(m_picks.size()));
+	            m_cursor = 0;
+	            if (m_count == 0) {
+	                return;
+	            }
+	            double const weight = m_uniform ? static_cast<double>(size) : total;
+	            double const step = weight / m_count;
+	            double pointer = std::uniform_real_distribution<double>(0.0, step)(rng);
+	            double cumulative = 0.0;
+	            int picked = 0;
+	            for (int i = 0; i < size && picked < m_count; ++i) {
+	                cumulative += m_uniform ? 1.0 : fitness(distances[i]);
+	                while (picked < m_count && pointer < cumulative) {
+	                    m_picks[picked++] = i;
+	                    pointer += step;
+	                }
+	            }
+	            // 舍入误差可能使最后几个指针越过总和，补为最后一个被选中的个体
+	            for (int const last = picked > 0 ? m_picks[picked - 1] : size - 1; picked < m_count; ++picked) {
+	                m_picks[picked] = last;
+	            }
+	            std::shuffle(m_picks.begin(), m_picks.begin() + m_count, rng);
+	        }
+	    }
+
+	    /**
+	     * @brief 选择一个父代。
+	     * @return 被选中个体的下标
+	     * @throw std::invalid_argument 如果种群为空
+	     */
+	    int next(std::mt19937& rng)
+	    {
+	        int const size = static_cast<int>(m_distances.size());
+	        if (size == 0) {
+	            throw std::invalid_argument("种群为空");
+	        }
+
+	        std::uniform_int_distribution<int> index(0, size - 1);
+	        switch (m_method) {
+	        case SelectionMethod::Roulette:
+	        {
+	            int const column = index(rng);
+	            return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < m_probability[column]
+	                       ? column
+	                       : m_alias[column];
+	        }
+	        case SelectionMethod::Tournament:
+	        {
+	            int winner = index(rng);
+	            for (int k = 1; k < m_tournamentSize; ++k) {
+	                int const rival = index(rng);
+	                if (better(rival, winner)) {
+	                    winner = rival;
+	                }
+	            }
+	            return winner;
+	        }
+	        case SelectionMethod::Universal:
+	            if (m_count == 0) {
+	                return index(rng);
+	            }
+	            if (m_cursor == m_count) {
+	                m_cursor = 0; // 调用次数超过 draws 时循环使用
+	            }
+	            return m_picks[m_cursor++];
+	        }
+	        return index(rng);
+	    }
+
+	private:
+	    /// 路径越短，适应度越高
+	    [[nodiscard]] static double fitness(Distance const distance) noexcept
+	    {
+	        return distance == -1 ? 0.0 : 1.0 / (static_cast<double>(distance) + 1);
+	    }
+
+	    /// 个体 a 是否优于 b：有效路径优于无效路径，同为有效时距离更短
+	    [[nodiscard]] bool better(int const a, int const b) const noexcept
+	    {
+	        Distance const da = m_distances[a], db = m_distances[b];
+	        return da != -1 && (db == -1 || da < db);
+	    }
+
+	    SelectionMethod m_method{SelectionMethod::Roulette}; ///< 选择算子
+	    int m_tournamentSize{1}; ///< 锦标赛规模
+	    std::span<Distance const> m_distances{}; ///< 本代的距离
+	    bool m_uniform{false}; ///< 本代没有有效路径，按均匀分布选择
+	    std::vector<double> m_probability{}; ///< 别名表中每列保留本列的概率
+	    std::vector<int> m_alias{}; ///< 别名表中每列的另一个个体
+	    std::vector<int> m_small{}, m_large{}; ///< 建表时概率小于与不小于 1 的列
+	    std::vector<int> m_picks{}; ///< 随机遍历抽样本代抽出的父代
+	    int m_count{0}; ///< 本代抽出的父代数
+	    int m_cursor{0}; ///< 下一个要返回的父代
+	};
+
+	/*****************************************************************
+	 *
+	 *		Island 类
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 一个独立演化的种群
+	 *
+	 * 每代先评估当前种群（无效路径的距离记为 -1），再按精英保留、选择（见 Selector）、交叉与变异产生下一代。
+	 * 当前种群与下一代是两个 Population，子代直接写入下一代的行中，评估结果缓存在距离数组里供选择和迁移使用，
+	 * 所有缓冲区在构造时分配，此后每代不再分配内存。
+	 * 种群持有自己的随机数生成器，不同种群之间不共享任何可变状态。
+	 *
+	 * @tparam Vertex 顶点编号类型
+	 * @tparam WeightFn 边权重访问函数，-1 表示无边
+	 */
+	template <typename Vertex, typename WeightFn>
+	class Island
+	{
+	public:
+	    using Path = std::vector<Vertex>;
+	    using Distance = std::invoke_result_t<WeightFn const&, Vertex, Vertex>;
+	    using Individuals = Population<Vertex, Distance>;
+
+	    /**
+	     * @param start 起点
+	     * @param end 终点
+	     * @param vertices 顶点数
+	     * @param config 种群大小与各种比率
+	     * @param weight_of 边权重访问函数
+	     * @param seed 随机种子
+	     */
+	    Island(Vertex const start, Vertex const end, int const vertices, IslandConfig const& config, WeightFn weight_of,
+	           std::uint32_t const seed)
+	        : m_config(config), m_weightOf(std::move(weight_of)), m_rng(seed),
+	          m_selector(config.selection, config.tournament_size, std::max(0, config.population_size))
+	    {
+	        auto const initial = initialize_population<Vertex>(start, end, vertices, config.population_size, m_rng);
+	        int const width = initial.empty() ? 0 : static_cast<int>(initial.front().size());
+	        m_current = Individuals(static_cast<int>(initial.size()), width);
+	        m_next = Individuals(static_cast<int>(initial.size()), width);
+	        for (int i = 0; i < m_current.size(); ++i) {
+	            std::ranges::copy(initial[i], m_current[i].begin());
+	        }
+	        m_used.assign(static_cast<std::size_t>(vertices), 0);
+	        m_order.resize(initial.size());
+	        m_best.reserve(width);
+	    }
+
+	    /**
+	     * @brief 评估当前种群并产生下一代。
+	     * @return 本代的最短距离，没有有效路径时为 Distance 的最大值
+	     */
+	    Distance evolve()
+	    {
+	        Distance const best = evaluate();
+	        breed();
+	        return best;
+	    }
+
+	    /**
+	     * @brief 计算当前种群每条路径的距离，并更新历史最优路径；已评估过的种群直接返回缓存的结果。
+	     * @return 本代的最短距离，没有有效路径时为 Distance 的最大值
+	     */
+	    Distance evaluate()
+	    {
+	        if (m_evaluated) {
+	            return m_generationBest;
+	        }
+
+	        m_generationBest = std::numeric_limits<Distance>::max();
+	        for (int i = 0; i < m_current.size(); ++i) {
+	            auto const path = m_current[i];
+	            m_current.distance(i) = is_valid_path(path, m_weightOf) ? calculate_path_distance(path, m_weightOf) : -1;
+	            record(i);
+	        }
+	        m_evaluated = true;
+	        return m_generationBest;
+	    }
+
+	    /**
+	     * @brief 由已评估的当前种群产生下一代：精英保留，其余由选择、交叉和变异生成。
+	     */
+	    void breed()
+	    {
+	        int filled = 0;
+
+	        // 精英保留
+	        ranking();
+	        for (int const i : m_order) {
+	            if (filled >= m_config.elite_size || m_current.distance(i) == -1) {
+	                break;
+	            }
+	            m_next.assign(filled++, m_current, i);
+	        }
+
+	        // 选择、交叉和变异
+	        if (filled < m_next.size()) {
+	            m_selector.prepare(m_current.distances(), 2 * (m_next.size() - filled), m_rng);
+	        }
+	        for (; filled < m_next.size(); ++filled) {
+	            int const parent1 = m_selector.next(m_rng);
+	            int const parent2 = m_selector.next(m_rng);
+
+	            auto const child = m_next[filled];
+	            if (std::uniform_real_distribution<>(0.0, 1.0)(m_rng) < m_config.crossover_rate) {
+	                crossover<Vertex>(std::as_const(m_current)[parent1], std::as_const(m_current)[parent2], child, m_rng,
+	                                  m_used);
+	            }
+	            else {
+	                std::ranges::copy(m_current[parent1], child.begin());
+	            }
+
+	            if (std::uniform_real_distribution<>(0.0, 1.0)(m_rng) < m_config.mutation_rate) {
+	                mutate(child, m_rng);
+	            }
+	        }
+
+	        m_current.swap(m_next);
+	        m_evaluated = false;
+	    }
+
+	    /**
+	     * @brief 评估当前种群，把其中最短的至多 out.size() 条路径依次写入 out，没有足够的有效路径时其余的距离为 -1。
+	     */
+	    void emigrants(Individuals& out)
+	    {
+	        evaluate();
+	        ranking();
+	        for (int k = 0; k < out.size(); ++k) {
+	            if (k < m_current.size()) {
+	                out.assign(k, m_current, m_order[k]);
+	            }
+	            else {
+	                out.distance(k) = -1;
+	            }
+	        }
+	    }
+
+	    /**
+	     * @brief 评估当前种群，用 migrants 中的有效路径依次替换最差的个体（无效路径最先被替换）。
+	     */
+	    void immigrate(Individuals const& migrants)
+	    {
+	        evaluate();
+	        ranking();
+	        int replaced = 0;
+	        for (int k = 0; k < migrants.size() && replaced < m_current.size(); ++k) {
+	            if (migrants.distance(k) == -1) {
+	                continue;
+	            }
+	            int const target = m_order[m_order.size() - 1 - replaced++];
+	            m_current.assign(target, migrants, k);
+	            record(target);
+	        }
+	    }
+
+	    /// 历史最优路径，尚无有效路径时为空
+	    [[nodiscard]] Path const& best() const noexcept { return m_best; }
+	    [[nodiscard]] Distance bestDistance() const noexcept { return m_bestDistance; }
+	    /// 每条路径的顶点数
+	    [[nodiscard]] int width() const noexcept { return m_current.width(); }
+
+	private:
+	    /// 用已评估的第 i 个个体更新本代与历史最优
+	    void record(int const i)
+	    {
+	        Distance const distance = m_current.distance(i);
+	        if (distance == -1) {
+	            return;
+	        }
+	        m_generationBest = std::min(m_generationBest, distance);
+	        if (m_best.empty() || distance < m_bestDistance) {
+	            m_bestDistance = distance;
+	            m_best.assign(m_current[i].begin(), m_current[i].end());
+	        }
+	    }
+
+	    /// 把个体下标按距离升序排列到 m_order，无效路径排在最后，距离相同时按下标
+	    void ranking()
+	    {
+	        std::iota(m_order.begin(), m_order.end(), 0);
+	        std::ranges::sort(m_order, [this](int const a, int const b)
+	        {
+	            auto const key = [this](int const i)
+	            {
+	                Distance const distance = m_current.distance(i);
+	                return std::pair{distance == -1 ? std::numeric_limits<Distance>::max() : distance, i};
+	            };
+	            return key(a) < key(b);
+	        });
+	    }
+
+	    IslandConfig m_config; ///< 种群大小与各种比率
+	    WeightFn m_weightOf; ///< 边权重访问函数
+	    std::mt19937 m_rng; ///< 本种群的随机数生成器
+	    Selector<Distance> m_selector; ///< 选择算子
+	    Individuals m_current{}; ///< 当前种群
+	    Individuals m_next{}; ///< 下一代的缓冲区
+	    std::vector<std::uint8_t> m_used{}; ///< 交叉时按顶点编号计数的暂存区
+	    std::vector<int> m_order{}; ///< 排序后的个体下标
+	    bool m_evaluated{false}; ///< 当前种群的距离是否已计算
+	    Distance m_generationBest{}; ///< 当前种群的最短距离
+	    Path m_best{}; ///< 历史最优路径
+	    Distance m_bestDistance{-1}; ///< 历史最优距离
+	};
+
+	/*****************************************************************
+	 *
+	 *		岛屿模型
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 岛屿模型遗传算法
+	 *
+	 * 每个岛屿是一个 Island，随机种子由 config.seed 与岛屿编号派生。岛屿交错分配给各线程，
+	 * 线程在两次迁移之间只演化自己的岛屿，不加锁；每 migration_interval 代后各岛屿把精英写入自己的发送区，
+	 * 所有线程到达屏障后由屏障的完成函数按拓扑把发送区中的精英替换到目标岛屿最差的个体上。
+	 * 结果只取决于种子与参数，与线程数无关。
+	 *
+	 * @param start 起点
+	 * @param end 终点
+	 * @param vertices 顶点数
+	 * @param weight_of 边权重访问函数，-1 表示无边
+	 * @param config 岛屿、种群与迁移参数
+	 * @return 所有岛屿中的最优路径，没有有效路径时为空
+	 */
+	template <typename Vertex, typename WeightFn>
+	inline auto island_model(Vertex const start, Vertex const end, int const vertices, WeightFn const& weight_of,
+	                         IslandConfig const& config) -> std::vector<Vertex>
+	{
+		unsigned const hardware = std::max(1u, std::thread::hardware_concurrency());
+		int const count = config.islands > 0 ? config.islands : static_cast<int>(hardware);
+		unsigned const threads = std::min(config.threads > 0 ? config.threads : hardware, static_cast<unsigned>(count));
+		int const interval = std::max(1, config.migration_interval);
+		int const epochs = std::max(1, (config.generations + interval - 1) / interval);
+		std::uint32_t const seed = config.seed != 0 ? config.seed : std::random_device{}();
+
+		// 由种子与编号派生各自的随机种子，编号 count 留给迁移
+		auto const derive = [seed](int const k)
+		{
+			std::seed_seq sequence{seed, static_cast<std::uint32_t>(k)};
+			std::array<std::uint32_t, 1> state{};
+			sequence.generate(state.begin(), state.end());
+			return state[0];
+		};
+
+		std::vector<Island<Vertex, WeightFn>> islands;
+		islands.reserve(count);
+		for (int k = 0; k < count; ++k) {
+			islands.emplace_back(start, end, vertices, config, weight_of, derive(k));
+		}
+		// 每个岛屿本次送出的精英
+		std::vector<Population<Vertex, typename Island<Vertex, WeightFn>::Distance>> outbox;
+		outbox.reserve(count);
+		for (int k = 0; k < count; ++k) {
+			outbox.emplace_back(std::max(0, config.migrants), islands[k].width());
+		}
+
+		std::mt19937 migration_rng(derive(count));
+		int epoch = 0;
+		bool stop = false;
+		auto const migrate = [&]() noexcept
+		{
+			if (count > 1) {
+				for (int k = 0; k < count; ++k) {
+					int const source = config.topology == MigrationTopology::Ring
+						? (k + count - 1) % count
+						: (k + 1 + std::uniform_int_distribution<int>(0, count - 2)(migration_rng)) % count;
+					islands[k].immigrate(outbox[source]);
+				}
+			}
+			++epoch;
+			stop = epoch >= epochs;
+		};
+
+		std::barrier sync(static_cast<std::ptrdiff_t>(threads), migrate);
+		auto const worker = [&](unsigned const t)
+		{
+			while (!stop) {
+				int const generations = std::min(interval, config.generations - epoch * interval);
+				for (int k = static_cast<int>(t); k < count; k += static_cast<int>(threads)) {
+					for (int g = 0; g < generations; ++g) {
+						islands[k].evolve();
+					}
+					islands[k].emigrants(outbox[k]);
+				}
+				sync.arrive_and_wait();
+			}
+		};
+
+		std::vector<std::future<void>> futures;
+		futures.reserve(threads);
+		for (unsigned t = 0; t < threads; ++t) {
+			futures.emplace_back(std::async(std::launch::async, worker, t));
+		}
+		for (auto& future : futures) {
+			future.get();
+		}
+
+		auto const winner = std::ranges::min_element(islands, {}, [](auto const& island)
+		{
+			return island.best().empty() ? std::numeric_limits<decltype(island.bestDistance())>::max()
+			                             : island.bestDistance();
+		});
+		return winner->best();
+	}
+}
+
+#endif
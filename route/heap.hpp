@@ -0,0 +1,571 @@
+﻿// Purpose: 最短路径算法使用的优先队列与工作区
+// Author:  Cmixed
+#pragma once
+
+#ifndef HEAP_HPP
+#define HEAP_HPP
+
+#include "pch.hpp"
+
+namespace route
+{
+	/*****************************************************************
+	 *
+	 *		IndexedHeap 类
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 带位置索引的 d 叉最小堆
+	 *
+	 * 元素为 [0, n) 内的编号，每个编号至多在堆中出现一次，m_position 记录其在堆数组中的下标，
+	 * 因此可以 O(log_d n) 地降低已在堆中元素的键值（decrease-key），无需像惰性队列那样重复入队。
+	 * 4 叉堆比二叉堆更浅，下沉时比较的 4 个子节点位于同一缓存行内。
+	 * clear 只重置仍在堆中的元素的位置，容量保留，便于跨查询复用。
+	 *
+	 * @tparam Key 键值类型
+	 * @tparam Arity 分叉数
+	 */
+	template <typename Key, int Arity = 4>
+	class IndexedHeap
+	{
+	    static_assert(Arity >= 2);
+
+	public:
+	    using Index = std::uint32_t;
+	    static constexpr Index npos = std::numeric_limits<Index>::max(); ///< 不在堆中
+
+	    struct Node {
+	        Key key;
+	        Index index;
+	    };
+
+	    IndexedHeap() = default;
+	    explicit(true) IndexedHeap(std::size_t const n) { reserve(n); }
+
+	    /**
+	     * @brief 保证可以容纳编号 [0, n)。
+	     */
+	    void reserve(std::size_t const n)
+	    {
+	        if (m_position.size() < n) {
+	            m_position.resize(n, npos);
+	            m_heap.reserve(n);
+	        }
+	    }
+
+	    [[nodiscard]] bool empty() const noexcept { return m_heap.empty(); }
+	    [[nodiscard]] std::size_t size() const noexcept { return m_heap.size(); }
+	    [[nodiscard]] bool contains(Index const i) const noexcept { return m_position[i] != npos; }
+	    [[nodiscard]] Node const& top() const noexcept { return m_heap.front(); }
+
+	    /**
+	     * @brief 插入编号 i，或在 key 更小时降低其键值。
+	     * @return true 如果插入或降低了键值
+	     */
+	    bool pushOrDecrease(Index const i, Key const key)
+	    {
+	        if (Index const pos = m_position[i]; pos != npos) {
+	            if (!(key < m_heap[pos].key)) {
+	                return false;
+	            }
+	            m_heap[pos].key = key;
+	            siftUp(pos);
+	            return true;
+	        }
+	        m_heap.push_back({key, i});
+	        siftUp(static_cast<Index>(m_heap.size() - 1));
+	        return true;
+	    }
+
+	    /**
+	     * @brief 弹出键值最小的元素。
+	     */
+	    Node pop()
+	    {
+	        Node const result = m_heap.front();
+	        m_position[result.index] = npos;
+	        Node const last = m_heap.back();
+	        m_heap.pop_back();
+	        if (!m_heap.empty()) {
+	            m_heap.front() = last;
+	            m_position[last.index] = 0;
+	            siftDown(0);
+	        }
+	        return result;
+	    }
+
+	    /**
+	     * @brief 清空堆，复杂度与堆中剩余元素数成正比。
+	     */
+	    void clear() noexcept
+	    {
+	        for (Node const& node : m_heap) {
+	            m_position[node.index] = npos;
+	        }
+	        m_heap.clear();
+	    }
+
+	private:
+	    void siftUp(Index pos)
+	    {
+	        Node const node = m_heap[pos];
+	        while (pos > 0) {
+	            Index const parent = (pos - 1) / Arity;
+	            if (!(node.key < m_heap[parent].key)) {
+	                break;
+	            }
+	            m_heap[pos] = m_heap[parent];
+	            m_position[m_heap[pos].index] = pos;
+	            pos = parent;
+	        }
+	        m_heap[pos] = node;
+	        m_position[node.index] = pos;
+	    }
+
+	    void siftDown(Index pos)
+	    {
+	        auto const n = static_cast<Index>(m_heap.size());
+	        Node const node = m_heap[pos];
+	        while (true) {
+	            Index const first = pos * Arity + 1;
+	            if (first >= n) {
+	                break;
+	            }
+	            Index const last = std::min<Index>(first + Arity, n);
+	            Index best = first;
+	            for (Index c = first + 1; c < last; ++c) {
+	                if (m_heap[c].key < m_heap[best].key) {
+	                    best = c;
+	                }
+	            }
+	            if (!(m_heap[best].key < node.key)) {
+	                break;
+	            }
+	            m_heap[pos] = m_heap[best];
+	            m_position[m_heap[pos].index] = pos;
+	            pos = best;
+	        }
+	        m_heap[pos] = node;
+	        m_position[node.index] = pos;
+	    }
+
+	    std::vector<Node> m_heap{}; ///< 堆数组
+	    std::vector<Index> m_position{}; ///< 编号 -> 堆数组下标
+	};
+
+	/*****************************************************************
+	 *
+	 *		单调整数优先队列
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 单调整数队列的公共部分：记录每个编号当前的键值，识别并跳过过期元素。
+	 *
+	 * 降键时不移动旧元素，而是以新键值再入队一次；旧元素出队时因键值与记录不符而被丢弃。
+	 * 单调队列要求入队的键值不小于最近一次出队的键值，Dijkstra 在非负权图上满足这一点。
+	 */
+	template <typename Key>
+	class MonotoneQueueBase
+	{
+	    static_assert(std::is_integral_v<Key>, "单调队列只支持整数键值");
+
+	public:
+	    using Index = std::uint32_t;
+	    static constexpr Key absent = std::numeric_limits<Key>::max(); ///< 不在队列中
+
+	    struct Node {
+	        Key key;
+	        Index index;
+	    };
+
+	    [[nodiscard]] bool empty() const noexcept { return m_live == 0; }
+	    [[nodiscard]] std::size_t size() const noexcept { return m_live; }
+	    [[nodiscard]] bool contains(Index const i) const noexcept { return m_key[i] != absent; }
+
+	protected:
+	    void reserveKeys(std::size_t const n)
+	    {
+	        if (m_key.size() < n) {
+	            m_key.resize(n, absent);
+	        }
+	    }
+
+	    /// 记录 i 的新键值，返回 false 表示 key 没有更小、无需入队
+	    bool updateKey(Index const i, Key const key)
+	    {
+	        if (m_key[i] == absent) {
+	            m_touched.push_back(i);
+	            ++m_live;
+	        } else if (!(key < m_key[i])) {
+	            return false;
+	        }
+	        m_key[i] = key;
+	        return true;
+	    }
+
+	    [[nodiscard]] bool isLive(Node const& node) const noexcept { return m_key[node.index] == node.key; }
+
+	    void markPopped(Index const i) noexcept
+	    {
+	        m_key[i] = absent;
+	        --m_live;
+	    }
+
+	    void clearKeys() noexcept
+	    {
+	        for (Index const i : m_touched) {
+	            m_key[i] = absent;
+	        }
+	        m_touched.clear();
+	        m_live = 0;
+	    }
+
+	private:
+	    std::vector<Key> m_key{}; ///< 编号 -> 当前键值
+	    std::vector<Index> m_touched{}; ///< 入过队的编号
+	    std::size_t m_live{0}; ///< 队列中的编号数（不含过期元素）
+	};
+
+	/**
+	 * @brief 基数堆（radix heap）
+	 *
+	 * 以最近一次出队的键值 last 为基准，键值 k 放入第 bit_width(k ^ last) 号桶，
+	 * 0 号桶中的元素键值都等于 last。0 号桶为空时取出最小的非空桶，以其中的最小键值为新的 last
+	 * 重新分配该桶，元素只会移向更低的桶，因此每个元素至多移动 位数 次，
+	 * 操作摊还 O(log C)，且只做整数比较与顺序访问。
+	 */
+	template <typename Key>
+	class RadixHeap : public MonotoneQueueBase<Key>
+	{
+	    using Base = MonotoneQueueBase<Key>;
+	    using Unsigned = std::make_unsigned_t<Key>;
+	    static constexpr int bucket_count = std::numeric_limits<Unsigned>::digits + 1;
+
+	public:
+	    using typename Base::Index;
+	    using typename Base::Node;
+
+	    void reserve(std::size_t const n) { this->reserveKeys(n); }
+
+	    bool pushOrDecrease(Index const i, Key const key)
+	    {
+	        if (!this->updateKey(i, key)) {
+	            return false;
+	        }
+	        m_buckets[bucketOf(key)].push_back({key, i});
+	        return true;
+	    }
+
+	    /**
+	     * @brief 键值最小的元素，队列不能为空。
+	     */
+	    [[nodiscard]] Node const& top()
+	    {
+	        normalize();
+	        return m_buckets[0].back();
+	    }
+
+	    Node pop()
+	    {
+	        normalize();
+	        Node const node = m_buckets[0].back();
+	        m_buckets[0].pop_back();
+	        this->markPopped(node.index);
+	        return node;
+	    }
+
+	    void clear() noexcept
+	    {
+	        for (auto& bucket : m_buckets) {
+	            bucket.clear();
+	        }
+	        m_last = 0;
+	        this->clearKeys();
+	    }
+
+	private:
+	    [[nodiscard]] int bucketOf(Key const key) const noexcept
+	    {
+	        return std::bit_width(static_cast<Unsigned>(key) ^ static_cast<Unsigned>(m_last));
+	    }
+
+	    /// 丢弃过期元素，保证 0 号桶末尾是一个有效的最小元素
+	    void normalize()
+	    {
+	        auto& front = m_buckets[0];
+	        while (!front.empty() && !this->isLive(front.back())) {
+	            front.pop_back();
+	        }
+	        if (!front.empty()) {
+	            return;
+	        }
+
+	        int i = 1;
+	        Key minimum = Base::absent;
+	        for (; i < bucket_count; ++i) {
+	            auto& bucket = m_buckets[i];
+	            std::erase_if(bucket, [this](Node const& node) { return !this->isLive(node); });
+	            if (!bucket.empty()) {
+	                for (Node const& node : bucket) {
+	                    minimum = std::min(minimum, node.key);
+	                }
+	                break;
+	            }
+	        }
+
+	        m_last = minimum;
+	        auto& source = m_buckets[i];
+	        for (Node const& node : source) {
+	            m_buckets[bucketOf(node.key)].push_back(node);
+	        }
+	        source.clear();
+	    }
+
+	    std::array<std::vector<Node>, bucket_count> m_buckets{}; ///< 桶
+	    Key m_last{0}; ///< 最近一次出队的键值
+	};
+
+	/**
+	 * @brief Dial 桶队列
+	 *
+	 * 以键值为下标的环形桶数组，环的大小为大于 (最大键值 - 当前最小键值) 的 2 的幂，
+	 * 出现更大的跨度时加倍并重新分配。最大边权为 C 时跨度不超过 C + 1，
+	 * 入队 O(1)，出队摊还 O(1) 加上游标扫过的空桶数，适合最大权重较小的图。
+	 * 跨度超过 max_buckets 时抛出 std::length_error，此时队列需 clear 后才能继续使用；
+	 * 权重较大的图应使用 RadixHeapQueue。
+	 */
+	template <typename Key>
+	class BucketQueue : public MonotoneQueueBase<Key>
+	{
+	    using Base = MonotoneQueueBase<Key>;
+
+	public:
+	    using typename Base::Index;
+	    using typename Base::Node;
+
+	    static constexpr std::size_t max_buckets = std::size_t{1} << 20; ///< 环形数组大小的上限
+
+	    void reserve(std::size_t const n) { this->reserveKeys(n); }
+
+	    /**
+	     * @throw std::length_error 如果键值跨度超过 max_buckets
+	     */
+	    bool pushOrDecrease(Index const i, Key const key)
+	    {
+	        if (!this->updateKey(i, key)) {
+	            return false;
+	        }
+	        if (m_stored == 0) {
+	            m_cursor = m_maximum = key;
+	        } else {
+	            m_cursor = std::min(m_cursor, key);
+	            m_maximum = std::max(m_maximum, key);
+	        }
+	        if (static_cast<std::size_t>(m_maximum - m_cursor) >= m_buckets.size()) {
+	            grow(static_cast<std::size_t>(m_maximum - m_cursor) + 1);
+	        }
+	        m_buckets[slot(key)].push_back({key, i});
+	        ++m_stored;
+	        return true;
+	    }
+
+	    /**
+	     * @brief 键值最小的元素，队列不能为空。
+	     */
+	    [[nodiscard]] Node const& top()
+	    {
+	        normalize();
+	        return m_buckets[slot(m_cursor)].back();
+	    }
+
+	    Node pop()
+	    {
+	        normalize();
+	        auto& bucket = m_buckets[slot(m_cursor)];
+	        Node const node = bucket.back();
+	        bucket.pop_back();
+	        --m_stored;
+	        this->markPopped(node.index);
+	        return node;
+	    }
+
+	    void clear() noexcept
+	    {
+	        for (auto& bucket : m_buckets) {
+	            bucket.clear();
+	        }
+	        m_stored = 0;
+	        this->clearKeys();
+	    }
+
+	private:
+	    [[nodiscard]] std::size_t slot(Key const key) const noexcept
+	    {
+	        return static_cast<std::size_t>(key) & (m_buckets.size() - 1);
+	    }
+
+	    /// 游标前移到第一个含有效元素的桶，沿途丢弃过期元素
+	    void normalize()
+	    {
+	        while (true) {
+	            auto& bucket = m_buckets[slot(m_cursor)];
+	            while (!bucket.empty() && !this->isLive(bucket.back())) {
+	                bucket.pop_back();
+	                --m_stored;
+	            }
+	            if (!bucket.empty()) {
+	                return;
+	            }
+	            ++m_cursor;
+	        }
+	    }
+
+	    /// 扩大环形数组，使其能容纳 span 个连续键值
+	    void grow(std::size_t const span)
+	    {
+	        if (span > max_buckets) {
+	            throw std::length_error("桶队列的键值跨度超出上限");
+	        }
+	        std::vector<std::vector<Node>> buckets(std::bit_ceil(std::max(span, m_buckets.size() * 2)));
+	        for (auto& bucket : m_buckets) {
+	            for (Node const& node : bucket) {
+	                buckets[static_cast<std::size_t>(node.key) & (buckets.size() - 1)].push_back(node);
+	            }
+	        }
+	        m_buckets = std::move(buckets);
+	    }
+
+	    std::vector<std::vector<Node>> m_buckets = std::vector<std::vector<Node>>(64); ///< 环形桶数组，大小为 2 的幂
+	    std::size_t m_stored{0}; ///< 桶中的元素数（含过期元素）
+	    Key m_cursor{0}; ///< 不大于所有有效元素的键值，出队时前移到最小键值
+	    Key m_maximum{0}; ///< 入过队的最大键值
+	};
+
+	/*****************************************************************
+	 *
+	 *		队列策略
+	 *
+	 *****************************************************************/
+
+	/// 索引 4 叉堆，适用于任意键值，默认策略
+	struct IndexedHeapQueue {
+	    template <typename Key>
+	    using type = IndexedHeap<Key>;
+	};
+
+	/// 基数堆，适用于整数权重
+	struct RadixHeapQueue {
+	    template <typename Key>
+	    using type = RadixHeap<Key>;
+	};
+
+	/// Dial 桶队列，适用于最大权重较小的整数权重
+	struct DialQueue {
+	    template <typename Key>
+	    using type = BucketQueue<Key>;
+	};
+
+	using DefaultQueue = IndexedHeapQueue;
+
+	/*****************************************************************
+	 *
+	 *		SearchWorkspace 类
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 单源搜索的可复用工作区
+	 *
+	 * 保存距离、前驱与优先队列。数组按出现过的最大顶点数分配一次，
+	 * 每次查询只记录被写过的顶点，结束时仅重置这些顶点，查询开销与搜索范围而非图的规模成正比。
+	 * 通过 lease 获取，租约析构时自动重置。
+	 *
+	 * @tparam Distance 距离类型
+	 * @tparam VertexId 顶点编号类型
+	 * @tparam Queue 优先队列类型，键值为 Distance 或 A* 的 double
+	 */
+	template <typename Distance, typename VertexId, typename Queue = IndexedHeap<Distance>>
+	class SearchWorkspace
+	{
+	public:
+	    static constexpr Distance infinity = std::numeric_limits<Distance>::max();
+
+	    std::vector<Distance> dist{}; ///< 当前距离，未到达为 infinity
+	    std::vector<VertexId> prev{}; ///< 前驱（反向搜索中为后继）
+	    Queue heap{}; ///< 优先队列
+
+	    /**
+	     * @brief 写入顶点 v 的距离与前驱。
+	     */
+	    void set(VertexId const v, Distance const d, VertexId const p)
+	    {
+	        if (dist[v] == infinity) {
+	            m_touched.push_back(v);
+	        }
+	        dist[v] = d;
+	        prev[v] = p;
+	    }
+
+	    /**
+	     * @brief 查询期间持有工作区，析构时重置。
+	     */
+	    class Lease
+	    {
+	    public:
+	        explicit(true) Lease(SearchWorkspace& workspace) : m_workspace(workspace) {}
+	        ~Lease() { m_workspace.reset(); }
+	        Lease(Lease const&) = delete;
+	        Lease& operator=(Lease const&) = delete;
+
+	    private:
+	        SearchWorkspace& m_workspace;
+	    };
+
+	    /**
+	     * @brief 为 n 个顶点准备工作区。
+	     * @param invalid 前驱数组的空值
+	     */
+	    [[nodiscard]] Lease lease(int const n, VertexId const invalid)
+	    {
+	        auto const size = static_cast<std::size_t>(n);
+	        if (dist.size() < size || m_invalid != invalid) {
+	            m_invalid = invalid;
+	            dist.assign(std::max(size, dist.size()), infinity);
+	            prev.assign(dist.size(), invalid);
+	            heap.reserve(dist.size());
+	        }
+	        return Lease(*this);
+	    }
+
+	private:
+	    void reset()
+	    {
+	        for (VertexId const v : m_touched) {
+	            dist[v] = infinity;
+	            prev[v] = m_invalid;
+	        }
+	        m_touched.clear();
+	        heap.clear();
+	    }
+
+	    std::vector<VertexId> m_touched{}; ///< 本次查询写过的顶点
+	    VertexId m_invalid{}; ///< 前驱数组的空值
+	};
+
+	/**
+	 * @brief 当前线程的工作区。
+	 *
+	 * 同一图可以被多个线程同时查询，因此工作区按线程而非按图保存；
+	 * Slot 用于需要多个工作区的算法，例如双向搜索。
+	 */
+	template <typename Workspace, int Slot = 0>
+	inline Workspace& thread_workspace()
+	{
+		thread_local Workspace workspace;
+		return workspace;
+	}
+}
+
+#endif
@@ -0,0 +1,409 @@
+﻿// Purpose: 枢纽标签（Hub Labeling）距离索引，以剪枝地标标注（PLL）构建
+// Author:  Cmixed
+#pragma once
+
+#ifndef HUB_LABEL_HPP
+#define HUB_LABEL_HPP
+
+#include "pch.hpp"
+#include "data.hpp"
+#include "heap.hpp"
+#include "landmark.hpp"
+#include "simd.hpp"
+
+namespace route
+{
+	/*****************************************************************
+	 *
+	 *		HubLabelIndex 类
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 枢纽标签索引
+	 *
+	 * 每个顶点 v 保存离开标签 L_out(v)（v 到各枢纽的距离）与到达标签 L_in(v)（各枢纽到 v 的距离），
+	 * 标签项按枢纽的序号升序存放。d(s, t) = min over 公共枢纽 h of L_out(s)[h] + L_in(t)[h]，
+	 * 查询只是两个有序数组的归并求交，AVX2 可用时以 8 × 8 的分块比较进行。无向图两种标签相同，只存一份。
+	 *
+	 * 构建按给定顺序（越重要越靠前）依次以每个顶点为枢纽做剪枝 Dijkstra：若已有标签已能给出
+	 * 不长于当前距离的结果，则该顶点不加入标签且不再扩展。每个标签项另存路径上指向枢纽方向的相邻顶点，
+	 * 由此逐跳还原路径。
+	 *
+	 * @tparam V 顶点编号类型
+	 * @tparam W 边权重类型
+	 */
+	template <typename V, typename W>
+	class HubLabelIndex
+	{
+	public:
+		using Graph = WeightedAdjMatrixGraph<V, W>;
+		using Traits = typename Graph::Traits;
+		using VertexId = V;
+		using Distance = typename Graph::Distance;
+		using Path = typename Graph::Path;
+		using PathResult = typename Graph::PathResult;
+
+		/// 标签中距离的上限（不含），保证两段距离之和不超出 32 位无符号整数
+		static constexpr std::uint32_t max_distance = std::uint32_t{1} << 31;
+		static constexpr std::uint32_t unreachable = std::numeric_limits<std::uint32_t>::max(); ///< 不可达
+
+		/// 一个顶点的标签，三个数组按下标对应
+		struct Label {
+		    std::span<std::uint32_t const> hubs; ///< 枢纽序号，升序
+		    std::span<std::uint32_t const> distances; ///< 到枢纽（或从枢纽出发）的距离
+		    std::span<VertexId const> parents; ///< 路径上朝向枢纽的相邻顶点，枢纽自身为 invalid_vertex
+		};
+
+		HubLabelIndex() = default;
+
+		/**
+		 * @brief 构建标签。
+		 * @param graph 图，需已 finalize
+		 * @param order 枢纽顺序，越重要越靠前，须为全部顶点的排列；为空时按度数降序
+		 * @throw std::length_error 如果某个距离不小于 max_distance
+		 */
+		[[nodiscard]] static auto build(Graph const& graph, std::span<VertexId const> order = {}) -> HubLabelIndex;
+
+		[[nodiscard]] bool empty() const noexcept { return m_vertices == 0; }
+		[[nodiscard]] int vertexCount() const noexcept { return m_vertices; }
+		[[nodiscard]] bool matches(Graph const& graph) const
+		{
+			return graph.vertexCount() == m_vertices && graph.symmetric() != m_directed
+				&& landmark::fingerprint(graph) == m_fingerprint;
+		}
+
+		/// 全部标签项数，有向图为两种标签之和
+		[[nodiscard]] std::size_t entryCount() const noexcept
+		{
+			return m_labels[0].hubs.size() + m_labels[1].hubs.size();
+		}
+
+		[[nodiscard]] Label outLabel(VertexId const v) const noexcept { return label(m_labels[0], v); }
+		[[nodiscard]] Label inLabel(VertexId const v) const noexcept { return label(m_labels[m_directed ? 1 : 0], v); }
+
+		/**
+		 * @brief 只计算距离。
+		 * @return 最短距离，不可达时为 -1
+		 */
+		[[nodiscard]] Distance distance(VertexId start, VertexId end) const noexcept;
+
+		/**
+		 * @brief 计算距离并逐跳还原路径。
+		 * @return 最短路径和距离，不可达时距离为 -1
+		 */
+		[[nodiscard]] auto query(VertexId start, VertexId end) const -> PathResult;
+
+	private:
+		/// 一种标签的扁平存储：offsets[v] .. offsets[v + 1] 为 v 的标签项
+		struct Labels {
+		    std::vector<std::size_t> offsets{};
+		    std::vector<std::uint32_t> hubs{};
+		    std::vector<std::uint32_t> distances{};
+		    std::vector<VertexId> parents{};
+		};
+
+		[[nodiscard]] static Label label(Labels const& labels, VertexId const v) noexcept
+		{
+			std::size_t const begin = labels.offsets[v], size = labels.offsets[v + 1] - begin;
+			return {{labels.hubs.data() + begin, size}, {labels.distances.data() + begin, size},
+			        {labels.parents.data() + begin, size}};
+		}
+
+		int m_vertices{0}; ///< 顶点数
+		bool m_directed{false}; ///< 是否分别存储离开与到达标签
+		std::uint64_t m_fingerprint{0}; ///< 构建时图的边散列
+		std::vector<VertexId> m_order{}; ///< 枢纽序号 -> 顶点
+		std::array<Labels, 2> m_labels{}; ///< 离开标签与到达标签，无向图只用前者
+
+		template <typename V2, typename W2>
+		friend bool save_hub_labels(HubLabelIndex<V2, W2> const& index, const std::string& filename);
+		template <typename V2, typename W2>
+		friend std::optional<HubLabelIndex<V2, W2>> load_hub_labels(WeightedAdjMatrixGraph<V2, W2> const& graph,
+		                                                            const std::string& filename);
+	};
+
+	using WHubLabelIndex = HubLabelIndex<WGraph::VertexId, WGraph::Weight>;
+
+	namespace hub_label
+	{
+#if ROUTE_SIMD_X86
+		/**
+		 * @brief min_sum 的 AVX2 部分：每次取两侧各 8 项，将 b 的块循环移位 8 次与 a 的块逐一比较，
+		 * 末项较小的一侧前进（相等时两侧都前进）。返回已比较部分的最小值，i、j 停在剩余不足 8 项处。
+		 */
+		ROUTE_TARGET_AVX2
+		inline std::uint32_t min_sum_avx2(std::span<std::uint32_t const> const hubs_a,
+		                                  std::span<std::uint32_t const> const dist_a,
+		                                  std::span<std::uint32_t const> const hubs_b,
+		                                  std::span<std::uint32_t const> const dist_b,
+		                                  std::size_t& i, std::size_t& j) noexcept
+		{
+			__m256i const rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+			__m256i minimum = _mm256_set1_epi32(-1);
+			while (i + 8 <= hubs_a.size() && j + 8 <= hubs_b.size()) {
+				__m256i const ha = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(hubs_a.data() + i));
+				__m256i const da = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dist_a.data() + i));
+				__m256i hb = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(hubs_b.data() + j));
+				__m256i db = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dist_b.data() + j));
+				for (int r = 0; r < 8; ++r) {
+					// 不相等的位置或上全 1，取无符号最小值时自然被忽略
+					__m256i const mismatch = _mm256_xor_si256(_mm256_cmpeq_epi32(ha, hb), _mm256_set1_epi32(-1));
+					minimum = _mm256_min_epu32(minimum, _mm256_or_si256(_mm256_add_epi32(da, db), mismatch));
+					hb = _mm256_permutevar8x32_epi32(hb, rotate);
+					db = _mm256_permutevar8x32_epi32(db, rotate);
+				}
+				std::uint32_t const last_a = hubs_a[i + 7], last_b = hubs_b[j + 7];
+				i += last_a <= last_b ? 8 : 0;
+				j += last_b <= last_a ? 8 : 0;
+			}
+			alignas(32) std::array<std::uint32_t, 8> lanes{};
+			_mm256_store_si256(reinterpret_cast<__m256i*>(lanes.data()), minimum);
+			return *std::ranges::min_element(lanes);
+		}
+#endif
+
+		/**
+		 * @brief 两个有序标签归并求交，返回公共枢纽上距离和的最小值，无公共枢纽时为 unreachable。
+		 *
+		 * 两侧都不少于 8 项且 CPU 支持 AVX2 时先由 min_sum_avx2 分块比较，剩余部分按标量归并；
+		 * 指令集在运行期检测，程序本身按默认指令集编译。
+		 */
+		inline std::uint32_t min_sum(std::span<std::uint32_t const> const hubs_a, std::span<std::uint32_t const> const dist_a,
+		                             std::span<std::uint32_t const> const hubs_b, std::span<std::uint32_t const> const dist_b)
+			noexcept
+		{
+			std::uint32_t best = std::numeric_limits<std::uint32_t>::max();
+			std::size_t i = 0, j = 0;
+#if ROUTE_SIMD_X86
+			if (hubs_a.size() >= 8 && hubs_b.size() >= 8 && simd::has_avx2()) {
+				best = min_sum_avx2(hubs_a, dist_a, hubs_b, dist_b, i, j);
+			}
+#endif
+			while (i < hubs_a.size() && j < hubs_b.size()) {
+				if (hubs_a[i] < hubs_b[j]) {
+					++i;
+				} else if (hubs_b[j] < hubs_a[i]) {
+					++j;
+				} else {
+					best = std::min(best, dist_a[i++] + dist_b[j++]);
+				}
+			}
+			return best;
+		}
+
+		/**
+		 * @brief 标量归并求交，额外返回取得最小值的两个下标，供还原路径使用。
+		 * @return {距离和, a 中的下标, b 中的下标}，无公共枢纽时距离和为 unreachable
+		 */
+		inline auto arg_min_sum(std::span<std::uint32_t const> const hubs_a, std::span<std::uint32_t const> const dist_a,
+		                        std::span<std::uint32_t const> const hubs_b, std::span<std::uint32_t const> const dist_b)
+			noexcept -> std::tuple<std::uint32_t, std::size_t, std::size_t>
+		{
+			std::tuple<std::uint32_t, std::size_t, std::size_t> best{std::numeric_limits<std::uint32_t>::max(), 0, 0};
+			for (std::size_t i = 0, j = 0; i < hubs_a.size() && j < hubs_b.size();) {
+				if (hubs_a[i] < hubs_b[j]) {
+					++i;
+				} else if (hubs_b[j] < hubs_a[i]) {
+					++j;
+				} else {
+					if (std::uint32_t const sum = dist_a[i] + dist_b[j]; sum < std::get<0>(best)) {
+						best = {sum, i, j};
+					}
+					++i;
+					++j;
+				}
+			}
+			return best;
+		}
+	}
+
+	/**
+	 * @brief 剪枝地标标注
+	 *
+	 * 对第 r 个枢纽 h：正向剪枝 Dijkstra 求 h 到各顶点的距离，写入到达标签，剪枝查询为 L_out(h) ⋈ L_in(u)；
+	 * 有向图再沿入边做一次反向搜索，写入离开标签，剪枝查询为 L_out(u) ⋈ L_in(h)。
+	 * 剪枝查询时先把 h 一侧的标签展开到按枢纽序号下标的数组 root，每次查询只需扫描 u 一侧的标签。
+	 */
+	template <typename V, typename W>
+	inline auto HubLabelIndex<V, W>::build(Graph const& graph, std::span<VertexId const> order) -> HubLabelIndex
+	{
+		constexpr Distance infinity = std::numeric_limits<Distance>::max();
+		constexpr VertexId invalid = Traits::invalid_vertex;
+		int const n = graph.vertexCount();
+
+		HubLabelIndex index;
+		index.m_vertices = n;
+		index.m_directed = !graph.symmetric();
+		index.m_fingerprint = landmark::fingerprint(graph);
+		if (order.size() == static_cast<std::size_t>(n)) {
+			index.m_order.assign(order.begin(), order.end());
+		} else {
+			std::vector<int> degree(n, 0);
+			for (int u = 0; u < n; ++u) {
+				graph.forEachNeighbor(static_cast<VertexId>(u), [&](VertexId const v, W)
+				{
+					++degree[u];
+					++degree[v];
+				});
+			}
+			index.m_order.resize(n);
+			std::iota(index.m_order.begin(), index.m_order.end(), VertexId{0});
+			std::ranges::stable_sort(index.m_order, std::greater<>{}, [&](VertexId const v) { return degree[v]; });
+		}
+
+		struct Entry {
+		    std::uint32_t hub;
+		    std::uint32_t distance;
+		    VertexId parent;
+		};
+		std::array<std::vector<std::vector<Entry>>, 2> labels;
+		labels[0].resize(n);
+		if (index.m_directed) {
+			labels[1].resize(n);
+		}
+		auto& out_labels = labels[0];
+		auto& in_labels = index.m_directed ? labels[1] : labels[0];
+
+		std::vector<Distance> dist(n, infinity);
+		std::vector<VertexId> parent(n, invalid);
+		std::vector<VertexId> touched;
+		std::vector<std::uint32_t> root(n, unreachable);
+		IndexedHeap<Distance> heap(n);
+
+		// 从 source 做剪枝搜索，结果写入 target_labels；root_label 为 source 一侧用于剪枝的标签
+		auto const pruned_search = [&](std::uint32_t const rank, VertexId const source, bool const reverse,
+		                               std::vector<Entry> const& root_label,
+		                               std::vector<std::vector<Entry>>& target_labels)
+		{
+			for (Entry const& entry : root_label) {
+				root[entry.hub] = entry.distance;
+			}
+			dist[source] = 0;
+			touched.push_back(source);
+			heap.pushOrDecrease(static_cast<std::uint32_t>(source), 0);
+			while (!heap.empty()) {
+				auto const [d, index_u] = heap.pop();
+				auto const u = static_cast<VertexId>(index_u);
+				auto& target = target_labels[u];
+				if (std::ranges::any_of(target, [&](Entry const& entry)
+				{
+					return root[entry.hub] != unreachable
+						&& std::uint64_t{root[entry.hub]} + entry.distance <= static_cast<std::uint64_t>(d);
+				})) {
+					continue;
+				}
+				if (d >= static_cast<Distance>(max_distance)) {
+					throw std::length_error("枢纽标签距离超出范围");
+				}
+				target.push_back({rank, static_cast<std::uint32_t>(d), parent[u]});
+
+				auto const relax = [&](VertexId const v, W const weight)
+				{
+					if (Distance const candidate = d + weight; candidate < dist[v]) {
+						if (dist[v] == infinity) {
+							touched.push_back(v);
+						}
+						dist[v] = candidate;
+						parent[v] = u;
+						heap.pushOrDecrease(static_cast<std::uint32_t>(v), candidate);
+					}
+				};
+				if (reverse) {
+					graph.forEachInNeighbor(u, relax);
+				} else {
+					graph.forEachNeighbor(u, relax);
+				}
+			}
+			for (VertexId const v : touched) {
+				dist[v] = infinity;
+				parent[v] = invalid;
+			}
+			touched.clear();
+			for (Entry const& entry : root_label) {
+				root[entry.hub] = unreachable;
+			}
+		};
+
+		for (int r = 0; r < n; ++r) {
+			VertexId const h = index.m_order[r];
+			auto const rank = static_cast<std::uint32_t>(r);
+			pruned_search(rank, h, false, out_labels[h], in_labels);
+			if (index.m_directed) {
+				pruned_search(rank, h, true, in_labels[h], out_labels);
+			}
+		}
+
+		for (int side = 0; side < (index.m_directed ? 2 : 1); ++side) {
+			Labels& flat = index.m_labels[side];
+			flat.offsets.assign(static_cast<std::size_t>(n) + 1, 0);
+			for (int v = 0; v < n; ++v) {
+				flat.offsets[v + 1] = flat.offsets[v] + labels[side][v].size();
+			}
+			flat.hubs.reserve(flat.offsets[n]);
+			flat.distances.reserve(flat.offsets[n]);
+			flat.parents.reserve(flat.offsets[n]);
+			for (auto& list : labels[side]) {
+				for (Entry const& entry : list) {
+					flat.hubs.push_back(entry.hub);
+					flat.distances.push_back(entry.distance);
+					flat.parents.push_back(entry.parent);
+				}
+				std::vector<Entry>().swap(list);
+			}
+		}
+		return index;
+	}
+
+	template <typename V, typename W>
+	inline auto HubLabelIndex<V, W>::distance(VertexId const start, VertexId const end) const noexcept -> Distance
+	{
+		if (start == end) {
+			return 0;
+		}
+		Label const from = outLabel(start), to = inLabel(end);
+		std::uint32_t const best = hub_label::min_sum(from.hubs, from.distances, to.hubs, to.distances);
+		return best == unreachable ? -1 : static_cast<Distance>(best);
+	}
+
+	/**
+	 * @brief 沿 start 的离开标签逐跳走到枢纽，再从 end 的到达标签逐跳倒推回枢纽。
+	 *
+	 * 剪枝搜索中被扩展的顶点都加入了标签，因此路径上每个顶点的标签里都有同一枢纽，按序号二分查找即可。
+	 */
+	template <typename V, typename W>
+	inline auto HubLabelIndex<V, W>::query(VertexId const start, VertexId const end) const -> PathResult
+	{
+		if (start == end) {
+			return {{start}, 0};
+		}
+		Label const from = outLabel(start), to = inLabel(end);
+		auto const [best, i, j] = hub_label::arg_min_sum(from.hubs, from.distances, to.hubs, to.distances);
+		if (best == unreachable) {
+			return {{}, -1};
+		}
+		std::uint32_t const hub = from.hubs[i];
+		auto const next = [](Label const& label, std::size_t const position)
+		{
+			return position < label.hubs.size() ? label.parents[position] : Traits::invalid_vertex;
+		};
+		auto const find = [hub](Label const& label)
+		{
+			return static_cast<std::size_t>(std::ranges::lower_bound(label.hubs, hub) - label.hubs.begin());
+		};
+
+		Path path{start};
+		for (VertexId v = next(from, i); v != Traits::invalid_vertex; v = next(outLabel(v), find(outLabel(v)))) {
+			path.push_back(v);
+		}
+		Path tail;
+		for (VertexId v = end; v != Traits::invalid_vertex; v = next(inLabel(v), find(inLabel(v)))) {
+			tail.push_back(v);
+		}
+		// tail 的末项为枢纽自身，已在 path 中
+		path.insert(path.end(), tail.rbegin() + 1, tail.rend());
+		return {path, static_cast<Distance>(best)};
+	}
+}
+
+#endif
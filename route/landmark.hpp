@@ -0,0 +1,492 @@
+﻿// Purpose: ALT（A* + 地标 + 三角不等式）的预处理与查询
+// Author:  Cmixed
+#pragma once
+
+#ifndef LANDMARK_HPP
+#define LANDMARK_HPP
+
+#include "pch.hpp"
+#include "data.hpp"
+#include "heap.hpp"
+
+namespace route
+{
+	/*****************************************************************
+	 *
+	 *		LandmarkIndex 类
+	 *
+	 *****************************************************************/
+
+	/**
+	 * @brief 地标的选取方式。
+	 */
+	enum class LandmarkSelection : std::uint_fast8_t
+	{
+		Farthest = 0, ///< 最远点：每次选取距已选地标最远的顶点，需要依次执行 Dijkstra
+		Planar, ///< 平面划分：按顶点坐标绕中心等分扇区，每个扇区取离中心最远的顶点
+	};
+
+	/**
+	 * @brief ALT 预处理结果：若干地标及每个顶点到地标、地标到每个顶点的距离
+	 *
+	 * 距离按顶点主序存放为 32 位无符号整数：第 v 行依次为 d(L_i, v)，有向图再跟 d(v, L_i)，
+	 * 查询时一个顶点的全部地标距离位于同一缓存行内。无向图两组距离相同，只存一组。
+	 * 由三角不等式，d(v, t) ≥ max(d(L, t) − d(L, v), d(v, L) − d(t, L))，取各地标的最大值作为 A* 的势函数，
+	 * 它是一致的，因此每个顶点至多出队一次，结果与 dijkstra 相同。
+	 * 预处理与图一一对应：图被修改后需要重新构建，matches 通过边的散列检查两者是否一致。
+	 *
+	 * @tparam V 顶点编号类型
+	 * @tparam W 边权重类型
+	 */
+	template <typename V, typename W>
+	class LandmarkIndex
+	{
+	public:
+		using Graph = WeightedAdjMatrixGraph<V, W>;
+		using VertexId = V;
+		using Distance = typename Graph::Distance;
+		using Path = typename Graph::Path;
+		using PathResult = typename Graph::PathResult;
+
+		static constexpr std::uint32_t unreachable = std::numeric_limits<std::uint32_t>::max(); ///< 不可达
+		static constexpr int max_landmarks = 64; ///< 地标数上限
+		static constexpr int max_active = 4; ///< 每次查询实际使用的地标数
+
+		LandmarkIndex() = default;
+
+		/**
+		 * @brief 为 graph 选取地标并计算距离。
+		 * @param graph 图，需已 finalize
+		 * @param count 地标数，不超过顶点数与 max_landmarks
+		 * @param selection 选取方式；Planar 在顶点缺少坐标时退化为 Farthest
+		 * @param threads 计算距离的线程数，0 表示使用全部硬件线程
+		 * @throw std::length_error 如果某个距离超出 32 位无符号整数的范围
+		 */
+		[[nodiscard]] static auto build(Graph const& graph, int count = 8,
+		                                LandmarkSelection selection = LandmarkSelection::Farthest,
+		                                unsigned threads = 0) -> LandmarkIndex;
+
+		[[nodiscard]] bool empty() const noexcept { return m_count == 0; }
+		[[nodiscard]] int landmarkCount() const noexcept { return m_count; }
+		[[nodiscard]] int vertexCount() const noexcept { return m_vertices; }
+		[[nodiscard]] std::span<VertexId const> landmarks() const noexcept { return {m_landmarks.data(), m_landmarks.size()}; }
+
+		/**
+		 * @brief 判断预处理是否对应 graph：顶点数、方向性与边的散列均一致。复杂度 O(V + E)。
+		 */
+		[[nodiscard]] bool matches(Graph const& graph) const;
+
+		/**
+		 * @brief 使用全部地标计算 d(v, t) 的下界，t 不可由 v 到达时返回 -1。
+		 */
+		[[nodiscard]] Distance lowerBound(VertexId v, VertexId t) const;
+
+		/**
+		 * @brief ALT 查询：以地标下界为势函数的 A* 搜索。
+		 *
+		 * 每次查询从全部地标中选出在起点处下界最大的 max_active 个参与计算。
+		 * 预处理为空或顶点数与图不符时退化为 dijkstra，并在 stats 中标记。
+		 * @return 最短路径和距离，不可达时距离为 -1
+		 */
+		[[nodiscard]] auto query(Graph const& graph, VertexId start, VertexId end, SearchStats* stats = nullptr) const
+			-> PathResult;
+
+	private:
+		/// 每行的列数
+		[[nodiscard]] std::size_t columns() const noexcept
+		{
+			return static_cast<std::size_t>(m_count) * (m_directed ? 2 : 1);
+		}
+
+		/// d(L_i, v)
+		[[nodiscard]] std::uint32_t fromLandmark(VertexId const v, int const i) const noexcept
+		{
+			return m_distances[static_cast<std::size_t>(v) * columns() + i];
+		}
+
+		/// d(v, L_i)
+		[[nodiscard]] std::uint32_t toLandmark(VertexId const v, int const i) const noexcept
+		{
+			return m_distances[static_cast<std::size_t>(v) * columns() + (m_directed ? m_count + i : i)];
+		}
+
+		template <std::size_t N>
+		[[nodiscard]] Distance potential(VertexId v, VertexId t, std::array<int, N> const& active, int count) const;
+
+		int m_vertices{0}; ///< 顶点数
+		int m_count{0}; ///< 地标数
+		bool m_directed{false}; ///< 是否分别存储到达与离开地标的距离
+		std::uint64_t m_fingerprint{0}; ///< 构建时图的边散列
+		ArrayStore<V> m_landmarks{}; ///< 地标顶点
+		ArrayStore<std::uint32_t> m_distances{}; ///< 顶点主序的距离表
+
+		template <typename V2, typename W2>
+		friend bool save_landmarks(LandmarkIndex<V2, W2> const& index, const std::string& filename);
+		template <typename V2, typename W2>
+		friend std::optional<LandmarkIndex<V2, W2>> load_landmarks(WeightedAdjMatrixGraph<V2, W2> const& graph,
+		                                                           const std::string& filename);
+	};
+
+	using WLandmarkIndex = LandmarkIndex<WGraph::VertexId, WGraph::Weight>;
+
+	namespace landmark
+	{
+		/**
+		 * @brief 图的边散列（FNV-1a 64），覆盖顶点数与按顶点顺序遍历的全部 (u, v, weight)。
+		 */
+		template <typename V, typename W>
+		inline std::uint64_t fingerprint(WeightedAdjMatrixGraph<V, W> const& graph)
+		{
+			std::uint64_t hash = 0xcbf29ce484222325ULL;
+			auto const mix = [&hash](std::uint64_t value)
+			{
+				for (int i = 0; i < 8; ++i, value >>= 8) {
+					hash ^= value & 0xff;
+					hash *= 0x100000001b3ULL;
+				}
+			};
+			mix(static_cast<std::uint64_t>(graph.vertexCount()));
+			mix(graph.symmetric() ? 0 : 1);
+			for (int u = 0; u < graph.vertexCount(); ++u) {
+				graph.forEachNeighbor(static_cast<V>(u), [&](V const v, W const weight)
+				{
+					mix(static_cast<std::uint64_t>(u));
+					mix(static_cast<std::uint64_t>(v));
+					mix(static_cast<std::uint64_t>(weight));
+				});
+			}
+			return hash;
+		}
+
+		/**
+		 * @brief 从 source 出发的单源最短距离，reverse 为 true 时沿入边搜索（即到 source 的距离）。
+		 * @param dist 输出，不可达的顶点为 std::numeric_limits<Distance>::max()
+		 */
+		template <typename V, typename W, typename Distance>
+		inline void single_source(WeightedAdjMatrixGraph<V, W> const& graph, V const source, bool const reverse,
+		                          std::vector<Distance>& dist)
+		{
+			constexpr Distance infinity = std::numeric_limits<Distance>::max();
+			dist.assign(static_cast<std::size_t>(graph.vertexCount()), infinity);
+			IndexedHeap<Distance> heap(dist.size());
+
+			dist[source] = 0;
+			heap.pushOrDecrease(static_cast<std::uint32_t>(source), 0);
+			while (!heap.empty()) {
+				auto const [d, u] = heap.pop();
+				auto const relax = [&](V const v, W const weight)
+				{
+					if (Distance const candidate = d + weight; candidate < dist[v]) {
+						dist[v] = candidate;
+						heap.pushOrDecrease(static_cast<std::uint32_t>(v), candidate);
+					}
+				};
+				if (reverse) {
+					graph.forEachInNeighbor(static_cast<V>(u), relax);
+				} else {
+					graph.forEachNeighbor(static_cast<V>(u), relax);
+				}
+			}
+		}
+
+		/**
+		 * @brief 平面划分选取：以坐标均值为中心将平面等分为 count 个扇区，每个扇区取离中心最远的顶点。
+		 * @return 地标，空扇区不产生地标；任一带边顶点缺少坐标时返回空
+		 */
+		template <typename V, typename W>
+		inline auto select_planar(WeightedAdjMatrixGraph<V, W> const& graph, int const count) -> std::vector<V>
+		{
+			VertexTable const& table = graph.vertices();
+			int const n = graph.vertexCount();
+			double cx = 0.0, cy = 0.0;
+			int located = 0;
+			for (int v = 0; v < n; ++v) {
+				if (table.contains(v)) {
+					cx += table.x(v);
+					cy += table.y(v);
+					++located;
+				}
+			}
+			if (located == 0) {
+				return {};
+			}
+			cx /= located;
+			cy /= located;
+
+			constexpr double two_pi = 6.283185307179586;
+			std::vector<std::pair<double, int>> farthest(count, {-1.0, -1});
+			for (int v = 0; v < n; ++v) {
+				if (!table.contains(v)) {
+					bool has_edge = false;
+					graph.forEachNeighbor(static_cast<V>(v), [&](V, W) { has_edge = true; });
+					if (has_edge) {
+						return {};
+					}
+					continue;
+				}
+				double const dx = table.x(v) - cx, dy = table.y(v) - cy;
+				double const angle = std::atan2(dy, dx) + two_pi / 2;
+				int const sector = std::min(count - 1, static_cast<int>(angle / two_pi * count));
+				if (double const radius = dx * dx + dy * dy; radius > farthest[sector].first) {
+					farthest[sector] = {radius, v};
+				}
+			}
+
+			std::vector<V> result;
+			for (auto const& [radius, v] : farthest) {
+				if (v >= 0) {
+					result.push_back(static_cast<V>(v));
+				}
+			}
+			return result;
+		}
+	}
+
+	/**
+	 * @brief 选取地标并计算距离表
+	 *
+	 * 最远点选取中每个地标依赖此前地标的距离，只能依次执行正向 Dijkstra，结果直接写入距离表；
+	 * 其余的搜索（平面划分的正向搜索、有向图的反向搜索）彼此独立，按 threads 分批并行执行，
+	 * 每个搜索只写距离表中自己的一列。
+	 */
+	template <typename V, typename W>
+	inline auto LandmarkIndex<V, W>::build(Graph const& graph, int count, LandmarkSelection const selection,
+	                                       unsigned threads) -> LandmarkIndex
+	{
+		constexpr Distance infinity = std::numeric_limits<Distance>::max();
+		int const n = graph.vertexCount();
+
+		LandmarkIndex index;
+		index.m_vertices = n;
+		index.m_directed = !graph.symmetric();
+		index.m_fingerprint = landmark::fingerprint(graph);
+		count = std::clamp(count, 0, std::min(n, max_landmarks));
+		if (count == 0) {
+			return index;
+		}
+
+		std::vector<V> chosen;
+		if (selection == LandmarkSelection::Planar) {
+			chosen = landmark::select_planar(graph, count);
+		}
+		bool const farthest = chosen.empty();
+		if (farthest) {
+			chosen.reserve(count);
+		}
+		int const stride = static_cast<int>(chosen.empty() ? count : chosen.size()) * (index.m_directed ? 2 : 1);
+
+		std::vector<std::uint32_t> distances(static_cast<std::size_t>(n) * stride, unreachable);
+		auto const store = [&](int const column, std::vector<Distance> const& dist)
+		{
+			for (int v = 0; v < n; ++v) {
+				if (dist[v] == infinity) {
+					continue;
+				}
+				if (dist[v] >= static_cast<Distance>(unreachable)) {
+					throw std::length_error("地标距离超出 32 位无符号整数的范围");
+				}
+				distances[static_cast<std::size_t>(v) * stride + column] = static_cast<std::uint32_t>(dist[v]);
+			}
+		};
+
+		std::vector<Distance> dist;
+		if (farthest) {
+			// 第一个地标取离顶点 0 最远的可达顶点，之后每次取到已选地标最小距离最大的顶点，
+			// 尚未被任何地标到达的顶点视为无穷远，从而优先覆盖其他连通分量
+			landmark::single_source(graph, V{0}, false, dist);
+			int first = 0;
+			for (int v = 0; v < n; ++v) {
+				if (dist[v] != infinity && dist[v] > dist[first]) {
+					first = v;
+				}
+			}
+			std::vector<Distance> nearest(n, infinity);
+			std::vector<char> taken(n, 0);
+			for (int next = first; static_cast<int>(chosen.size()) < count; ) {
+				chosen.push_back(static_cast<V>(next));
+				taken[next] = 1;
+				landmark::single_source(graph, static_cast<V>(next), false, dist);
+				store(static_cast<int>(chosen.size()) - 1, dist);
+
+				next = -1;
+				for (int v = 0; v < n; ++v) {
+					nearest[v] = std::min(nearest[v], dist[v]);
+					if (!taken[v] && (next < 0 || nearest[v] > nearest[next])) {
+						next = v;
+					}
+				}
+			}
+		}
+		index.m_count = static_cast<int>(chosen.size());
+
+		// 剩余的独立搜索：{列, 地标, 是否反向}
+		std::vector<std::tuple<int, V, bool>> tasks;
+		for (int i = 0; i < index.m_count; ++i) {
+			if (!farthest) {
+				tasks.emplace_back(i, chosen[i], false);
+			}
+			if (index.m_directed) {
+				tasks.emplace_back(index.m_count + i, chosen[i], true);
+			}
+		}
+
+		if (threads == 0) {
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		for (std::size_t wave = 0; wave < tasks.size(); wave += threads) {
+			std::size_t const last = std::min(tasks.size(), wave + threads);
+			std::vector<std::future<void>> futures;
+			futures.reserve(last - wave);
+			for (std::size_t k = wave; k < last; ++k) {
+				futures.emplace_back(std::async(std::launch::async, [&, k]()
+				{
+					auto const [column, source, reverse] = tasks[k];
+					std::vector<Distance> local;
+					landmark::single_source(graph, source, reverse, local);
+					store(column, local);
+				}));
+			}
+			for (auto& future : futures) {
+				future.get();
+			}
+		}
+
+		index.m_landmarks.assign(std::move(chosen));
+		index.m_distances.assign(std::move(distances));
+		return index;
+	}
+
+	template <typename V, typename W>
+	inline bool LandmarkIndex<V, W>::matches(Graph const& graph) const
+	{
+		return m_vertices == graph.vertexCount() && m_directed == !graph.symmetric()
+			&& m_fingerprint == landmark::fingerprint(graph);
+	}
+
+	/**
+	 * @brief 取 active 中前 count 个地标计算 v 到 t 的下界，t 不可由 v 到达时返回 infinity。
+	 *
+	 * d(L, v) 有限而 d(L, t) 无穷说明 t 不可由 v 到达；d(t, L) 有限而 d(v, L) 无穷同理。
+	 * 两者都无穷的地标不提供信息，直接跳过。
+	 */
+	template <typename V, typename W>
+	template <std::size_t N>
+	inline auto LandmarkIndex<V, W>::potential(VertexId const v, VertexId const t, std::array<int, N> const& active,
+	                                           int const count) const -> Distance
+	{
+		constexpr Distance infinity = std::numeric_limits<Distance>::max();
+		std::int64_t best = 0;
+		for (int k = 0; k < count; ++k) {
+			int const i = active[k];
+			if (std::uint32_t const from_v = fromLandmark(v, i); from_v != unreachable) {
+				std::uint32_t const from_t = fromLandmark(t, i);
+				if (from_t == unreachable) {
+					return infinity;
+				}
+				best = std::max(best, static_cast<std::int64_t>(from_t) - from_v);
+			}
+			if (std::uint32_t const to_t = toLandmark(t, i); to_t != unreachable) {
+				std::uint32_t const to_v = toLandmark(v, i);
+				if (to_v == unreachable) {
+					return infinity;
+				}
+				best = std::max(best, static_cast<std::int64_t>(to_v) - to_t);
+			}
+		}
+		return static_cast<Distance>(best);
+	}
+
+	template <typename V, typename W>
+	inline auto LandmarkIndex<V, W>::lowerBound(VertexId const v, VertexId const t) const -> Distance
+	{
+		std::array<int, max_landmarks> all{};
+		std::iota(all.begin(), all.end(), 0);
+		Distance const bound = potential(v, t, all, m_count);
+		return bound == std::numeric_limits<Distance>::max() ? Distance{-1} : bound;
+	}
+
+	template <typename V, typename W>
+	inline auto LandmarkIndex<V, W>::query(Graph const& graph, VertexId const start, VertexId const end,
+	                                       SearchStats* const stats) const -> PathResult
+	{
+		using Traits = typename Graph::Traits;
+		if (!graph.hasVertex(start) || !graph.hasVertex(end)) {
+			return {{}, -1};
+		}
+		if (empty() || m_vertices != graph.vertexCount()) {
+			if (stats != nullptr) {
+				stats->fallback = true;
+			}
+			return graph.dijkstra(start, end, stats);
+		}
+
+		// 选出在起点处下界最大的地标
+		std::array<std::pair<Distance, int>, max_landmarks> ranked{};
+		for (int i = 0; i < m_count; ++i) {
+			std::array<int, 1> const single{i};
+			ranked[i] = {potential(start, end, single, 1), i};
+		}
+		int const active_count = std::min(m_count, max_active);
+		std::partial_sort(ranked.begin(), ranked.begin() + active_count, ranked.begin() + m_count,
+		                  [](auto const& a, auto const& b) { return a.first > b.first; });
+		std::array<int, max_active> active{};
+		for (int k = 0; k < active_count; ++k) {
+			active[k] = ranked[k].second;
+		}
+
+		using Workspace = SearchWorkspace<Distance, VertexId>;
+		constexpr Distance infinity = Workspace::infinity;
+		if (potential(start, end, active, active_count) == infinity) {
+			return {{}, -1};
+		}
+
+		auto& ws = thread_workspace<Workspace>();
+		auto const lease = ws.lease(m_vertices, Traits::invalid_vertex);
+
+		SearchStats local{};
+		SearchStats& counters = stats != nullptr ? *stats : local;
+
+		// 键值为 g + h，出队时 h 由键值与 dist 相减得到，无需另存
+		ws.set(start, 0, Traits::invalid_vertex);
+		ws.heap.pushOrDecrease(start, potential(start, end, active, active_count));
+		++counters.queue_operations;
+
+		while (!ws.heap.empty()) {
+			auto const index = ws.heap.pop().index;
+			auto const u = static_cast<VertexId>(index);
+			++counters.queue_operations;
+			++counters.settled;
+			if (u == end) {
+				break;
+			}
+
+			Distance const d = ws.dist[u];
+			graph.forEachNeighbor(u, [&](VertexId const v, W const weight)
+			{
+				if (Distance const candidate = d + weight; candidate < ws.dist[v]) {
+					Distance const h = potential(v, end, active, active_count);
+					if (h == infinity) {
+						return;
+					}
+					ws.set(v, candidate, u);
+					ws.heap.pushOrDecrease(v, candidate + h);
+					++counters.queue_operations;
+					++counters.relaxed;
+				}
+			});
+		}
+
+		if (ws.dist[end] == infinity) {
+			return {{}, -1};
+		}
+
+		Path path;
+		for (VertexId at = end; at != Traits::invalid_vertex; at = ws.prev[at]) {
+			path.push_back(at);
+		}
+		std::ranges::reverse(path);
+		return {path, ws.dist[end]};
+	}
+}
+
+#endif
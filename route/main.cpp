@@ -10,13 +10,11 @@ using namespace std::literals;
 using namespace zzj;
 using namespace zzj::literals;
 
-constexpr int city_num = 20;
-
 int main()
 {
     color_ctrl.default_color = ColorName::WHITE;
 
-    auto graph = WGraph(city_num);
+    auto graph = WGraph(0);
     auto menu = Menu("User");
 
     menu.statusBarFr();
@@ -26,11 +24,44 @@ int main()
     menu.waitEnter();
 
 
-    if (auto res = menu.readFile(graph, "graph.txt");
+    // 快照与 graph.txt 一致时直接映射，否则解析文本并重新生成快照
+    if (auto snap = load_snapshot<WGraph::VertexId, WGraph::Weight>("graph.snap", false, "graph.txt");
+        snap.has_value()) {
+        graph = std::move(*snap);
+        menu.printMsg(MessageType::SUCCESS, "快照读入成功。");
+    } else if (auto res = menu.readFile(graph, "graph.txt");
         res.has_value()) {
         menu.printMsg(MessageType::SUCCESS, "文件读入成功。");
+        if (save_snapshot(graph, "graph.snap", "graph.txt")) {
+            menu.printMsg(MessageType::SUCCESS, "快照写入成功。");
+        }
     } else {
         menu.printMsg(MessageType::ERROR, "文件读入失败！");
+        return 1;
+    }
+    int const city_num = graph.vertexCount();
+
+    // 地标预处理与图文件放在一起，图未改变时直接加载
+    auto landmarks = load_landmarks(graph, "graph.txt.alt");
+    if (!landmarks.has_value()) {
+        landmarks = WLandmarkIndex::build(graph);
+        if (save_landmarks(*landmarks, "graph.txt.alt")) {
+            menu.printMsg(MessageType::SUCCESS, "地标预处理完成。");
+        }
+    }
+    if (auto hierarchy = load_contraction_hierarchy(graph, "graph.txt.ch");
+        !hierarchy.has_value() || !graph.useContractionHierarchy(std::move(*hierarchy))) {
+        graph.prepareContractionHierarchy();
+        if (save_contraction_hierarchy(*graph.contractionHierarchy(), "graph.txt.ch")) {
+            menu.printMsg(MessageType::SUCCESS, "收缩层次预处理完成。");
+        }
+    }
+    if (auto labels = load_hub_labels(graph, "graph.txt.hl");
+        !labels.has_value() || !graph.useHubLabels(std::move(*labels))) {
+        graph.prepareHubLabels();
+        if (save_hub_labels(*graph.hubLabels(), "graph.txt.hl")) {
+            menu.printMsg(MessageType::SUCCESS, "枢纽标签预处理完成。");
+        }
     }
 
     {
@@ -57,7 +88,14 @@ int main()
     }
 
     {
-	    if (auto res = menu.writeFile(graph, "graph.txt");
+	    menu.printMsg(MsgTy::MESSAGE, "ALT 查询");
+	    auto const [path, distance] = landmarks->query(graph, 0, city_num - 1);
+	    graph.printPath(path, distance);
+    }
+
+    {
+	    // 写入单独的文件，不覆盖输入文件
+	    if (auto res = menu.writeFile(graph, "graph_output.txt");
 	        res.has_value()) {
 	        menu.printMsg(MessageType::SUCCESS, "文件写入成功。");
 	    } else {
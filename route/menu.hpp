@@ -31,7 +31,8 @@ namespace route
 
 	/* 使用路径计算函数 */
 	auto sum_path(route::WGraph const& graph, PathEndPoints const pep) -> std::vector<PathTimePair>;
-	auto calculate_path_times(route::WGraph const& graph, PathEndPoints const pep)
+	auto calculate_path_times(route::WGraph const& graph, PathEndPoints const pep,
+	                          WShortestPathTree const* tree = nullptr, std::chrono::nanoseconds tree_time = {})
 		-> std::vector<PathTimePair>;
 
 	inline std::array<std::string, option_num> menu_option{
@@ -236,9 +237,11 @@ namespace route
 	-> std::optional<int>
 	{
 		statFlag.is_readFile = false;
-		if (read_from_file(graph, file_name)) {
+		// 图的规模由文件内容决定，读入后替换原有的图
+		if (auto loaded = load_graph<WGraph::VertexId, WGraph::Weight>(file_name, graph.storage())) {
+			graph = std::move(loaded->graph);
 			statFlag.is_readFile = true;
-			return 1;
+			return graph.vertexCount();
 		} else {
 			std::cerr << "文件读入失败!" << "\n";
 			return{};
@@ -312,6 +315,12 @@ namespace route
 			case Algorithm::GeneticLocalSearch:
 				algorithm_name = "遗传局部搜索";
 				break;
+			case Algorithm::ContractionHierarchies:
+				algorithm_name = "收缩层次";
+				break;
+			case Algorithm::HubLabels:
+				algorithm_name = "枢纽标签";
+				break;
 			}
 
 			std::println("\n===== {}: =====", algorithm_name);
@@ -347,6 +356,10 @@ namespace route
 		measure_time([&](auto start, auto end) { return graph.dijkstra(start, end); }, pep.startVertex, pep.endVertex);
 		measure_time([&](auto start, auto end) { return graph.geneticLocalSearchOptimization(start, end); },
 		             pep.startVertex, pep.endVertex);
+		measure_time([&](auto start, auto end) { return graph.contractionHierarchyQuery(start, end); },
+		             pep.startVertex, pep.endVertex);
+		measure_time([&](auto start, auto end) { return graph.hubLabelQuery(start, end); }, pep.startVertex,
+		             pep.endVertex);
 
 		return results;
 	}
@@ -359,25 +372,43 @@ namespace route
 	 * 
 	 * @param graph 路径图结构
 	 * @param pep 路径端点信息
+	 * @param tree 以 pep.startVertex 为起点的最短路径树；给出时 Dijkstra 一项直接从树中读取，
+	 *             执行时间为读取时间加上 tree_time
+	 * @param tree_time 分摊到本次查询的建树时间
 	 * @return 包含路径和执行时间的结构体集合
 	 */
-	inline auto calculate_path_times(route::WGraph const& graph, PathEndPoints const pep)
+	inline auto calculate_path_times(route::WGraph const& graph, PathEndPoints const pep,
+	                                 WShortestPathTree const* const tree,
+	                                 std::chrono::nanoseconds const tree_time)
 		-> std::vector<PathTimePair>
 	{
 		// 使用 std::function 统一算法的调用方式
-		using AlgorithmFunc = std::function<std::pair<std::vector<int>, int>(route::WGraph const&, int, int)>;
+		using AlgorithmFunc = std::function<WGraph::PathResult(route::WGraph const&, int, int)>;
 
 		// 算法名称与对应函数的映射
-		std::array<std::pair<const char*, AlgorithmFunc>, 4> algorithm_map = {
+		std::array<std::pair<const char*, AlgorithmFunc>, algo_num> algorithm_map = {
 			std::make_pair("Local Search", [](auto& g, auto s, auto e) { return g.localSearchOptimization(s, e); }),
 			std::make_pair("Genetic Algorithm", [](auto& g, auto s, auto e) { return g.geneticAlgorithm(s, e); }),
 			std::make_pair("Dijkstra", [](auto& g, auto s, auto e) { return g.dijkstra(s, e); }),
 			std::make_pair("Genetic+Local Search", [](auto& g, auto s, auto e)
 			{
 				return g.geneticLocalSearchOptimization(s, e, 50, 100);
-			})
+			}),
+			std::make_pair("Contraction Hierarchies", [](auto& g, auto s, auto e)
+			{
+				return g.contractionHierarchyQuery(s, e);
+			}),
+			std::make_pair("Hub Labels", [](auto& g, auto s, auto e) { return g.hubLabelQuery(s, e); })
 		};
 
+		// 已有最短路径树时 Dijkstra 一项改为从树中读取
+		if (tree != nullptr) {
+			algorithm_map[static_cast<std::size_t>(Algorithm::Dijkstra)].second = [tree](auto&, auto, auto e)
+			{
+				return tree->query(e);
+			};
+		}
+
 		// 性能测量辅助函数
 		auto measure_performance = [&](const char* name, const AlgorithmFunc& algorithm)
 		{
@@ -411,6 +442,10 @@ namespace route
 			results.emplace_back(future.get());
 		}
 
+		if (tree != nullptr) {
+			results[static_cast<std::size_t>(Algorithm::Dijkstra)].execution_time += tree_time;
+		}
+
 		return results;
 	}
 
@@ -418,6 +453,9 @@ namespace route
 	/**
 	 * @brief 异步计算多个路径的通行时间。
 	 *
+	 * 端点按起点分组，每组一个异步任务：先构建一次最短路径树，组内各端点的 Dijkstra 结果都从树中读取，
+	 * 建树时间平均分摊到组内各端点。结果顺序与 pep 相同。
+	 *
 	 * @param g 有向加权图。
 	 * @param pep 路径端点列表。
 	 * @return std::optional<std::vector<std::vector<PathTimePair>>> 包含路径通行时间的二维向量，
@@ -426,21 +464,48 @@ namespace route
 	inline auto paths_task(WGraph const& g, std::vector<PathEndPoints> const& pep)
 	    -> std::optional<std::vector<std::vector<PathTimePair>>>
 	{
-	    std::vector<std::future<std::vector<PathTimePair>>> f_pt;
-	    f_pt.reserve(pep.size() * (algo_num + 1));
+	    // 按起点分组，组内保存端点在 pep 中的下标
+	    std::vector<std::vector<std::size_t>> groups;
+	    std::unordered_map<int, std::size_t> group_of;
+	    for (std::size_t i = 0; i < pep.size(); ++i) {
+	        auto const [it, inserted] = group_of.try_emplace(pep[i].startVertex, groups.size());
+	        if (inserted) {
+	            groups.emplace_back();
+	        }
+	        groups[it->second].push_back(i);
+	    }
 
-	    for (const auto& endpoints : pep) {
-	        // 启动异步任务，计算每对端点的路径通行时间
-	        f_pt.emplace_back(std::async(std::launch::async,
-	        [g, endpoints]() { return route::calculate_path_times(g, endpoints); }));
+	    using GroupResult = std::vector<std::vector<PathTimePair>>;
+	    std::vector<std::future<GroupResult>> f_pt;
+	    f_pt.reserve(groups.size());
+
+	    for (const auto& group : groups) {
+	        // 启动异步任务，同一起点只搜索一次
+	        f_pt.emplace_back(std::async(std::launch::async, [&g, &pep, &group]()
+	        {
+	            auto const start = std::chrono::high_resolution_clock::now();
+	            WShortestPathTree const tree = g.shortestPathTree(pep[group.front()].startVertex);
+	            auto const tree_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+	                std::chrono::high_resolution_clock::now() - start) / static_cast<long long>(group.size());
+
+	            GroupResult results;
+	            results.reserve(group.size());
+	            for (std::size_t const i : group) {
+	                results.push_back(route::calculate_path_times(g, pep[i], &tree, tree_time));
+	            }
+	            return results;
+	        }));
 	    }
 
-	    std::vector<std::vector<PathTimePair>> path_results;
+	    std::vector<std::vector<PathTimePair>> path_results(pep.size());
 
-	    // 等待所有异步任务完成并收集结果
-	    for (auto& future : f_pt) {
+	    // 等待所有异步任务完成并按原顺序收集结果
+	    for (std::size_t k = 0; k < f_pt.size(); ++k) {
 	        try {
-	            path_results.push_back(future.get());
+	            auto group_results = f_pt[k].get();
+	            for (std::size_t j = 0; j < groups[k].size(); ++j) {
+	                path_results[groups[k][j]] = std::move(group_results[j]);
+	            }
 	        } catch (const std::exception& e) {
 	            // 如果某个异步任务抛出异常，记录错误并返回空值
 	            std::println(std::cerr, "异步任务出错:{}", e.what());
@@ -6,12 +6,22 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <charconv>
 #include <vector>
+#include <array>
+#include <span>
+#include <optional>
+#include <cstring>
+#include <cmath>
+#include <bit>
+#include <tuple>
 #include <utility>
 #include <algorithm>
 #include <queue>
 #include <limits>
 #include <ranges>
+#include <numeric>
 #include <functional>
 #include <print>
 #include <format>
@@ -20,6 +30,7 @@
 #include <stdexcept>
 #include <exception>
 #include <fstream>
+#include <filesystem>
 #include <istream>
 #include <sstream>
 #include <regex>
@@ -27,6 +38,7 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <barrier>
 #include <future>
 #include <type_traits>
 #include <chrono>
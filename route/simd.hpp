@@ -0,0 +1,96 @@
+﻿// Purpose: 运行期检测 CPU 指令集，向量化内核据此选择 AVX-512、AVX2 或标量版本
+// Author:  Cmixed
+#pragma once
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include "pch.hpp"
+
+/*
+ * 工程以默认指令集编译，AVX2 / AVX-512 内核单独标记为 ROUTE_TARGET_AVX2 / ROUTE_TARGET_AVX512，
+ * 调用前以 simd::has_avx2() / simd::has_avx512() 检查。
+ * MSVC 不需要 /arch 即可使用内在函数，标记为空；g++ / clang 以 target 属性只为该函数开启对应指令集。
+ */
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ROUTE_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define ROUTE_TARGET_AVX2
+#define ROUTE_TARGET_AVX512
+#else
+#define ROUTE_TARGET_AVX2 __attribute__((target("avx2")))
+#define ROUTE_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512vl")))
+#endif
+#else
+#define ROUTE_SIMD_X86 0
+#endif
+
+namespace route::simd
+{
+#if ROUTE_SIMD_X86 && defined(_MSC_VER) && !defined(__clang__)
+	/**
+	 * @brief CPUID 第 7 页的 EBX 中 features 各位都为 1，且操作系统保存 state 中的全部寄存器状态（XGETBV）。
+	 */
+	inline bool cpuid_supports(unsigned const features, unsigned long long const state) noexcept
+	{
+		int info[4]{};
+		__cpuid(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+		__cpuid(info, 1);
+		bool const osxsave = (info[2] & (1 << 27)) != 0;
+		if (!osxsave || (_xgetbv(0) & state) != state) {
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		return (static_cast<unsigned>(info[1]) & features) == features;
+	}
+#endif
+
+	/**
+	 * @brief 当前 CPU 与操作系统是否支持 AVX2。
+	 *
+	 * 以 AVX2 编译（/arch:AVX2、-mavx2）时为常量 true；否则首次调用时检测并缓存结果。
+	 * MSVC 下检查 CPUID 第 7 页的 AVX2 位，并以 XGETBV 确认操作系统保存 YMM 寄存器。
+	 */
+	inline bool has_avx2() noexcept
+	{
+#if defined(__AVX2__)
+		return true;
+#elif !ROUTE_SIMD_X86
+		return false;
+#elif defined(_MSC_VER) && !defined(__clang__)
+		static bool const supported = cpuid_supports(1u << 5, 0x6);
+		return supported;
+#else
+		static bool const supported = __builtin_cpu_supports("avx2");
+		return supported;
+#endif
+	}
+
+	/**
+	 * @brief 当前 CPU 与操作系统是否支持 AVX-512 F 与 VL（同时要求 AVX2）。
+	 *
+	 * MSVC 下另需 XGETBV 确认操作系统保存 ZMM 与掩码寄存器。
+	 */
+	inline bool has_avx512() noexcept
+	{
+#if defined(__AVX512F__) && defined(__AVX512VL__) && defined(__AVX2__)
+		return true;
+#elif !ROUTE_SIMD_X86
+		return false;
+#elif defined(_MSC_VER) && !defined(__clang__)
+		static bool const supported = cpuid_supports(1u << 5 | 1u << 16 | 1u << 31, 0xe6);
+		return supported;
+#else
+		static bool const supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("avx512f")
+			&& __builtin_cpu_supports("avx512vl");
+		return supported;
+#endif
+	}
+}
+
+#endif